@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# compares the vm on arithmetic heavy code with the slots backend and the jit,
+# then times the tokenizer on a generated source
+
+set -e
+
+echo "Building..."
+./build.sh > /dev/null
+
+cd src
+flags="-O2 -DNDEBUG -DSHABBY_LIBRARY -DSHABBY_RELEASE -I include -Wall -Wextra -Werror -Wpedantic"
+gcc bench/vm_bench.c vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c $flags -o "../bin/vm_bench"
+gcc bench/vm_bench.c vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c $flags -DVM_BENCH_JIT -o "../bin/vm_bench_jit"
+tokenizer_files="bench/tokenizer_bench.c tokenizer.c utils/symbols.c utils/file.c utils/trace.c utils/tokens.c utils/intern.c"
+gcc $tokenizer_files $flags -o "../bin/tokenizer_bench"
+echo "  Done."
+echo ""
+
+cd ../bin
+./shabbyc --backend=slots --out=compilation --emit=bin ../tests/bench/arithmetic.src > /dev/null
+mv compilation/arithmetic.bin compilation/arithmetic_slots.bin
+./shabbyc --out=compilation --emit=bin ../tests/bench/arithmetic.src > /dev/null
+./vm_bench compilation/arithmetic.bin
+./vm_bench compilation/arithmetic_slots.bin
+./vm_bench_jit compilation/arithmetic.bin
+./vm_bench_jit compilation/arithmetic_slots.bin
+./tokenizer_bench
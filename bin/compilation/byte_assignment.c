@@ -0,0 +1,243 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 8 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_byte_assignment(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2; (void)s3; (void)s4; (void)s5; (void)s6; (void)s7;
+    s0 = 0;
+    s1 = 0;
+    s2 = 0;
+    s3 = 0;
+    s4 = 0;
+    s5 = 0;
+    failed = 0;
+    failed |= check(0, s0);
+    failed |= check(0, s1);
+    failed |= check(0, s2);
+    failed |= check(0, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = s0;
+    s7 = 10;
+    s6 = (uint8_t)((uint32_t)s7 * s6);
+    s0 = s6;
+    failed = 0;
+    failed |= check(0, s0);
+    failed |= check(0, s1);
+    failed |= check(0, s2);
+    failed |= check(0, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = 1;
+    s6 = (uint8_t)((uint32_t)s0 + s6);
+    s0 = s6;
+    failed = 0;
+    failed |= check(1, s0);
+    failed |= check(0, s1);
+    failed |= check(0, s2);
+    failed |= check(0, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = s0;
+    s7 = 10;
+    s6 = (uint8_t)((uint32_t)s7 * s6);
+    s0 = s6;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(0, s1);
+    failed |= check(0, s2);
+    failed |= check(0, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = s0;
+    s6 = (uint8_t)((uint32_t)s0 + s6);
+    s1 = s6;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(20, s1);
+    failed |= check(0, s2);
+    failed |= check(0, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = s0;
+    s7 = s1;
+    if (s6 == 0) {
+        fprintf(stderr, "Division by zero!\n");
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        *count += 8;
+        return 2;
+    }
+    s6 = (uint8_t)((uint32_t)s7 / s6);
+    s2 = s6;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(20, s1);
+    failed |= check(2, s2);
+    failed |= check(0, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = s0;
+    s6 = (uint8_t)((uint32_t)s2 + s6);
+    s3 = s6;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(20, s1);
+    failed |= check(2, s2);
+    failed |= check(12, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = s3;
+    s7 = s2;
+    s7 = (uint8_t)((uint32_t)s1 * s7);
+    s7 = (uint8_t)((uint32_t)s0 + s7);
+    s6 = (uint8_t)((uint32_t)s7 - s6);
+    s4 = s6;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(20, s1);
+    failed |= check(2, s2);
+    failed |= check(12, s3);
+    failed |= check(38, s4);
+    failed |= check(0, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = s4;
+    s6 = (uint8_t)-s6;
+    s7 = s4;
+    s6 = (uint8_t)((uint32_t)s7 - s6);
+    s5 = s6;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(20, s1);
+    failed |= check(2, s2);
+    failed |= check(12, s3);
+    failed |= check(38, s4);
+    failed |= check(76, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    top[0] = s0;
+    top[1] = s1;
+    top[2] = s2;
+    top[3] = s3;
+    top[4] = s4;
+    top[5] = s5;
+    *count += 6;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[9];
+    uint32_t count = 0;
+    return shabby_byte_assignment(stack, &count);
+}
+#endif
@@ -0,0 +1,131 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 8 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_byte_declaration(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2; (void)s3; (void)s4; (void)s5; (void)s6; (void)s7;
+    s0 = 0;
+    failed = 0;
+    failed |= check(0, s0);
+    if (failed) {
+        top[0] = s0;
+        *count += 1;
+        return 1;
+    }
+    s1 = 10;
+    failed = 0;
+    failed |= check(0, s0);
+    failed |= check(10, s1);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        *count += 2;
+        return 1;
+    }
+    s2 = 255;
+    failed = 0;
+    failed |= check(10, s1);
+    failed |= check(-1, s2);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        *count += 3;
+        return 1;
+    }
+    s3 = 128;
+    s4 = 0;
+    failed = 0;
+    failed |= check(-1, s2);
+    failed |= check(-128, s3);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        *count += 4;
+        return 1;
+    }
+    s4 = s2;
+    s4 = (uint8_t)((uint32_t)s1 + s4);
+    failed = 0;
+    failed |= check(-128, s3);
+    failed |= check(9, s4);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        *count += 5;
+        return 1;
+    }
+    s5 = 127;
+    s6 = 2;
+    s6 = (uint8_t)((uint32_t)s5 * s6);
+    failed = 0;
+    failed |= check(127, s5);
+    failed |= check(-2, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 254;
+    s7 = (uint8_t)((uint32_t)s5 * s7);
+    failed = 0;
+    failed |= check(-2, s6);
+    failed |= check(2, s7);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        *count += 8;
+        return 1;
+    }
+    top[0] = s0;
+    top[1] = s1;
+    top[2] = s2;
+    top[3] = s3;
+    top[4] = s4;
+    top[5] = s5;
+    top[6] = s6;
+    top[7] = s7;
+    *count += 8;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[9];
+    uint32_t count = 0;
+    return shabby_byte_declaration(stack, &count);
+}
+#endif
@@ -0,0 +1,205 @@
+@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's
+    .syntax unified
+    .cpu cortex-m0
+    .thumb
+    .text
+
+@ int shabby_byte_declaration(uint8_t* stack, uint32_t* count)
+@ appends what the program leaves on the exec stack, which needs room for 8 more bytes,
+@ 0 when it finished and 1 when a test failed
+    .global shabby_byte_declaration
+    .thumb_func
+shabby_byte_declaration:
+    push {r4, r5, r6, r7, lr}
+    ldr r2, [r1]
+    adds r4, r0, r2
+    mov r6, r1
+    movs r0, #0
+    strb r0, [r4, #0]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #0
+    beq .L1
+    movs r5, #1
+.L1:
+    cmp r5, #0
+    beq .L0
+    ldr r0, [r6]
+    movs r1, #1
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L0:
+    movs r0, #10
+    strb r0, [r4, #1]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #0
+    beq .L3
+    movs r5, #1
+.L3:
+    ldrb r0, [r4, #1]
+    cmp r0, #10
+    beq .L4
+    movs r5, #1
+.L4:
+    cmp r5, #0
+    beq .L2
+    ldr r0, [r6]
+    movs r1, #2
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L2:
+    movs r0, #255
+    strb r0, [r4, #2]
+    movs r5, #0
+    ldrb r0, [r4, #1]
+    cmp r0, #10
+    beq .L6
+    movs r5, #1
+.L6:
+    ldrb r0, [r4, #2]
+    cmp r0, #255
+    beq .L7
+    movs r5, #1
+.L7:
+    cmp r5, #0
+    beq .L5
+    ldr r0, [r6]
+    movs r1, #3
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L5:
+    movs r0, #128
+    strb r0, [r4, #3]
+    movs r0, #0
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #2]
+    cmp r0, #255
+    beq .L9
+    movs r5, #1
+.L9:
+    ldrb r0, [r4, #3]
+    cmp r0, #128
+    beq .L10
+    movs r5, #1
+.L10:
+    cmp r5, #0
+    beq .L8
+    ldr r0, [r6]
+    movs r1, #4
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L8:
+    ldrb r0, [r4, #2]
+    strb r0, [r4, #4]
+    ldrb r0, [r4, #1]
+    ldrb r1, [r4, #4]
+    adds r0, r0, r1
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #128
+    beq .L12
+    movs r5, #1
+.L12:
+    ldrb r0, [r4, #4]
+    cmp r0, #9
+    beq .L13
+    movs r5, #1
+.L13:
+    cmp r5, #0
+    beq .L11
+    ldr r0, [r6]
+    movs r1, #5
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L11:
+    movs r0, #127
+    strb r0, [r4, #5]
+    movs r0, #2
+    strb r0, [r4, #6]
+    ldrb r0, [r4, #5]
+    ldrb r1, [r4, #6]
+    muls r0, r1, r0
+    strb r0, [r4, #6]
+    movs r5, #0
+    ldrb r0, [r4, #5]
+    cmp r0, #127
+    beq .L15
+    movs r5, #1
+.L15:
+    ldrb r0, [r4, #6]
+    cmp r0, #254
+    beq .L16
+    movs r5, #1
+.L16:
+    cmp r5, #0
+    beq .L14
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L14:
+    movs r0, #254
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #5]
+    ldrb r1, [r4, #7]
+    muls r0, r1, r0
+    strb r0, [r4, #7]
+    movs r5, #0
+    ldrb r0, [r4, #6]
+    cmp r0, #254
+    beq .L18
+    movs r5, #1
+.L18:
+    ldrb r0, [r4, #7]
+    cmp r0, #2
+    beq .L19
+    movs r5, #1
+.L19:
+    cmp r5, #0
+    beq .L17
+    ldr r0, [r6]
+    movs r1, #8
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L17:
+    ldr r0, [r6]
+    movs r1, #8
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #0
+    pop {r4, r5, r6, r7, pc}
+
+.ifdef SHABBY_MAIN
+    .global _start
+    .thumb_func
+_start:
+    ldr r0, =.Lstack
+    ldr r1, =.Lcount
+    bl shabby_byte_declaration
+    movs r7, #1
+    svc #0
+    .ltorg
+    .bss
+    .balign 4
+.Lcount:
+    .space 4
+.Lstack:
+    .space 9
+.endif
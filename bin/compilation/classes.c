@@ -0,0 +1,308 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 34 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_classes(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    uint8_t s8 = 0, s9 = 0, s10 = 0, s11 = 0, s12 = 0, s13 = 0, s14 = 0, s15 = 0;
+    uint8_t s16 = 0, s17 = 0, s18 = 0, s19 = 0, s20 = 0, s21 = 0, s22 = 0, s23 = 0;
+    uint8_t s24 = 0, s25 = 0, s26 = 0, s27 = 0, s28 = 0, s29 = 0, s30 = 0, s31 = 0;
+    uint8_t s32 = 0, s33 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2; (void)s3; (void)s4; (void)s5; (void)s6; (void)s7;
+    (void)s8; (void)s9; (void)s10; (void)s11; (void)s12; (void)s13; (void)s14; (void)s15;
+    (void)s16; (void)s17; (void)s18; (void)s19; (void)s20; (void)s21; (void)s22; (void)s23;
+    (void)s24; (void)s25; (void)s26; (void)s27; (void)s28; (void)s29; (void)s30; (void)s31;
+    (void)s32; (void)s33;
+    s0 = 10;
+    s1 = 0;
+    s2 = 0;
+    s3 = 0;
+    s4 = 0;
+    s5 = 0;
+    s6 = 9;
+    s7 = 0;
+    s8 = 1;
+    s9 = 0;
+    s4 = 0;
+    s5 = 0;
+    s6 = 0;
+    s7 = 0;
+    s8 = 0;
+    s9 = 14;
+    s10 = 0;
+    s11 = 4;
+    s12 = 0;
+    s7 = 90;
+    s8 = 1;
+    s1 = s8;
+    s8 = 2;
+    s2 = s8;
+    s8 = 3;
+    s9 = 0;
+    s10 = 4;
+    s11 = 0;
+    s12 = 1;
+    s13 = 0;
+    s6 = s3;
+    s5 = s2;
+    s4 = s1;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(1, s1);
+    failed |= check(2, s2);
+    failed |= check(0, s3);
+    failed |= check(1, s4);
+    failed |= check(2, s5);
+    failed |= check(0, s6);
+    failed |= check(90, s7);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        *count += 8;
+        return 1;
+    }
+    s8 = 0;
+    s9 = 0;
+    s10 = 0;
+    s11 = 0;
+    s12 = 0;
+    s13 = 0;
+    s14 = 53;
+    s15 = 0;
+    s16 = 8;
+    s17 = 0;
+    s18 = 3;
+    s8 = s18;
+    s18 = 44;
+    s19 = 1;
+    s9 = s18;
+    s10 = s19;
+    s12 = 5;
+    s8 = s12;
+    s12 = 0;
+    s13 = 0;
+    s14 = 0;
+    s15 = 0;
+    s16 = 0;
+    s17 = 0;
+    s18 = 61;
+    s19 = 0;
+    s20 = 12;
+    s21 = 0;
+    s22 = 3;
+    s12 = s22;
+    s22 = 44;
+    s23 = 1;
+    s13 = s22;
+    s14 = s23;
+    s16 = 4;
+    s17 = 0;
+    s18 = 12;
+    s19 = 0;
+    s20 = 8;
+    s21 = 0;
+    s15 = s11;
+    s14 = s10;
+    s13 = s9;
+    s12 = s8;
+    s16 = 2;
+    s16 = (uint8_t)((uint32_t)s8 * s16);
+    s11 = s16;
+    s16 = s12;
+    s17 = (s16 & 0x80) ? 0xFF : 0;
+    SET16(s16, s17, GET16(s9, s10) + GET16(s16, s17));
+    s9 = s16;
+    s10 = s17;
+    s16 = s12;
+    s16 = (uint8_t)((uint32_t)s11 + s16);
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(1, s1);
+    failed |= check(2, s2);
+    failed |= check(0, s3);
+    failed |= check(1, s4);
+    failed |= check(2, s5);
+    failed |= check(0, s6);
+    failed |= check(90, s7);
+    failed |= check(5, s8);
+    failed |= check(49, s9);
+    failed |= check(1, s10);
+    failed |= check(10, s11);
+    failed |= check(5, s12);
+    failed |= check(44, s13);
+    failed |= check(1, s14);
+    failed |= check(0, s15);
+    failed |= check(15, s16);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        top[15] = s15;
+        top[16] = s16;
+        *count += 17;
+        return 1;
+    }
+    s17 = 0;
+    s18 = 0;
+    s19 = 0;
+    s20 = 0;
+    s21 = 120;
+    s22 = 0;
+    s23 = 17;
+    s24 = 0;
+    s25 = 0;
+    s26 = 0;
+    s27 = 112;
+    s28 = 0;
+    s29 = 0;
+    s30 = 0;
+    s31 = 9;
+    s17 = s31;
+    s25 = 4;
+    s18 = s25;
+    s19 = 1;
+    s19 = (uint8_t)((uint32_t)s18 + s19);
+    s18 = s19;
+    s19 = s18;
+    s20 = 2;
+    s20 = (uint8_t)((uint32_t)s17 * s20);
+    s19 = (uint8_t)((uint32_t)s20 + s19);
+    s17 = s19;
+    s19 = 0;
+    s20 = 0;
+    s21 = 0;
+    s22 = 0;
+    s23 = 137;
+    s24 = 0;
+    s25 = 19;
+    s26 = 0;
+    s27 = 0;
+    s28 = 0;
+    s29 = 112;
+    s30 = 0;
+    s31 = 0;
+    s32 = 0;
+    s33 = 9;
+    s19 = s33;
+    s27 = 4;
+    s20 = s27;
+    s21 = 2;
+    s22 = 0;
+    s23 = 19;
+    s24 = 0;
+    s25 = 17;
+    s26 = 0;
+    s20 = s18;
+    s19 = s17;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(1, s1);
+    failed |= check(2, s2);
+    failed |= check(0, s3);
+    failed |= check(1, s4);
+    failed |= check(2, s5);
+    failed |= check(0, s6);
+    failed |= check(90, s7);
+    failed |= check(5, s8);
+    failed |= check(49, s9);
+    failed |= check(1, s10);
+    failed |= check(10, s11);
+    failed |= check(5, s12);
+    failed |= check(44, s13);
+    failed |= check(1, s14);
+    failed |= check(0, s15);
+    failed |= check(15, s16);
+    failed |= check(23, s17);
+    failed |= check(5, s18);
+    failed |= check(23, s19);
+    failed |= check(5, s20);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        top[15] = s15;
+        top[16] = s16;
+        top[17] = s17;
+        top[18] = s18;
+        top[19] = s19;
+        top[20] = s20;
+        *count += 21;
+        return 1;
+    }
+    top[0] = s0;
+    top[1] = s1;
+    top[2] = s2;
+    top[3] = s3;
+    top[4] = s4;
+    top[5] = s5;
+    top[6] = s6;
+    top[7] = s7;
+    top[8] = s8;
+    top[9] = s9;
+    top[10] = s10;
+    top[11] = s11;
+    top[12] = s12;
+    top[13] = s13;
+    top[14] = s14;
+    top[15] = s15;
+    top[16] = s16;
+    top[17] = s17;
+    top[18] = s18;
+    top[19] = s19;
+    top[20] = s20;
+    *count += 21;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[35];
+    uint32_t count = 0;
+    return shabby_classes(stack, &count);
+}
+#endif
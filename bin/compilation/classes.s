@@ -0,0 +1,568 @@
+@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's
+    .syntax unified
+    .cpu cortex-m0
+    .thumb
+    .text
+
+@ int shabby_classes(uint8_t* stack, uint32_t* count)
+@ appends what the program leaves on the exec stack, which needs room for 30 more bytes,
+@ 0 when it finished and 1 when a test failed
+    .global shabby_classes
+    .thumb_func
+shabby_classes:
+    push {r4, r5, r6, r7, lr}
+    ldr r2, [r1]
+    adds r4, r0, r2
+    mov r6, r1
+    movs r0, #10
+    strb r0, [r4, #0]
+    movs r0, #0
+    strb r0, [r4, #1]
+    movs r0, #0
+    strb r0, [r4, #2]
+    movs r0, #0
+    strb r0, [r4, #3]
+    movs r0, #14
+    strb r0, [r4, #4]
+    movs r0, #0
+    strb r0, [r4, #5]
+    movs r0, #1
+    strb r0, [r4, #6]
+    movs r0, #0
+    strb r0, [r4, #7]
+    movs r0, #0
+    strb r0, [r4, #4]
+    movs r0, #0
+    strb r0, [r4, #5]
+    movs r0, #0
+    strb r0, [r4, #6]
+    movs r0, #22
+    strb r0, [r4, #7]
+    movs r0, #0
+    strb r0, [r4, #8]
+    movs r0, #4
+    strb r0, [r4, #9]
+    movs r0, #0
+    strb r0, [r4, #10]
+    movs r0, #90
+    strb r0, [r4, #7]
+    movs r0, #1
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #1]
+    movs r0, #2
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #2]
+    movs r0, #3
+    strb r0, [r4, #8]
+    movs r0, #0
+    strb r0, [r4, #9]
+    movs r0, #4
+    strb r0, [r4, #10]
+    movs r0, #0
+    strb r0, [r4, #11]
+    movs r0, #1
+    strb r0, [r4, #12]
+    movs r0, #0
+    strb r0, [r4, #13]
+    ldrb r0, [r4, #3]
+    strb r0, [r4, #6]
+    ldrb r0, [r4, #2]
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #1]
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #10
+    beq .L1
+    movs r5, #1
+.L1:
+    ldrb r0, [r4, #1]
+    cmp r0, #1
+    beq .L2
+    movs r5, #1
+.L2:
+    ldrb r0, [r4, #2]
+    cmp r0, #2
+    beq .L3
+    movs r5, #1
+.L3:
+    ldrb r0, [r4, #3]
+    cmp r0, #0
+    beq .L4
+    movs r5, #1
+.L4:
+    ldrb r0, [r4, #4]
+    cmp r0, #1
+    beq .L5
+    movs r5, #1
+.L5:
+    ldrb r0, [r4, #5]
+    cmp r0, #2
+    beq .L6
+    movs r5, #1
+.L6:
+    ldrb r0, [r4, #6]
+    cmp r0, #0
+    beq .L7
+    movs r5, #1
+.L7:
+    ldrb r0, [r4, #7]
+    cmp r0, #90
+    beq .L8
+    movs r5, #1
+.L8:
+    cmp r5, #0
+    beq .L0
+    ldr r0, [r6]
+    movs r1, #8
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L0:
+    movs r0, #0
+    strb r0, [r4, #8]
+    movs r0, #0
+    strb r0, [r4, #9]
+    movs r0, #0
+    strb r0, [r4, #10]
+    movs r0, #0
+    strb r0, [r4, #11]
+    movs r0, #78
+    strb r0, [r4, #12]
+    movs r0, #0
+    strb r0, [r4, #13]
+    movs r0, #8
+    strb r0, [r4, #14]
+    movs r0, #0
+    strb r0, [r4, #15]
+    movs r0, #3
+    strb r0, [r4, #16]
+    ldrb r0, [r4, #16]
+    strb r0, [r4, #8]
+    movs r0, #44
+    strb r0, [r4, #16]
+    movs r0, #1
+    strb r0, [r4, #17]
+    ldrb r0, [r4, #16]
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #17]
+    strb r0, [r4, #10]
+    movs r0, #5
+    strb r0, [r4, #12]
+    ldrb r0, [r4, #12]
+    strb r0, [r4, #8]
+    movs r0, #0
+    strb r0, [r4, #12]
+    movs r0, #0
+    strb r0, [r4, #13]
+    movs r0, #0
+    strb r0, [r4, #14]
+    movs r0, #0
+    strb r0, [r4, #15]
+    movs r0, #91
+    strb r0, [r4, #16]
+    movs r0, #0
+    strb r0, [r4, #17]
+    movs r0, #12
+    strb r0, [r4, #18]
+    movs r0, #0
+    strb r0, [r4, #19]
+    movs r0, #3
+    strb r0, [r4, #20]
+    ldrb r0, [r4, #20]
+    strb r0, [r4, #12]
+    movs r0, #44
+    strb r0, [r4, #20]
+    movs r0, #1
+    strb r0, [r4, #21]
+    ldrb r0, [r4, #20]
+    strb r0, [r4, #13]
+    ldrb r0, [r4, #21]
+    strb r0, [r4, #14]
+    movs r0, #4
+    strb r0, [r4, #16]
+    movs r0, #0
+    strb r0, [r4, #17]
+    movs r0, #12
+    strb r0, [r4, #18]
+    movs r0, #0
+    strb r0, [r4, #19]
+    movs r0, #8
+    strb r0, [r4, #20]
+    movs r0, #0
+    strb r0, [r4, #21]
+    ldrb r0, [r4, #11]
+    strb r0, [r4, #15]
+    ldrb r0, [r4, #10]
+    strb r0, [r4, #14]
+    ldrb r0, [r4, #9]
+    strb r0, [r4, #13]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #12]
+    movs r0, #2
+    strb r0, [r4, #16]
+    ldrb r0, [r4, #8]
+    ldrb r1, [r4, #16]
+    muls r0, r1, r0
+    strb r0, [r4, #16]
+    ldrb r0, [r4, #16]
+    strb r0, [r4, #11]
+    ldrb r0, [r4, #12]
+    strb r0, [r4, #16]
+    ldrb r0, [r4, #16]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #17]
+    ldrb r0, [r4, #9]
+    ldrb r2, [r4, #10]
+    lsls r2, r2, #8
+    orrs r0, r2
+    ldrb r1, [r4, #16]
+    ldrb r3, [r4, #17]
+    lsls r3, r3, #8
+    orrs r1, r3
+    adds r0, r0, r1
+    strb r0, [r4, #16]
+    lsrs r0, r0, #8
+    strb r0, [r4, #17]
+    ldrb r0, [r4, #16]
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #17]
+    strb r0, [r4, #10]
+    ldrb r0, [r4, #12]
+    strb r0, [r4, #16]
+    ldrb r0, [r4, #11]
+    ldrb r1, [r4, #16]
+    adds r0, r0, r1
+    strb r0, [r4, #16]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #10
+    beq .L10
+    movs r5, #1
+.L10:
+    ldrb r0, [r4, #1]
+    cmp r0, #1
+    beq .L11
+    movs r5, #1
+.L11:
+    ldrb r0, [r4, #2]
+    cmp r0, #2
+    beq .L12
+    movs r5, #1
+.L12:
+    ldrb r0, [r4, #3]
+    cmp r0, #0
+    beq .L13
+    movs r5, #1
+.L13:
+    ldrb r0, [r4, #4]
+    cmp r0, #1
+    beq .L14
+    movs r5, #1
+.L14:
+    ldrb r0, [r4, #5]
+    cmp r0, #2
+    beq .L15
+    movs r5, #1
+.L15:
+    ldrb r0, [r4, #6]
+    cmp r0, #0
+    beq .L16
+    movs r5, #1
+.L16:
+    ldrb r0, [r4, #7]
+    cmp r0, #90
+    beq .L17
+    movs r5, #1
+.L17:
+    ldrb r0, [r4, #8]
+    cmp r0, #5
+    beq .L18
+    movs r5, #1
+.L18:
+    ldrb r0, [r4, #9]
+    cmp r0, #49
+    beq .L19
+    movs r5, #1
+.L19:
+    ldrb r0, [r4, #10]
+    cmp r0, #1
+    beq .L20
+    movs r5, #1
+.L20:
+    ldrb r0, [r4, #11]
+    cmp r0, #10
+    beq .L21
+    movs r5, #1
+.L21:
+    ldrb r0, [r4, #12]
+    cmp r0, #5
+    beq .L22
+    movs r5, #1
+.L22:
+    ldrb r0, [r4, #13]
+    cmp r0, #44
+    beq .L23
+    movs r5, #1
+.L23:
+    ldrb r0, [r4, #14]
+    cmp r0, #1
+    beq .L24
+    movs r5, #1
+.L24:
+    ldrb r0, [r4, #15]
+    cmp r0, #0
+    beq .L25
+    movs r5, #1
+.L25:
+    ldrb r0, [r4, #16]
+    cmp r0, #15
+    beq .L26
+    movs r5, #1
+.L26:
+    cmp r5, #0
+    beq .L9
+    ldr r0, [r6]
+    movs r1, #17
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L9:
+    movs r0, #0
+    strb r0, [r4, #17]
+    movs r0, #0
+    strb r0, [r4, #18]
+    movs r0, #176
+    strb r0, [r4, #19]
+    movs r0, #0
+    strb r0, [r4, #20]
+    movs r0, #17
+    strb r0, [r4, #21]
+    movs r0, #0
+    strb r0, [r4, #22]
+    movs r0, #162
+    strb r0, [r4, #23]
+    movs r0, #0
+    strb r0, [r4, #24]
+    movs r0, #0
+    strb r0, [r4, #25]
+    movs r0, #0
+    strb r0, [r4, #26]
+    movs r0, #9
+    strb r0, [r4, #27]
+    ldrb r0, [r4, #27]
+    strb r0, [r4, #17]
+    movs r0, #4
+    strb r0, [r4, #23]
+    ldrb r0, [r4, #23]
+    strb r0, [r4, #18]
+    movs r0, #1
+    strb r0, [r4, #19]
+    ldrb r0, [r4, #18]
+    ldrb r1, [r4, #19]
+    adds r0, r0, r1
+    strb r0, [r4, #19]
+    ldrb r0, [r4, #19]
+    strb r0, [r4, #18]
+    ldrb r0, [r4, #18]
+    strb r0, [r4, #19]
+    movs r0, #2
+    strb r0, [r4, #20]
+    ldrb r0, [r4, #17]
+    ldrb r1, [r4, #20]
+    muls r0, r1, r0
+    strb r0, [r4, #20]
+    ldrb r0, [r4, #20]
+    ldrb r1, [r4, #19]
+    adds r0, r0, r1
+    strb r0, [r4, #19]
+    ldrb r0, [r4, #19]
+    strb r0, [r4, #17]
+    movs r0, #0
+    strb r0, [r4, #19]
+    movs r0, #0
+    strb r0, [r4, #20]
+    movs r0, #204
+    strb r0, [r4, #21]
+    movs r0, #0
+    strb r0, [r4, #22]
+    movs r0, #19
+    strb r0, [r4, #23]
+    movs r0, #0
+    strb r0, [r4, #24]
+    movs r0, #162
+    strb r0, [r4, #25]
+    movs r0, #0
+    strb r0, [r4, #26]
+    movs r0, #0
+    strb r0, [r4, #27]
+    movs r0, #0
+    strb r0, [r4, #28]
+    movs r0, #9
+    strb r0, [r4, #29]
+    ldrb r0, [r4, #29]
+    strb r0, [r4, #19]
+    movs r0, #4
+    strb r0, [r4, #25]
+    ldrb r0, [r4, #25]
+    strb r0, [r4, #20]
+    movs r0, #2
+    strb r0, [r4, #21]
+    movs r0, #0
+    strb r0, [r4, #22]
+    movs r0, #19
+    strb r0, [r4, #23]
+    movs r0, #0
+    strb r0, [r4, #24]
+    movs r0, #17
+    strb r0, [r4, #25]
+    movs r0, #0
+    strb r0, [r4, #26]
+    ldrb r0, [r4, #18]
+    strb r0, [r4, #20]
+    ldrb r0, [r4, #17]
+    strb r0, [r4, #19]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #10
+    beq .L28
+    movs r5, #1
+.L28:
+    ldrb r0, [r4, #1]
+    cmp r0, #1
+    beq .L29
+    movs r5, #1
+.L29:
+    ldrb r0, [r4, #2]
+    cmp r0, #2
+    beq .L30
+    movs r5, #1
+.L30:
+    ldrb r0, [r4, #3]
+    cmp r0, #0
+    beq .L31
+    movs r5, #1
+.L31:
+    ldrb r0, [r4, #4]
+    cmp r0, #1
+    beq .L32
+    movs r5, #1
+.L32:
+    ldrb r0, [r4, #5]
+    cmp r0, #2
+    beq .L33
+    movs r5, #1
+.L33:
+    ldrb r0, [r4, #6]
+    cmp r0, #0
+    beq .L34
+    movs r5, #1
+.L34:
+    ldrb r0, [r4, #7]
+    cmp r0, #90
+    beq .L35
+    movs r5, #1
+.L35:
+    ldrb r0, [r4, #8]
+    cmp r0, #5
+    beq .L36
+    movs r5, #1
+.L36:
+    ldrb r0, [r4, #9]
+    cmp r0, #49
+    beq .L37
+    movs r5, #1
+.L37:
+    ldrb r0, [r4, #10]
+    cmp r0, #1
+    beq .L38
+    movs r5, #1
+.L38:
+    ldrb r0, [r4, #11]
+    cmp r0, #10
+    beq .L39
+    movs r5, #1
+.L39:
+    ldrb r0, [r4, #12]
+    cmp r0, #5
+    beq .L40
+    movs r5, #1
+.L40:
+    ldrb r0, [r4, #13]
+    cmp r0, #44
+    beq .L41
+    movs r5, #1
+.L41:
+    ldrb r0, [r4, #14]
+    cmp r0, #1
+    beq .L42
+    movs r5, #1
+.L42:
+    ldrb r0, [r4, #15]
+    cmp r0, #0
+    beq .L43
+    movs r5, #1
+.L43:
+    ldrb r0, [r4, #16]
+    cmp r0, #15
+    beq .L44
+    movs r5, #1
+.L44:
+    ldrb r0, [r4, #17]
+    cmp r0, #23
+    beq .L45
+    movs r5, #1
+.L45:
+    ldrb r0, [r4, #18]
+    cmp r0, #5
+    beq .L46
+    movs r5, #1
+.L46:
+    ldrb r0, [r4, #19]
+    cmp r0, #23
+    beq .L47
+    movs r5, #1
+.L47:
+    ldrb r0, [r4, #20]
+    cmp r0, #5
+    beq .L48
+    movs r5, #1
+.L48:
+    cmp r5, #0
+    beq .L27
+    ldr r0, [r6]
+    movs r1, #21
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L27:
+    ldr r0, [r6]
+    movs r1, #21
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #0
+    pop {r4, r5, r6, r7, pc}
+
+.ifdef SHABBY_MAIN
+    .global _start
+    .thumb_func
+_start:
+    ldr r0, =.Lstack
+    ldr r1, =.Lcount
+    bl shabby_classes
+    movs r7, #1
+    svc #0
+    .ltorg
+    .bss
+    .balign 4
+.Lcount:
+    .space 4
+.Lstack:
+    .space 31
+.endif
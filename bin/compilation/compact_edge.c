@@ -0,0 +1,250 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 50 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_compact_edge(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    uint8_t s8 = 0, s9 = 0, s10 = 0, s11 = 0, s12 = 0, s13 = 0, s14 = 0, s15 = 0;
+    uint8_t s16 = 0, s17 = 0, s18 = 0, s19 = 0, s20 = 0, s21 = 0, s22 = 0, s23 = 0;
+    uint8_t s24 = 0, s25 = 0, s26 = 0, s27 = 0, s28 = 0, s29 = 0, s30 = 0, s31 = 0;
+    uint8_t s32 = 0, s33 = 0, s34 = 0, s35 = 0, s36 = 0, s37 = 0, s38 = 0, s39 = 0;
+    uint8_t s40 = 0, s41 = 0, s42 = 0, s43 = 0, s44 = 0, s45 = 0, s46 = 0, s47 = 0;
+    uint8_t s48 = 0, s49 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2; (void)s3; (void)s4; (void)s5; (void)s6; (void)s7;
+    (void)s8; (void)s9; (void)s10; (void)s11; (void)s12; (void)s13; (void)s14; (void)s15;
+    (void)s16; (void)s17; (void)s18; (void)s19; (void)s20; (void)s21; (void)s22; (void)s23;
+    (void)s24; (void)s25; (void)s26; (void)s27; (void)s28; (void)s29; (void)s30; (void)s31;
+    (void)s32; (void)s33; (void)s34; (void)s35; (void)s36; (void)s37; (void)s38; (void)s39;
+    (void)s40; (void)s41; (void)s42; (void)s43; (void)s44; (void)s45; (void)s46; (void)s47;
+    (void)s48; (void)s49;
+    s0 = 0;
+    s1 = 0;
+    s2 = 0;
+    s3 = 0;
+    s4 = 0;
+    s5 = 0;
+    s6 = 0;
+    s7 = 0;
+    s8 = 0;
+    s9 = 0;
+    s10 = 0;
+    s11 = 0;
+    s12 = 0;
+    s13 = 0;
+    s14 = 0;
+    s15 = 0;
+    s16 = 0;
+    s17 = 0;
+    s18 = 0;
+    s19 = 0;
+    s20 = 0;
+    s21 = 0;
+    s22 = 0;
+    s23 = 0;
+    s24 = 0;
+    s25 = 0;
+    s26 = 0;
+    s27 = 0;
+    s28 = 0;
+    s29 = 0;
+    s30 = 0;
+    s31 = 0;
+    s32 = 0;
+    s33 = 0;
+    s34 = 0;
+    s35 = 0;
+    s36 = 0;
+    s37 = 0;
+    s38 = 141;
+    s39 = 0;
+    s40 = 0;
+    s41 = 0;
+    s42 = 0;
+    s43 = 0;
+    s44 = 132;
+    s45 = 0;
+    s46 = 0;
+    s47 = 0;
+    s48 = 1;
+    s0 = s48;
+    s48 = 2;
+    s1 = s48;
+    s48 = 3;
+    s2 = s48;
+    s48 = 4;
+    s3 = s48;
+    s48 = 5;
+    s4 = s48;
+    s48 = 6;
+    s5 = s48;
+    s48 = 7;
+    s6 = s48;
+    s48 = 8;
+    s7 = s48;
+    s48 = 9;
+    s8 = s48;
+    s48 = 10;
+    s9 = s48;
+    s48 = 11;
+    s10 = s48;
+    s48 = 12;
+    s11 = s48;
+    s48 = 13;
+    s12 = s48;
+    s48 = 14;
+    s13 = s48;
+    s48 = 15;
+    s14 = s48;
+    s48 = 16;
+    s15 = s48;
+    s48 = 17;
+    s16 = s48;
+    s48 = 18;
+    s17 = s48;
+    s48 = 19;
+    s18 = s48;
+    s48 = 20;
+    s19 = s48;
+    s48 = 21;
+    s20 = s48;
+    s48 = 22;
+    s21 = s48;
+    s48 = 23;
+    s22 = s48;
+    s48 = 24;
+    s23 = s48;
+    s48 = 25;
+    s24 = s48;
+    s48 = 26;
+    s25 = s48;
+    s48 = 27;
+    s26 = s48;
+    s48 = 28;
+    s27 = s48;
+    s48 = 29;
+    s28 = s48;
+    s48 = 30;
+    s29 = s48;
+    s48 = 31;
+    s30 = s48;
+    s48 = 32;
+    s31 = s48;
+    s48 = 33;
+    s32 = s48;
+    s48 = 44;
+    s49 = 1;
+    s33 = s48;
+    s34 = s49;
+    s42 = 8;
+    s35 = s42;
+    s36 = s35;
+    s36 = (uint8_t)((uint32_t)s32 + s36);
+    s35 = s36;
+    failed = 0;
+    failed |= check(32, s31);
+    failed |= check(33, s32);
+    failed |= check(44, s33);
+    failed |= check(1, s34);
+    failed |= check(41, s35);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        top[15] = s15;
+        top[16] = s16;
+        top[17] = s17;
+        top[18] = s18;
+        top[19] = s19;
+        top[20] = s20;
+        top[21] = s21;
+        top[22] = s22;
+        top[23] = s23;
+        top[24] = s24;
+        top[25] = s25;
+        top[26] = s26;
+        top[27] = s27;
+        top[28] = s28;
+        top[29] = s29;
+        top[30] = s30;
+        top[31] = s31;
+        top[32] = s32;
+        top[33] = s33;
+        top[34] = s34;
+        top[35] = s35;
+        *count += 36;
+        return 1;
+    }
+    top[0] = s0;
+    top[1] = s1;
+    top[2] = s2;
+    top[3] = s3;
+    top[4] = s4;
+    top[5] = s5;
+    top[6] = s6;
+    top[7] = s7;
+    top[8] = s8;
+    top[9] = s9;
+    top[10] = s10;
+    top[11] = s11;
+    top[12] = s12;
+    top[13] = s13;
+    top[14] = s14;
+    top[15] = s15;
+    top[16] = s16;
+    top[17] = s17;
+    top[18] = s18;
+    top[19] = s19;
+    top[20] = s20;
+    top[21] = s21;
+    top[22] = s22;
+    top[23] = s23;
+    top[24] = s24;
+    top[25] = s25;
+    top[26] = s26;
+    top[27] = s27;
+    top[28] = s28;
+    top[29] = s29;
+    top[30] = s30;
+    top[31] = s31;
+    top[32] = s32;
+    top[33] = s33;
+    top[34] = s34;
+    top[35] = s35;
+    *count += 36;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[51];
+    uint32_t count = 0;
+    return shabby_compact_edge(stack, &count);
+}
+#endif
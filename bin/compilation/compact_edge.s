@@ -0,0 +1,414 @@
+@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's
+    .syntax unified
+    .cpu cortex-m0
+    .thumb
+    .text
+
+@ int shabby_compact_edge(uint8_t* stack, uint32_t* count)
+@ appends what the program leaves on the exec stack, which needs room for 46 more bytes,
+@ 0 when it finished and 1 when a test failed
+    .global shabby_compact_edge
+    .thumb_func
+shabby_compact_edge:
+    push {r4, r5, r6, r7, lr}
+    ldr r2, [r1]
+    adds r4, r0, r2
+    mov r6, r1
+    movs r0, #0
+    strb r0, [r4, #0]
+    movs r0, #0
+    strb r0, [r4, #1]
+    movs r0, #0
+    strb r0, [r4, #2]
+    movs r0, #0
+    strb r0, [r4, #3]
+    movs r0, #0
+    strb r0, [r4, #4]
+    movs r0, #0
+    strb r0, [r4, #5]
+    movs r0, #0
+    strb r0, [r4, #6]
+    movs r0, #0
+    strb r0, [r4, #7]
+    movs r0, #0
+    strb r0, [r4, #8]
+    movs r0, #0
+    strb r0, [r4, #9]
+    movs r0, #0
+    strb r0, [r4, #10]
+    movs r0, #0
+    strb r0, [r4, #11]
+    movs r0, #0
+    strb r0, [r4, #12]
+    movs r0, #0
+    strb r0, [r4, #13]
+    movs r0, #0
+    strb r0, [r4, #14]
+    movs r0, #0
+    strb r0, [r4, #15]
+    movs r0, #0
+    strb r0, [r4, #16]
+    movs r0, #0
+    strb r0, [r4, #17]
+    movs r0, #0
+    strb r0, [r4, #18]
+    movs r0, #0
+    strb r0, [r4, #19]
+    movs r0, #0
+    strb r0, [r4, #20]
+    movs r0, #0
+    strb r0, [r4, #21]
+    movs r0, #0
+    strb r0, [r4, #22]
+    movs r0, #0
+    strb r0, [r4, #23]
+    movs r0, #0
+    strb r0, [r4, #24]
+    movs r0, #0
+    strb r0, [r4, #25]
+    movs r0, #0
+    strb r0, [r4, #26]
+    movs r0, #0
+    strb r0, [r4, #27]
+    movs r0, #0
+    strb r0, [r4, #28]
+    movs r0, #0
+    strb r0, [r4, #29]
+    movs r0, #0
+    strb r0, [r4, #30]
+    movs r0, #0
+    strb r0, [r4, #31]
+    movs r0, #0
+    movs r7, #32
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #33
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #34
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #35
+    strb r0, [r4, r7]
+    movs r0, #197
+    movs r7, #36
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #37
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #38
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #39
+    strb r0, [r4, r7]
+    movs r0, #183
+    movs r7, #40
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #41
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #42
+    strb r0, [r4, r7]
+    movs r0, #0
+    movs r7, #43
+    strb r0, [r4, r7]
+    movs r0, #1
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #0]
+    movs r0, #2
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #1]
+    movs r0, #3
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #2]
+    movs r0, #4
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #3]
+    movs r0, #5
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #4]
+    movs r0, #6
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #5]
+    movs r0, #7
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #6]
+    movs r0, #8
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #7]
+    movs r0, #9
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #8]
+    movs r0, #10
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #9]
+    movs r0, #11
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #10]
+    movs r0, #12
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #11]
+    movs r0, #13
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #12]
+    movs r0, #14
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #13]
+    movs r0, #15
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #14]
+    movs r0, #16
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #15]
+    movs r0, #17
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #16]
+    movs r0, #18
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #17]
+    movs r0, #19
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #18]
+    movs r0, #20
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #19]
+    movs r0, #21
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #20]
+    movs r0, #22
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #21]
+    movs r0, #23
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #22]
+    movs r0, #24
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #23]
+    movs r0, #25
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #24]
+    movs r0, #26
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #25]
+    movs r0, #27
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #26]
+    movs r0, #28
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #27]
+    movs r0, #29
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #28]
+    movs r0, #30
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #29]
+    movs r0, #31
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #30]
+    movs r0, #32
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    strb r0, [r4, #31]
+    movs r0, #33
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    movs r7, #32
+    strb r0, [r4, r7]
+    movs r0, #44
+    movs r7, #44
+    strb r0, [r4, r7]
+    movs r0, #1
+    movs r7, #45
+    strb r0, [r4, r7]
+    movs r7, #44
+    ldrb r0, [r4, r7]
+    movs r7, #33
+    strb r0, [r4, r7]
+    movs r7, #45
+    ldrb r0, [r4, r7]
+    movs r7, #34
+    strb r0, [r4, r7]
+    movs r0, #8
+    movs r7, #40
+    strb r0, [r4, r7]
+    movs r7, #40
+    ldrb r0, [r4, r7]
+    movs r7, #35
+    strb r0, [r4, r7]
+    movs r7, #35
+    ldrb r0, [r4, r7]
+    movs r7, #36
+    strb r0, [r4, r7]
+    movs r7, #32
+    ldrb r0, [r4, r7]
+    movs r7, #36
+    ldrb r1, [r4, r7]
+    adds r0, r0, r1
+    movs r7, #36
+    strb r0, [r4, r7]
+    movs r7, #36
+    ldrb r0, [r4, r7]
+    movs r7, #35
+    strb r0, [r4, r7]
+    movs r5, #0
+    ldrb r0, [r4, #31]
+    cmp r0, #32
+    beq .L1
+    movs r5, #1
+.L1:
+    movs r7, #32
+    ldrb r0, [r4, r7]
+    cmp r0, #33
+    beq .L2
+    movs r5, #1
+.L2:
+    movs r7, #33
+    ldrb r0, [r4, r7]
+    cmp r0, #44
+    beq .L3
+    movs r5, #1
+.L3:
+    movs r7, #34
+    ldrb r0, [r4, r7]
+    cmp r0, #1
+    beq .L4
+    movs r5, #1
+.L4:
+    movs r7, #35
+    ldrb r0, [r4, r7]
+    cmp r0, #41
+    beq .L5
+    movs r5, #1
+.L5:
+    cmp r5, #0
+    beq .L0
+    ldr r0, [r6]
+    movs r1, #36
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L0:
+    ldr r0, [r6]
+    movs r1, #36
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #0
+    pop {r4, r5, r6, r7, pc}
+
+.ifdef SHABBY_MAIN
+    .global _start
+    .thumb_func
+_start:
+    ldr r0, =.Lstack
+    ldr r1, =.Lcount
+    bl shabby_compact_edge
+    movs r7, #1
+    svc #0
+    .ltorg
+    .bss
+    .balign 4
+.Lcount:
+    .space 4
+.Lstack:
+    .space 47
+.endif
@@ -0,0 +1,267 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 15 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_dead_stores(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    uint8_t s8 = 0, s9 = 0, s10 = 0, s11 = 0, s12 = 0, s13 = 0, s14 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2; (void)s3; (void)s4; (void)s5; (void)s6; (void)s7;
+    (void)s8; (void)s9; (void)s10; (void)s11; (void)s12; (void)s13; (void)s14;
+    s0 = 1;
+    s1 = 0;
+    s2 = 0;
+    s3 = 0;
+    s4 = 0;
+    s5 = 11;
+    s6 = 0;
+    s7 = 1;
+    s8 = 0;
+    s9 = 9;
+    s1 = s9;
+    s3 = 0;
+    s4 = 0;
+    s5 = 0;
+    s6 = 0;
+    s7 = 15;
+    s8 = 0;
+    s9 = 3;
+    s10 = 0;
+    s11 = 9;
+    s3 = s11;
+    failed = 0;
+    failed |= check(1, s0);
+    failed |= check(9, s1);
+    failed |= check(0, s2);
+    failed |= check(9, s3);
+    failed |= check(0, s4);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        *count += 5;
+        return 1;
+    }
+    s5 = 3;
+    s1 = s5;
+    s5 = 2;
+    s6 = 0;
+    s7 = 3;
+    s8 = 0;
+    s9 = 1;
+    s10 = 0;
+    s4 = s2;
+    s3 = s1;
+    s5 = 4;
+    s1 = s5;
+    failed = 0;
+    failed |= check(1, s0);
+    failed |= check(4, s1);
+    failed |= check(0, s2);
+    failed |= check(3, s3);
+    failed |= check(0, s4);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        *count += 5;
+        return 1;
+    }
+    s5 = 5;
+    s2 = s5;
+    s5 = s2;
+    s0 = s5;
+    s5 = 6;
+    s2 = s5;
+    failed = 0;
+    failed |= check(5, s0);
+    failed |= check(4, s1);
+    failed |= check(6, s2);
+    failed |= check(3, s3);
+    failed |= check(0, s4);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        *count += 5;
+        return 1;
+    }
+    s5 = 7;
+    s0 = s5;
+    s5 = s0;
+    s6 = 8;
+    s0 = s6;
+    failed = 0;
+    failed |= check(8, s0);
+    failed |= check(4, s1);
+    failed |= check(6, s2);
+    failed |= check(3, s3);
+    failed |= check(0, s4);
+    failed |= check(7, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = 10;
+    s5 = s6;
+    s6 = 0;
+    s7 = 0;
+    s8 = 0;
+    s9 = 89;
+    s10 = 0;
+    s11 = 6;
+    s12 = 0;
+    s13 = 5;
+    s6 = s13;
+    s7 = 1;
+    s7 = (uint8_t)((uint32_t)s5 + s7);
+    s5 = s7;
+    failed = 0;
+    failed |= check(11, s5);
+    failed |= check(5, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 12;
+    s0 = s7;
+    failed = 0;
+    failed |= check(12, s0);
+    failed |= check(4, s1);
+    failed |= check(6, s2);
+    failed |= check(3, s3);
+    failed |= check(0, s4);
+    failed |= check(11, s5);
+    failed |= check(5, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 13;
+    s0 = s7;
+    failed = 0;
+    failed |= check(13, s0);
+    failed |= check(4, s1);
+    failed |= check(6, s2);
+    failed |= check(3, s3);
+    failed |= check(0, s4);
+    failed |= check(11, s5);
+    failed |= check(5, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 15;
+    s5 = s7;
+    failed = 0;
+    failed |= check(15, s5);
+    failed |= check(5, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 16;
+    s0 = s7;
+    s7 = 0;
+    s8 = 0;
+    s9 = 0;
+    s10 = 149;
+    s11 = 0;
+    s12 = 7;
+    s13 = 0;
+    s14 = 6;
+    s7 = s14;
+    failed = 0;
+    failed |= check(16, s0);
+    failed |= check(4, s1);
+    failed |= check(6, s2);
+    failed |= check(3, s3);
+    failed |= check(0, s4);
+    failed |= check(15, s5);
+    failed |= check(5, s6);
+    failed |= check(6, s7);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        *count += 8;
+        return 1;
+    }
+    top[0] = s0;
+    top[1] = s1;
+    top[2] = s2;
+    top[3] = s3;
+    top[4] = s4;
+    top[5] = s5;
+    top[6] = s6;
+    top[7] = s7;
+    *count += 8;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[16];
+    uint32_t count = 0;
+    return shabby_dead_stores(stack, &count);
+}
+#endif
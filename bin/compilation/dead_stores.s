@@ -0,0 +1,501 @@
+@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's
+    .syntax unified
+    .cpu cortex-m0
+    .thumb
+    .text
+
+@ int shabby_dead_stores(uint8_t* stack, uint32_t* count)
+@ appends what the program leaves on the exec stack, which needs room for 13 more bytes,
+@ 0 when it finished and 1 when a test failed
+    .global shabby_dead_stores
+    .thumb_func
+shabby_dead_stores:
+    push {r4, r5, r6, r7, lr}
+    ldr r2, [r1]
+    adds r4, r0, r2
+    mov r6, r1
+    movs r0, #1
+    strb r0, [r4, #0]
+    movs r0, #0
+    strb r0, [r4, #1]
+    movs r0, #0
+    strb r0, [r4, #2]
+    movs r0, #19
+    strb r0, [r4, #3]
+    movs r0, #0
+    strb r0, [r4, #4]
+    movs r0, #1
+    strb r0, [r4, #5]
+    movs r0, #0
+    strb r0, [r4, #6]
+    movs r0, #9
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #1]
+    movs r0, #0
+    strb r0, [r4, #3]
+    movs r0, #0
+    strb r0, [r4, #4]
+    movs r0, #27
+    strb r0, [r4, #5]
+    movs r0, #0
+    strb r0, [r4, #6]
+    movs r0, #3
+    strb r0, [r4, #7]
+    movs r0, #0
+    strb r0, [r4, #8]
+    movs r0, #9
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #9]
+    strb r0, [r4, #3]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #1
+    beq .L1
+    movs r5, #1
+.L1:
+    ldrb r0, [r4, #1]
+    cmp r0, #9
+    beq .L2
+    movs r5, #1
+.L2:
+    ldrb r0, [r4, #2]
+    cmp r0, #0
+    beq .L3
+    movs r5, #1
+.L3:
+    ldrb r0, [r4, #3]
+    cmp r0, #9
+    beq .L4
+    movs r5, #1
+.L4:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L5
+    movs r5, #1
+.L5:
+    cmp r5, #0
+    beq .L0
+    ldr r0, [r6]
+    movs r1, #5
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L0:
+    movs r0, #3
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #1]
+    movs r0, #2
+    strb r0, [r4, #5]
+    movs r0, #0
+    strb r0, [r4, #6]
+    movs r0, #3
+    strb r0, [r4, #7]
+    movs r0, #0
+    strb r0, [r4, #8]
+    movs r0, #1
+    strb r0, [r4, #9]
+    movs r0, #0
+    strb r0, [r4, #10]
+    ldrb r0, [r4, #2]
+    strb r0, [r4, #4]
+    ldrb r0, [r4, #1]
+    strb r0, [r4, #3]
+    movs r0, #4
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #1]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #1
+    beq .L7
+    movs r5, #1
+.L7:
+    ldrb r0, [r4, #1]
+    cmp r0, #4
+    beq .L8
+    movs r5, #1
+.L8:
+    ldrb r0, [r4, #2]
+    cmp r0, #0
+    beq .L9
+    movs r5, #1
+.L9:
+    ldrb r0, [r4, #3]
+    cmp r0, #3
+    beq .L10
+    movs r5, #1
+.L10:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L11
+    movs r5, #1
+.L11:
+    cmp r5, #0
+    beq .L6
+    ldr r0, [r6]
+    movs r1, #5
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L6:
+    movs r0, #5
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #2]
+    ldrb r0, [r4, #2]
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #0]
+    movs r0, #6
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #2]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #5
+    beq .L13
+    movs r5, #1
+.L13:
+    ldrb r0, [r4, #1]
+    cmp r0, #4
+    beq .L14
+    movs r5, #1
+.L14:
+    ldrb r0, [r4, #2]
+    cmp r0, #6
+    beq .L15
+    movs r5, #1
+.L15:
+    ldrb r0, [r4, #3]
+    cmp r0, #3
+    beq .L16
+    movs r5, #1
+.L16:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L17
+    movs r5, #1
+.L17:
+    cmp r5, #0
+    beq .L12
+    ldr r0, [r6]
+    movs r1, #5
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L12:
+    movs r0, #7
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #0]
+    ldrb r0, [r4, #0]
+    strb r0, [r4, #5]
+    movs r0, #8
+    strb r0, [r4, #6]
+    ldrb r0, [r4, #6]
+    strb r0, [r4, #0]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #8
+    beq .L19
+    movs r5, #1
+.L19:
+    ldrb r0, [r4, #1]
+    cmp r0, #4
+    beq .L20
+    movs r5, #1
+.L20:
+    ldrb r0, [r4, #2]
+    cmp r0, #6
+    beq .L21
+    movs r5, #1
+.L21:
+    ldrb r0, [r4, #3]
+    cmp r0, #3
+    beq .L22
+    movs r5, #1
+.L22:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L23
+    movs r5, #1
+.L23:
+    ldrb r0, [r4, #5]
+    cmp r0, #7
+    beq .L24
+    movs r5, #1
+.L24:
+    cmp r5, #0
+    beq .L18
+    ldr r0, [r6]
+    movs r1, #6
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L18:
+    movs r0, #10
+    strb r0, [r4, #6]
+    ldrb r0, [r4, #6]
+    strb r0, [r4, #5]
+    movs r0, #0
+    strb r0, [r4, #6]
+    movs r0, #130
+    strb r0, [r4, #7]
+    movs r0, #0
+    strb r0, [r4, #8]
+    movs r0, #6
+    strb r0, [r4, #9]
+    movs r0, #0
+    strb r0, [r4, #10]
+    movs r0, #5
+    strb r0, [r4, #11]
+    ldrb r0, [r4, #11]
+    strb r0, [r4, #6]
+    movs r0, #1
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #5]
+    ldrb r1, [r4, #7]
+    adds r0, r0, r1
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #5]
+    movs r5, #0
+    ldrb r0, [r4, #5]
+    cmp r0, #11
+    beq .L26
+    movs r5, #1
+.L26:
+    ldrb r0, [r4, #6]
+    cmp r0, #5
+    beq .L27
+    movs r5, #1
+.L27:
+    cmp r5, #0
+    beq .L25
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L25:
+    movs r0, #12
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #0]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #12
+    beq .L29
+    movs r5, #1
+.L29:
+    ldrb r0, [r4, #1]
+    cmp r0, #4
+    beq .L30
+    movs r5, #1
+.L30:
+    ldrb r0, [r4, #2]
+    cmp r0, #6
+    beq .L31
+    movs r5, #1
+.L31:
+    ldrb r0, [r4, #3]
+    cmp r0, #3
+    beq .L32
+    movs r5, #1
+.L32:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L33
+    movs r5, #1
+.L33:
+    ldrb r0, [r4, #5]
+    cmp r0, #11
+    beq .L34
+    movs r5, #1
+.L34:
+    ldrb r0, [r4, #6]
+    cmp r0, #5
+    beq .L35
+    movs r5, #1
+.L35:
+    cmp r5, #0
+    beq .L28
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L28:
+    movs r0, #13
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #0]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #13
+    beq .L37
+    movs r5, #1
+.L37:
+    ldrb r0, [r4, #1]
+    cmp r0, #4
+    beq .L38
+    movs r5, #1
+.L38:
+    ldrb r0, [r4, #2]
+    cmp r0, #6
+    beq .L39
+    movs r5, #1
+.L39:
+    ldrb r0, [r4, #3]
+    cmp r0, #3
+    beq .L40
+    movs r5, #1
+.L40:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L41
+    movs r5, #1
+.L41:
+    ldrb r0, [r4, #5]
+    cmp r0, #11
+    beq .L42
+    movs r5, #1
+.L42:
+    ldrb r0, [r4, #6]
+    cmp r0, #5
+    beq .L43
+    movs r5, #1
+.L43:
+    cmp r5, #0
+    beq .L36
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L36:
+    movs r0, #15
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #5]
+    movs r5, #0
+    ldrb r0, [r4, #5]
+    cmp r0, #15
+    beq .L45
+    movs r5, #1
+.L45:
+    ldrb r0, [r4, #6]
+    cmp r0, #5
+    beq .L46
+    movs r5, #1
+.L46:
+    cmp r5, #0
+    beq .L44
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L44:
+    movs r0, #16
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #0]
+    movs r0, #0
+    strb r0, [r4, #7]
+    movs r0, #204
+    strb r0, [r4, #8]
+    movs r0, #0
+    strb r0, [r4, #9]
+    movs r0, #7
+    strb r0, [r4, #10]
+    movs r0, #0
+    strb r0, [r4, #11]
+    movs r0, #6
+    strb r0, [r4, #12]
+    ldrb r0, [r4, #12]
+    strb r0, [r4, #7]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #16
+    beq .L48
+    movs r5, #1
+.L48:
+    ldrb r0, [r4, #1]
+    cmp r0, #4
+    beq .L49
+    movs r5, #1
+.L49:
+    ldrb r0, [r4, #2]
+    cmp r0, #6
+    beq .L50
+    movs r5, #1
+.L50:
+    ldrb r0, [r4, #3]
+    cmp r0, #3
+    beq .L51
+    movs r5, #1
+.L51:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L52
+    movs r5, #1
+.L52:
+    ldrb r0, [r4, #5]
+    cmp r0, #15
+    beq .L53
+    movs r5, #1
+.L53:
+    ldrb r0, [r4, #6]
+    cmp r0, #5
+    beq .L54
+    movs r5, #1
+.L54:
+    ldrb r0, [r4, #7]
+    cmp r0, #6
+    beq .L55
+    movs r5, #1
+.L55:
+    cmp r5, #0
+    beq .L47
+    ldr r0, [r6]
+    movs r1, #8
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L47:
+    ldr r0, [r6]
+    movs r1, #8
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #0
+    pop {r4, r5, r6, r7, pc}
+
+.ifdef SHABBY_MAIN
+    .global _start
+    .thumb_func
+_start:
+    ldr r0, =.Lstack
+    ldr r1, =.Lcount
+    bl shabby_dead_stores
+    movs r7, #1
+    svc #0
+    .ltorg
+    .bss
+    .balign 4
+.Lcount:
+    .space 4
+.Lstack:
+    .space 14
+.endif
@@ -0,0 +1,47 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 3 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_divide(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2;
+    s0 = 0;
+    s1 = s0;
+    s2 = 4;
+    if (s1 == 0) {
+        fprintf(stderr, "Division by zero!\n");
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        *count += 3;
+        return 2;
+    }
+    s1 = (uint8_t)((uint32_t)s2 / s1);
+    top[0] = s0;
+    top[1] = s1;
+    *count += 2;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[4];
+    uint32_t count = 0;
+    return shabby_divide(stack, &count);
+}
+#endif
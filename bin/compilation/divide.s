@@ -0,0 +1,76 @@
+@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's
+    .syntax unified
+    .cpu cortex-m0
+    .thumb
+    .text
+
+@ int shabby_divide(uint8_t* stack, uint32_t* count)
+@ appends what the program leaves on the exec stack, which needs room for 3 more bytes,
+@ 0 when it finished and 1 when a test failed
+    .global shabby_divide
+    .thumb_func
+shabby_divide:
+    push {r4, r5, r6, r7, lr}
+    ldr r2, [r1]
+    adds r4, r0, r2
+    mov r6, r1
+    movs r0, #0
+    strb r0, [r4, #0]
+    ldrb r0, [r4, #0]
+    strb r0, [r4, #1]
+    movs r0, #4
+    strb r0, [r4, #2]
+    ldrb r0, [r4, #2]
+    ldrb r1, [r4, #1]
+    bl .Ldivide
+    strb r0, [r4, #1]
+    ldr r0, [r6]
+    movs r1, #2
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #0
+    pop {r4, r5, r6, r7, pc}
+
+    .thumb_func
+.Ldivide:
+    cmp r1, #0
+    bne .Ldivide_start
+    udf #0
+.Ldivide_start:
+    movs r2, #0
+    movs r3, #1
+.Ldivide_align:
+    cmp r1, r0
+    bhs .Ldivide_subtract
+    lsls r1, r1, #1
+    lsls r3, r3, #1
+    b .Ldivide_align
+.Ldivide_subtract:
+    cmp r0, r1
+    blo .Ldivide_next
+    subs r0, r0, r1
+    orrs r2, r3
+.Ldivide_next:
+    lsrs r1, r1, #1
+    lsrs r3, r3, #1
+    bne .Ldivide_subtract
+    movs r0, r2
+    bx lr
+
+.ifdef SHABBY_MAIN
+    .global _start
+    .thumb_func
+_start:
+    ldr r0, =.Lstack
+    ldr r1, =.Lcount
+    bl shabby_divide
+    movs r7, #1
+    svc #0
+    .ltorg
+    .bss
+    .balign 4
+.Lcount:
+    .space 4
+.Lstack:
+    .space 4
+.endif
@@ -0,0 +1,387 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 20 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_folding(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    uint8_t s8 = 0, s9 = 0, s10 = 0, s11 = 0, s12 = 0, s13 = 0, s14 = 0, s15 = 0;
+    uint8_t s16 = 0, s17 = 0, s18 = 0, s19 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2; (void)s3; (void)s4; (void)s5; (void)s6; (void)s7;
+    (void)s8; (void)s9; (void)s10; (void)s11; (void)s12; (void)s13; (void)s14; (void)s15;
+    (void)s16; (void)s17; (void)s18; (void)s19;
+    s0 = 10;
+    failed = 0;
+    failed |= check(10, s0);
+    if (failed) {
+        top[0] = s0;
+        *count += 1;
+        return 1;
+    }
+    s1 = 141;
+    s2 = 19;
+    failed = 0;
+    failed |= check(10, s0);
+    failed |= check(-115, s1);
+    failed |= check(19, s2);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        *count += 3;
+        return 1;
+    }
+    s3 = 251;
+    failed = 0;
+    failed |= check(-115, s1);
+    failed |= check(19, s2);
+    failed |= check(-5, s3);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        *count += 4;
+        return 1;
+    }
+    s4 = s0;
+    failed = 0;
+    failed |= check(-5, s3);
+    failed |= check(10, s4);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        *count += 5;
+        return 1;
+    }
+    s5 = s0;
+    s5 = (uint8_t)((uint32_t)s0 + s5);
+    s4 = s5;
+    failed = 0;
+    failed |= check(-5, s3);
+    failed |= check(20, s4);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        *count += 5;
+        return 1;
+    }
+    s5 = 2;
+    s4 = s5;
+    s5 = 3;
+    s5 = (uint8_t)((uint32_t)s4 + s5);
+    s4 = s5;
+    failed = 0;
+    failed |= check(-5, s3);
+    failed |= check(5, s4);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        *count += 5;
+        return 1;
+    }
+    s5 = 0;
+    s6 = 4;
+    s6 = (uint8_t)((uint32_t)s5 + s6);
+    s5 = s6;
+    failed = 0;
+    failed |= check(5, s4);
+    failed |= check(4, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = 0;
+    s6 = (uint8_t)(s6 + 44);
+    s7 = (s6 & 0x80) ? 0xFF : 0;
+    failed = 0;
+    failed |= check(4, s5);
+    failed |= check(44, s6);
+    failed |= check(0, s7);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        *count += 8;
+        return 1;
+    }
+    s8 = 0;
+    s9 = 0;
+    s10 = 0;
+    s11 = 0;
+    s12 = 0;
+    s13 = 82;
+    s14 = 0;
+    s15 = 8;
+    s16 = 0;
+    s11 = 6;
+    s8 = s11;
+    s11 = s8;
+    s12 = (s11 & 0x80) ? 0xFF : 0;
+    s9 = s11;
+    s10 = s12;
+    failed = 0;
+    failed |= check(44, s6);
+    failed |= check(0, s7);
+    failed |= check(6, s8);
+    failed |= check(6, s9);
+    failed |= check(0, s10);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        *count += 11;
+        return 1;
+    }
+    failed = 0;
+    failed |= check(44, s6);
+    failed |= check(0, s7);
+    failed |= check(6, s8);
+    failed |= check(6, s9);
+    failed |= check(0, s10);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        *count += 11;
+        return 1;
+    }
+    s11 = 201;
+    s12 = 0;
+    s9 = s11;
+    s10 = s12;
+    failed = 0;
+    failed |= check(6, s8);
+    failed |= check(-55, s9);
+    failed |= check(0, s10);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        *count += 11;
+        return 1;
+    }
+    s11 = 248;
+    s12 = 2;
+    s13 = s11;
+    if (s12 == 0) {
+        fprintf(stderr, "Division by zero!\n");
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        *count += 14;
+        return 2;
+    }
+    s12 = (uint8_t)((uint32_t)s13 / s12);
+    s13 = 2;
+    s14 = 8;
+    s14 = (uint8_t)-s14;
+    if (s13 == 0) {
+        fprintf(stderr, "Division by zero!\n");
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        *count += 15;
+        return 2;
+    }
+    s13 = (uint8_t)((uint32_t)s14 / s13);
+    failed = 0;
+    failed |= check(124, s12);
+    failed |= check(124, s13);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        *count += 14;
+        return 1;
+    }
+    s14 = 3;
+    s15 = 100;
+    s15 = (uint8_t)-s15;
+    if (s14 == 0) {
+        fprintf(stderr, "Division by zero!\n");
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        top[15] = s15;
+        *count += 16;
+        return 2;
+    }
+    s14 = (uint8_t)((uint32_t)s15 / s14);
+    s15 = (s14 & 0x80) ? 0xFF : 0;
+    s16 = 0;
+    s17 = 44;
+    s16 = (uint8_t)((uint32_t)s17 * s16);
+    s17 = (s16 & 0x80) ? 0xFF : 0;
+    SET16(s16, s17, GET16(s16, s17) + 1000);
+    s18 = 232;
+    s19 = (s18 & 0x80) ? 0xFF : 0;
+    SET16(s16, s17, GET16(s18, s19) - GET16(s16, s17));
+    s18 = 50;
+    s19 = (s18 & 0x80) ? 0xFF : 0;
+    failed = 0;
+    failed |= check(52, s14);
+    failed |= check(0, s15);
+    failed |= check(0, s16);
+    failed |= check(-4, s17);
+    failed |= check(50, s18);
+    failed |= check(0, s19);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        top[15] = s15;
+        top[16] = s16;
+        top[17] = s17;
+        top[18] = s18;
+        top[19] = s19;
+        *count += 20;
+        return 1;
+    }
+    top[0] = s0;
+    top[1] = s1;
+    top[2] = s2;
+    top[3] = s3;
+    top[4] = s4;
+    top[5] = s5;
+    top[6] = s6;
+    top[7] = s7;
+    top[8] = s8;
+    top[9] = s9;
+    top[10] = s10;
+    top[11] = s11;
+    top[12] = s12;
+    top[13] = s13;
+    top[14] = s14;
+    top[15] = s15;
+    top[16] = s16;
+    top[17] = s17;
+    top[18] = s18;
+    top[19] = s19;
+    *count += 20;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[21];
+    uint32_t count = 0;
+    return shabby_folding(stack, &count);
+}
+#endif
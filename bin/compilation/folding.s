@@ -0,0 +1,559 @@
+@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's
+    .syntax unified
+    .cpu cortex-m0
+    .thumb
+    .text
+
+@ int shabby_folding(uint8_t* stack, uint32_t* count)
+@ appends what the program leaves on the exec stack, which needs room for 20 more bytes,
+@ 0 when it finished and 1 when a test failed
+    .global shabby_folding
+    .thumb_func
+shabby_folding:
+    push {r4, r5, r6, r7, lr}
+    ldr r2, [r1]
+    adds r4, r0, r2
+    mov r6, r1
+    movs r0, #10
+    strb r0, [r4, #0]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #10
+    beq .L1
+    movs r5, #1
+.L1:
+    cmp r5, #0
+    beq .L0
+    ldr r0, [r6]
+    movs r1, #1
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L0:
+    movs r0, #141
+    strb r0, [r4, #1]
+    movs r0, #19
+    strb r0, [r4, #2]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #10
+    beq .L3
+    movs r5, #1
+.L3:
+    ldrb r0, [r4, #1]
+    cmp r0, #141
+    beq .L4
+    movs r5, #1
+.L4:
+    ldrb r0, [r4, #2]
+    cmp r0, #19
+    beq .L5
+    movs r5, #1
+.L5:
+    cmp r5, #0
+    beq .L2
+    ldr r0, [r6]
+    movs r1, #3
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L2:
+    movs r0, #251
+    strb r0, [r4, #3]
+    movs r5, #0
+    ldrb r0, [r4, #1]
+    cmp r0, #141
+    beq .L7
+    movs r5, #1
+.L7:
+    ldrb r0, [r4, #2]
+    cmp r0, #19
+    beq .L8
+    movs r5, #1
+.L8:
+    ldrb r0, [r4, #3]
+    cmp r0, #251
+    beq .L9
+    movs r5, #1
+.L9:
+    cmp r5, #0
+    beq .L6
+    ldr r0, [r6]
+    movs r1, #4
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L6:
+    ldrb r0, [r4, #0]
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #251
+    beq .L11
+    movs r5, #1
+.L11:
+    ldrb r0, [r4, #4]
+    cmp r0, #10
+    beq .L12
+    movs r5, #1
+.L12:
+    cmp r5, #0
+    beq .L10
+    ldr r0, [r6]
+    movs r1, #5
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L10:
+    ldrb r0, [r4, #0]
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #0]
+    ldrb r1, [r4, #5]
+    adds r0, r0, r1
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #251
+    beq .L14
+    movs r5, #1
+.L14:
+    ldrb r0, [r4, #4]
+    cmp r0, #20
+    beq .L15
+    movs r5, #1
+.L15:
+    cmp r5, #0
+    beq .L13
+    ldr r0, [r6]
+    movs r1, #5
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L13:
+    movs r0, #2
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #4]
+    movs r0, #3
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #4]
+    ldrb r1, [r4, #5]
+    adds r0, r0, r1
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #251
+    beq .L17
+    movs r5, #1
+.L17:
+    ldrb r0, [r4, #4]
+    cmp r0, #5
+    beq .L18
+    movs r5, #1
+.L18:
+    cmp r5, #0
+    beq .L16
+    ldr r0, [r6]
+    movs r1, #5
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L16:
+    movs r0, #0
+    strb r0, [r4, #5]
+    movs r0, #4
+    strb r0, [r4, #6]
+    ldrb r0, [r4, #5]
+    ldrb r1, [r4, #6]
+    adds r0, r0, r1
+    strb r0, [r4, #6]
+    ldrb r0, [r4, #6]
+    strb r0, [r4, #5]
+    movs r5, #0
+    ldrb r0, [r4, #4]
+    cmp r0, #5
+    beq .L20
+    movs r5, #1
+.L20:
+    ldrb r0, [r4, #5]
+    cmp r0, #4
+    beq .L21
+    movs r5, #1
+.L21:
+    cmp r5, #0
+    beq .L19
+    ldr r0, [r6]
+    movs r1, #6
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L19:
+    movs r0, #0
+    strb r0, [r4, #6]
+    ldrb r0, [r4, #6]
+    adds r0, #44
+    strb r0, [r4, #6]
+    ldrb r0, [r4, #6]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #7]
+    movs r5, #0
+    ldrb r0, [r4, #5]
+    cmp r0, #4
+    beq .L23
+    movs r5, #1
+.L23:
+    ldrb r0, [r4, #6]
+    cmp r0, #44
+    beq .L24
+    movs r5, #1
+.L24:
+    ldrb r0, [r4, #7]
+    cmp r0, #0
+    beq .L25
+    movs r5, #1
+.L25:
+    cmp r5, #0
+    beq .L22
+    ldr r0, [r6]
+    movs r1, #8
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L22:
+    movs r0, #0
+    strb r0, [r4, #8]
+    movs r0, #0
+    strb r0, [r4, #9]
+    movs r0, #0
+    strb r0, [r4, #10]
+    movs r0, #101
+    strb r0, [r4, #11]
+    movs r0, #0
+    strb r0, [r4, #12]
+    movs r0, #8
+    strb r0, [r4, #13]
+    movs r0, #0
+    strb r0, [r4, #14]
+    movs r0, #6
+    strb r0, [r4, #11]
+    ldrb r0, [r4, #11]
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #11]
+    ldrb r0, [r4, #11]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #12]
+    ldrb r0, [r4, #11]
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #12]
+    strb r0, [r4, #10]
+    movs r5, #0
+    ldrb r0, [r4, #6]
+    cmp r0, #44
+    beq .L27
+    movs r5, #1
+.L27:
+    ldrb r0, [r4, #7]
+    cmp r0, #0
+    beq .L28
+    movs r5, #1
+.L28:
+    ldrb r0, [r4, #8]
+    cmp r0, #6
+    beq .L29
+    movs r5, #1
+.L29:
+    ldrb r0, [r4, #9]
+    cmp r0, #6
+    beq .L30
+    movs r5, #1
+.L30:
+    ldrb r0, [r4, #10]
+    cmp r0, #0
+    beq .L31
+    movs r5, #1
+.L31:
+    cmp r5, #0
+    beq .L26
+    ldr r0, [r6]
+    movs r1, #11
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L26:
+    movs r5, #0
+    ldrb r0, [r4, #6]
+    cmp r0, #44
+    beq .L33
+    movs r5, #1
+.L33:
+    ldrb r0, [r4, #7]
+    cmp r0, #0
+    beq .L34
+    movs r5, #1
+.L34:
+    ldrb r0, [r4, #8]
+    cmp r0, #6
+    beq .L35
+    movs r5, #1
+.L35:
+    ldrb r0, [r4, #9]
+    cmp r0, #6
+    beq .L36
+    movs r5, #1
+.L36:
+    ldrb r0, [r4, #10]
+    cmp r0, #0
+    beq .L37
+    movs r5, #1
+.L37:
+    cmp r5, #0
+    beq .L32
+    ldr r0, [r6]
+    movs r1, #11
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L32:
+    movs r0, #201
+    strb r0, [r4, #11]
+    movs r0, #0
+    strb r0, [r4, #12]
+    ldrb r0, [r4, #11]
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #12]
+    strb r0, [r4, #10]
+    movs r5, #0
+    ldrb r0, [r4, #8]
+    cmp r0, #6
+    beq .L39
+    movs r5, #1
+.L39:
+    ldrb r0, [r4, #9]
+    cmp r0, #201
+    beq .L40
+    movs r5, #1
+.L40:
+    ldrb r0, [r4, #10]
+    cmp r0, #0
+    beq .L41
+    movs r5, #1
+.L41:
+    cmp r5, #0
+    beq .L38
+    ldr r0, [r6]
+    movs r1, #11
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L38:
+    movs r0, #248
+    strb r0, [r4, #11]
+    movs r0, #2
+    strb r0, [r4, #12]
+    ldrb r0, [r4, #11]
+    strb r0, [r4, #13]
+    ldrb r0, [r4, #13]
+    ldrb r1, [r4, #12]
+    bl .Ldivide
+    strb r0, [r4, #12]
+    movs r0, #2
+    strb r0, [r4, #13]
+    movs r0, #8
+    strb r0, [r4, #14]
+    ldrb r0, [r4, #14]
+    rsbs r0, r0, #0
+    strb r0, [r4, #14]
+    ldrb r0, [r4, #14]
+    ldrb r1, [r4, #13]
+    bl .Ldivide
+    strb r0, [r4, #13]
+    movs r5, #0
+    ldrb r0, [r4, #12]
+    cmp r0, #124
+    beq .L43
+    movs r5, #1
+.L43:
+    ldrb r0, [r4, #13]
+    cmp r0, #124
+    beq .L44
+    movs r5, #1
+.L44:
+    cmp r5, #0
+    beq .L42
+    ldr r0, [r6]
+    movs r1, #14
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L42:
+    movs r0, #3
+    strb r0, [r4, #14]
+    movs r0, #100
+    strb r0, [r4, #15]
+    ldrb r0, [r4, #15]
+    rsbs r0, r0, #0
+    strb r0, [r4, #15]
+    ldrb r0, [r4, #15]
+    ldrb r1, [r4, #14]
+    bl .Ldivide
+    strb r0, [r4, #14]
+    ldrb r0, [r4, #14]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #15]
+    movs r0, #0
+    strb r0, [r4, #16]
+    movs r0, #44
+    strb r0, [r4, #17]
+    ldrb r0, [r4, #17]
+    ldrb r1, [r4, #16]
+    muls r0, r1, r0
+    strb r0, [r4, #16]
+    ldrb r0, [r4, #16]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #17]
+    ldrb r0, [r4, #16]
+    ldrb r2, [r4, #17]
+    lsls r2, r2, #8
+    orrs r0, r2
+    movs r1, #3
+    lsls r1, r1, #8
+    adds r1, #232
+    adds r0, r0, r1
+    strb r0, [r4, #16]
+    lsrs r0, r0, #8
+    strb r0, [r4, #17]
+    movs r0, #232
+    strb r0, [r4, #18]
+    ldrb r0, [r4, #18]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #19]
+    ldrb r0, [r4, #18]
+    ldrb r2, [r4, #19]
+    lsls r2, r2, #8
+    orrs r0, r2
+    ldrb r1, [r4, #16]
+    ldrb r3, [r4, #17]
+    lsls r3, r3, #8
+    orrs r1, r3
+    subs r0, r0, r1
+    strb r0, [r4, #16]
+    lsrs r0, r0, #8
+    strb r0, [r4, #17]
+    movs r0, #50
+    strb r0, [r4, #18]
+    ldrb r0, [r4, #18]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #19]
+    movs r5, #0
+    ldrb r0, [r4, #14]
+    cmp r0, #52
+    beq .L46
+    movs r5, #1
+.L46:
+    ldrb r0, [r4, #15]
+    cmp r0, #0
+    beq .L47
+    movs r5, #1
+.L47:
+    ldrb r0, [r4, #16]
+    cmp r0, #0
+    beq .L48
+    movs r5, #1
+.L48:
+    ldrb r0, [r4, #17]
+    cmp r0, #252
+    beq .L49
+    movs r5, #1
+.L49:
+    ldrb r0, [r4, #18]
+    cmp r0, #50
+    beq .L50
+    movs r5, #1
+.L50:
+    ldrb r0, [r4, #19]
+    cmp r0, #0
+    beq .L51
+    movs r5, #1
+.L51:
+    cmp r5, #0
+    beq .L45
+    ldr r0, [r6]
+    movs r1, #20
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L45:
+    ldr r0, [r6]
+    movs r1, #20
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #0
+    pop {r4, r5, r6, r7, pc}
+
+    .thumb_func
+.Ldivide:
+    cmp r1, #0
+    bne .Ldivide_start
+    udf #0
+.Ldivide_start:
+    movs r2, #0
+    movs r3, #1
+.Ldivide_align:
+    cmp r1, r0
+    bhs .Ldivide_subtract
+    lsls r1, r1, #1
+    lsls r3, r3, #1
+    b .Ldivide_align
+.Ldivide_subtract:
+    cmp r0, r1
+    blo .Ldivide_next
+    subs r0, r0, r1
+    orrs r2, r3
+.Ldivide_next:
+    lsrs r1, r1, #1
+    lsrs r3, r3, #1
+    bne .Ldivide_subtract
+    movs r0, r2
+    bx lr
+
+.ifdef SHABBY_MAIN
+    .global _start
+    .thumb_func
+_start:
+    ldr r0, =.Lstack
+    ldr r1, =.Lcount
+    bl shabby_folding
+    movs r7, #1
+    svc #0
+    .ltorg
+    .bss
+    .balign 4
+.Lcount:
+    .space 4
+.Lstack:
+    .space 21
+.endif
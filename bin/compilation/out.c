@@ -0,0 +1,278 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 19 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_out(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    uint8_t s8 = 0, s9 = 0, s10 = 0, s11 = 0, s12 = 0, s13 = 0, s14 = 0, s15 = 0;
+    uint8_t s16 = 0, s17 = 0, s18 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2; (void)s3; (void)s4; (void)s5; (void)s6; (void)s7;
+    (void)s8; (void)s9; (void)s10; (void)s11; (void)s12; (void)s13; (void)s14; (void)s15;
+    (void)s16; (void)s17; (void)s18;
+    s0 = 0;
+    s1 = 0;
+    failed = 0;
+    failed |= check(0, s0);
+    failed |= check(0, s1);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        *count += 2;
+        return 1;
+    }
+    s2 = 1;
+    s3 = 1;
+    failed = 0;
+    failed |= check(0, s0);
+    failed |= check(0, s1);
+    failed |= check(1, s2);
+    failed |= check(1, s3);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        *count += 4;
+        return 1;
+    }
+    s4 = 255;
+    s5 = (s4 & 0x80) ? 0xFF : 0;
+    failed = 0;
+    failed |= check(1, s2);
+    failed |= check(1, s3);
+    failed |= check(-1, s4);
+    failed |= check(-1, s5);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        *count += 6;
+        return 1;
+    }
+    s6 = 1;
+    s7 = 1;
+    s7 = (s6 & 0x80) ? 0xFF : 0;
+    failed = 0;
+    failed |= check(-1, s4);
+    failed |= check(-1, s5);
+    failed |= check(1, s6);
+    failed |= check(0, s7);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        *count += 8;
+        return 1;
+    }
+    s8 = s4;
+    s9 = s5;
+    SET16(s8, s9, GET16(s2, s3) + GET16(s8, s9));
+    failed = 0;
+    failed |= check(1, s6);
+    failed |= check(0, s7);
+    failed |= check(0, s8);
+    failed |= check(1, s9);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        *count += 10;
+        return 1;
+    }
+    s10 = 255;
+    s11 = 127;
+    failed = 0;
+    failed |= check(0, s8);
+    failed |= check(1, s9);
+    failed |= check(-1, s10);
+    failed |= check(127, s11);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        *count += 12;
+        return 1;
+    }
+    s12 = 254;
+    s13 = (s12 & 0x80) ? 0xFF : 0;
+    SET16(s12, s13, GET16(s10, s11) * GET16(s12, s13));
+    failed = 0;
+    failed |= check(-1, s10);
+    failed |= check(127, s11);
+    failed |= check(2, s12);
+    failed |= check(0, s13);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        *count += 14;
+        return 1;
+    }
+    s14 = 16;
+    s15 = 32;
+    s16 = (s15 & 0x80) ? 0xFF : 0;
+    s17 = 2;
+    s18 = s14;
+    if (s17 == 0) {
+        fprintf(stderr, "Division by zero!\n");
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        top[15] = s15;
+        top[16] = s16;
+        top[17] = s17;
+        top[18] = s18;
+        *count += 19;
+        return 2;
+    }
+    s17 = (uint8_t)((uint32_t)s18 / s17);
+    s18 = (s17 & 0x80) ? 0xFF : 0;
+    SET16(s15, s16, GET16(s17, s18) * GET16(s15, s16));
+    failed = 0;
+    failed |= check(0, s13);
+    failed |= check(16, s14);
+    failed |= check(0, s15);
+    failed |= check(1, s16);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        top[15] = s15;
+        top[16] = s16;
+        *count += 17;
+        return 1;
+    }
+    s17 = 0;
+    s18 = 1;
+    failed = 0;
+    failed |= check(0, s15);
+    failed |= check(1, s16);
+    failed |= check(0, s17);
+    failed |= check(1, s18);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        top[11] = s11;
+        top[12] = s12;
+        top[13] = s13;
+        top[14] = s14;
+        top[15] = s15;
+        top[16] = s16;
+        top[17] = s17;
+        top[18] = s18;
+        *count += 19;
+        return 1;
+    }
+    top[0] = s0;
+    top[1] = s1;
+    top[2] = s2;
+    top[3] = s3;
+    top[4] = s4;
+    top[5] = s5;
+    top[6] = s6;
+    top[7] = s7;
+    top[8] = s8;
+    top[9] = s9;
+    top[10] = s10;
+    top[11] = s11;
+    top[12] = s12;
+    top[13] = s13;
+    top[14] = s14;
+    top[15] = s15;
+    top[16] = s16;
+    top[17] = s17;
+    top[18] = s18;
+    *count += 19;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[20];
+    uint32_t count = 0;
+    return shabby_out(stack, &count);
+}
+#endif
@@ -0,0 +1,422 @@
+@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's
+    .syntax unified
+    .cpu cortex-m0
+    .thumb
+    .text
+
+@ int shabby_out(uint8_t* stack, uint32_t* count)
+@ appends what the program leaves on the exec stack, which needs room for 19 more bytes,
+@ 0 when it finished and 1 when a test failed
+    .global shabby_out
+    .thumb_func
+shabby_out:
+    push {r4, r5, r6, r7, lr}
+    ldr r2, [r1]
+    adds r4, r0, r2
+    mov r6, r1
+    movs r0, #0
+    strb r0, [r4, #0]
+    movs r0, #0
+    strb r0, [r4, #1]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #0
+    beq .L1
+    movs r5, #1
+.L1:
+    ldrb r0, [r4, #1]
+    cmp r0, #0
+    beq .L2
+    movs r5, #1
+.L2:
+    cmp r5, #0
+    beq .L0
+    ldr r0, [r6]
+    movs r1, #2
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L0:
+    movs r0, #1
+    strb r0, [r4, #2]
+    movs r0, #1
+    strb r0, [r4, #3]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #0
+    beq .L4
+    movs r5, #1
+.L4:
+    ldrb r0, [r4, #1]
+    cmp r0, #0
+    beq .L5
+    movs r5, #1
+.L5:
+    ldrb r0, [r4, #2]
+    cmp r0, #1
+    beq .L6
+    movs r5, #1
+.L6:
+    ldrb r0, [r4, #3]
+    cmp r0, #1
+    beq .L7
+    movs r5, #1
+.L7:
+    cmp r5, #0
+    beq .L3
+    ldr r0, [r6]
+    movs r1, #4
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L3:
+    movs r0, #255
+    strb r0, [r4, #4]
+    ldrb r0, [r4, #4]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #5]
+    movs r5, #0
+    ldrb r0, [r4, #2]
+    cmp r0, #1
+    beq .L9
+    movs r5, #1
+.L9:
+    ldrb r0, [r4, #3]
+    cmp r0, #1
+    beq .L10
+    movs r5, #1
+.L10:
+    ldrb r0, [r4, #4]
+    cmp r0, #255
+    beq .L11
+    movs r5, #1
+.L11:
+    ldrb r0, [r4, #5]
+    cmp r0, #255
+    beq .L12
+    movs r5, #1
+.L12:
+    cmp r5, #0
+    beq .L8
+    ldr r0, [r6]
+    movs r1, #6
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L8:
+    movs r0, #1
+    strb r0, [r4, #6]
+    movs r0, #1
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #6]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #7]
+    movs r5, #0
+    ldrb r0, [r4, #4]
+    cmp r0, #255
+    beq .L14
+    movs r5, #1
+.L14:
+    ldrb r0, [r4, #5]
+    cmp r0, #255
+    beq .L15
+    movs r5, #1
+.L15:
+    ldrb r0, [r4, #6]
+    cmp r0, #1
+    beq .L16
+    movs r5, #1
+.L16:
+    ldrb r0, [r4, #7]
+    cmp r0, #0
+    beq .L17
+    movs r5, #1
+.L17:
+    cmp r5, #0
+    beq .L13
+    ldr r0, [r6]
+    movs r1, #8
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L13:
+    ldrb r0, [r4, #4]
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #5]
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #2]
+    ldrb r2, [r4, #3]
+    lsls r2, r2, #8
+    orrs r0, r2
+    ldrb r1, [r4, #8]
+    ldrb r3, [r4, #9]
+    lsls r3, r3, #8
+    orrs r1, r3
+    adds r0, r0, r1
+    strb r0, [r4, #8]
+    lsrs r0, r0, #8
+    strb r0, [r4, #9]
+    movs r5, #0
+    ldrb r0, [r4, #6]
+    cmp r0, #1
+    beq .L19
+    movs r5, #1
+.L19:
+    ldrb r0, [r4, #7]
+    cmp r0, #0
+    beq .L20
+    movs r5, #1
+.L20:
+    ldrb r0, [r4, #8]
+    cmp r0, #0
+    beq .L21
+    movs r5, #1
+.L21:
+    ldrb r0, [r4, #9]
+    cmp r0, #1
+    beq .L22
+    movs r5, #1
+.L22:
+    cmp r5, #0
+    beq .L18
+    ldr r0, [r6]
+    movs r1, #10
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L18:
+    movs r0, #255
+    strb r0, [r4, #10]
+    movs r0, #127
+    strb r0, [r4, #11]
+    movs r5, #0
+    ldrb r0, [r4, #8]
+    cmp r0, #0
+    beq .L24
+    movs r5, #1
+.L24:
+    ldrb r0, [r4, #9]
+    cmp r0, #1
+    beq .L25
+    movs r5, #1
+.L25:
+    ldrb r0, [r4, #10]
+    cmp r0, #255
+    beq .L26
+    movs r5, #1
+.L26:
+    ldrb r0, [r4, #11]
+    cmp r0, #127
+    beq .L27
+    movs r5, #1
+.L27:
+    cmp r5, #0
+    beq .L23
+    ldr r0, [r6]
+    movs r1, #12
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L23:
+    movs r0, #254
+    strb r0, [r4, #12]
+    ldrb r0, [r4, #12]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #13]
+    ldrb r0, [r4, #10]
+    ldrb r2, [r4, #11]
+    lsls r2, r2, #8
+    orrs r0, r2
+    ldrb r1, [r4, #12]
+    ldrb r3, [r4, #13]
+    lsls r3, r3, #8
+    orrs r1, r3
+    muls r0, r1, r0
+    strb r0, [r4, #12]
+    lsrs r0, r0, #8
+    strb r0, [r4, #13]
+    movs r5, #0
+    ldrb r0, [r4, #10]
+    cmp r0, #255
+    beq .L29
+    movs r5, #1
+.L29:
+    ldrb r0, [r4, #11]
+    cmp r0, #127
+    beq .L30
+    movs r5, #1
+.L30:
+    ldrb r0, [r4, #12]
+    cmp r0, #2
+    beq .L31
+    movs r5, #1
+.L31:
+    ldrb r0, [r4, #13]
+    cmp r0, #0
+    beq .L32
+    movs r5, #1
+.L32:
+    cmp r5, #0
+    beq .L28
+    ldr r0, [r6]
+    movs r1, #14
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L28:
+    movs r0, #16
+    strb r0, [r4, #14]
+    movs r0, #32
+    strb r0, [r4, #15]
+    ldrb r0, [r4, #15]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #16]
+    movs r0, #2
+    strb r0, [r4, #17]
+    ldrb r0, [r4, #14]
+    strb r0, [r4, #18]
+    ldrb r0, [r4, #18]
+    ldrb r1, [r4, #17]
+    bl .Ldivide
+    strb r0, [r4, #17]
+    ldrb r0, [r4, #17]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #18]
+    ldrb r0, [r4, #17]
+    ldrb r2, [r4, #18]
+    lsls r2, r2, #8
+    orrs r0, r2
+    ldrb r1, [r4, #15]
+    ldrb r3, [r4, #16]
+    lsls r3, r3, #8
+    orrs r1, r3
+    muls r0, r1, r0
+    strb r0, [r4, #15]
+    lsrs r0, r0, #8
+    strb r0, [r4, #16]
+    movs r5, #0
+    ldrb r0, [r4, #13]
+    cmp r0, #0
+    beq .L34
+    movs r5, #1
+.L34:
+    ldrb r0, [r4, #14]
+    cmp r0, #16
+    beq .L35
+    movs r5, #1
+.L35:
+    ldrb r0, [r4, #15]
+    cmp r0, #0
+    beq .L36
+    movs r5, #1
+.L36:
+    ldrb r0, [r4, #16]
+    cmp r0, #1
+    beq .L37
+    movs r5, #1
+.L37:
+    cmp r5, #0
+    beq .L33
+    ldr r0, [r6]
+    movs r1, #17
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L33:
+    movs r0, #0
+    strb r0, [r4, #17]
+    movs r0, #1
+    strb r0, [r4, #18]
+    movs r5, #0
+    ldrb r0, [r4, #15]
+    cmp r0, #0
+    beq .L39
+    movs r5, #1
+.L39:
+    ldrb r0, [r4, #16]
+    cmp r0, #1
+    beq .L40
+    movs r5, #1
+.L40:
+    ldrb r0, [r4, #17]
+    cmp r0, #0
+    beq .L41
+    movs r5, #1
+.L41:
+    ldrb r0, [r4, #18]
+    cmp r0, #1
+    beq .L42
+    movs r5, #1
+.L42:
+    cmp r5, #0
+    beq .L38
+    ldr r0, [r6]
+    movs r1, #19
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L38:
+    ldr r0, [r6]
+    movs r1, #19
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #0
+    pop {r4, r5, r6, r7, pc}
+
+    .thumb_func
+.Ldivide:
+    cmp r1, #0
+    bne .Ldivide_start
+    udf #0
+.Ldivide_start:
+    movs r2, #0
+    movs r3, #1
+.Ldivide_align:
+    cmp r1, r0
+    bhs .Ldivide_subtract
+    lsls r1, r1, #1
+    lsls r3, r3, #1
+    b .Ldivide_align
+.Ldivide_subtract:
+    cmp r0, r1
+    blo .Ldivide_next
+    subs r0, r0, r1
+    orrs r2, r3
+.Ldivide_next:
+    lsrs r1, r1, #1
+    lsrs r3, r3, #1
+    bne .Ldivide_subtract
+    movs r0, r2
+    bx lr
+
+.ifdef SHABBY_MAIN
+    .global _start
+    .thumb_func
+_start:
+    ldr r0, =.Lstack
+    ldr r1, =.Lcount
+    bl shabby_out
+    movs r7, #1
+    svc #0
+    .ltorg
+    .bss
+    .balign 4
+.Lcount:
+    .space 4
+.Lstack:
+    .space 20
+.endif
@@ -0,0 +1,258 @@
+// generated by shabbyc, the exec stack is little endian like the vm's
+#include <stdio.h>
+#include <stdint.h>
+
+#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)
+#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)
+
+static int check(int8_t expected, uint8_t got) {
+    if ((int8_t)got == expected) { return 0; }
+    fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", expected, (int8_t)got);
+    return 1;
+}
+
+// appends what the program leaves on the exec stack, which needs room for 11 more bytes,
+// 0 when it finished, 1 when a test failed and 2 when it divided by zero
+int shabby_short_assignment(uint8_t* stack, uint32_t* count) {
+    uint8_t* top = &stack[*count];
+    int failed = 0;
+    uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    uint8_t s8 = 0, s9 = 0, s10 = 0;
+    (void)check;
+    (void)failed;
+    (void)s0; (void)s1; (void)s2; (void)s3; (void)s4; (void)s5; (void)s6; (void)s7;
+    (void)s8; (void)s9; (void)s10;
+    s0 = 0;
+    s1 = 0;
+    s2 = 0;
+    s3 = 0;
+    s4 = 0;
+    s5 = 0;
+    s6 = 0;
+    failed = 0;
+    failed |= check(0, s0);
+    failed |= check(0, s1);
+    failed |= check(0, s2);
+    failed |= check(0, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    failed |= check(0, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 16;
+    s0 = s7;
+    s7 = 32;
+    s1 = s7;
+    s7 = 64;
+    s2 = s7;
+    failed = 0;
+    failed |= check(16, s0);
+    failed |= check(32, s1);
+    failed |= check(64, s2);
+    failed |= check(0, s3);
+    failed |= check(0, s4);
+    failed |= check(0, s5);
+    failed |= check(0, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 32;
+    s8 = (s7 & 0x80) ? 0xFF : 0;
+    s9 = 2;
+    s10 = s0;
+    if (s9 == 0) {
+        fprintf(stderr, "Division by zero!\n");
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        top[7] = s7;
+        top[8] = s8;
+        top[9] = s9;
+        top[10] = s10;
+        *count += 11;
+        return 2;
+    }
+    s9 = (uint8_t)((uint32_t)s10 / s9);
+    s10 = (s9 & 0x80) ? 0xFF : 0;
+    SET16(s7, s8, GET16(s9, s10) * GET16(s7, s8));
+    s3 = s7;
+    s4 = s8;
+    failed = 0;
+    failed |= check(0, s3);
+    failed |= check(1, s4);
+    failed |= check(0, s5);
+    failed |= check(0, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 0;
+    s8 = 1;
+    s5 = s7;
+    s6 = s8;
+    failed = 0;
+    failed |= check(0, s3);
+    failed |= check(1, s4);
+    failed |= check(0, s5);
+    failed |= check(1, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 1;
+    s8 = 1;
+    s3 = s7;
+    s4 = s8;
+    failed = 0;
+    failed |= check(1, s3);
+    failed |= check(1, s4);
+    failed |= check(0, s5);
+    failed |= check(1, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 255;
+    s8 = (s7 & 0x80) ? 0xFF : 0;
+    s5 = s7;
+    s6 = s8;
+    failed = 0;
+    failed |= check(1, s3);
+    failed |= check(1, s4);
+    failed |= check(-1, s5);
+    failed |= check(-1, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 1;
+    s8 = 1;
+    s8 = (s7 & 0x80) ? 0xFF : 0;
+    s3 = s7;
+    s4 = s8;
+    failed = 0;
+    failed |= check(1, s3);
+    failed |= check(0, s4);
+    failed |= check(-1, s5);
+    failed |= check(-1, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = s2;
+    s8 = (s7 & 0x80) ? 0xFF : 0;
+    s9 = s1;
+    s10 = (s9 & 0x80) ? 0xFF : 0;
+    SET16(s7, s8, GET16(s9, s10) + GET16(s7, s8));
+    s5 = s7;
+    s6 = s8;
+    failed = 0;
+    failed |= check(1, s3);
+    failed |= check(0, s4);
+    failed |= check(96, s5);
+    failed |= check(0, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    s7 = 255;
+    s8 = 127;
+    s3 = s7;
+    s4 = s8;
+    failed = 0;
+    failed |= check(-1, s3);
+    failed |= check(127, s4);
+    failed |= check(96, s5);
+    failed |= check(0, s6);
+    if (failed) {
+        top[0] = s0;
+        top[1] = s1;
+        top[2] = s2;
+        top[3] = s3;
+        top[4] = s4;
+        top[5] = s5;
+        top[6] = s6;
+        *count += 7;
+        return 1;
+    }
+    top[0] = s0;
+    top[1] = s1;
+    top[2] = s2;
+    top[3] = s3;
+    top[4] = s4;
+    top[5] = s5;
+    top[6] = s6;
+    *count += 7;
+    return 0;
+}
+
+#ifdef SHABBY_MAIN
+int main(void) {
+    static uint8_t stack[12];
+    uint32_t count = 0;
+    return shabby_short_assignment(stack, &count);
+}
+#endif
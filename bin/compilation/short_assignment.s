@@ -0,0 +1,500 @@
+@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's
+    .syntax unified
+    .cpu cortex-m0
+    .thumb
+    .text
+
+@ int shabby_short_assignment(uint8_t* stack, uint32_t* count)
+@ appends what the program leaves on the exec stack, which needs room for 11 more bytes,
+@ 0 when it finished and 1 when a test failed
+    .global shabby_short_assignment
+    .thumb_func
+shabby_short_assignment:
+    push {r4, r5, r6, r7, lr}
+    ldr r2, [r1]
+    adds r4, r0, r2
+    mov r6, r1
+    movs r0, #0
+    strb r0, [r4, #0]
+    movs r0, #0
+    strb r0, [r4, #1]
+    movs r0, #0
+    strb r0, [r4, #2]
+    movs r0, #0
+    strb r0, [r4, #3]
+    movs r0, #0
+    strb r0, [r4, #4]
+    movs r0, #0
+    strb r0, [r4, #5]
+    movs r0, #0
+    strb r0, [r4, #6]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #0
+    beq .L1
+    movs r5, #1
+.L1:
+    ldrb r0, [r4, #1]
+    cmp r0, #0
+    beq .L2
+    movs r5, #1
+.L2:
+    ldrb r0, [r4, #2]
+    cmp r0, #0
+    beq .L3
+    movs r5, #1
+.L3:
+    ldrb r0, [r4, #3]
+    cmp r0, #0
+    beq .L4
+    movs r5, #1
+.L4:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L5
+    movs r5, #1
+.L5:
+    ldrb r0, [r4, #5]
+    cmp r0, #0
+    beq .L6
+    movs r5, #1
+.L6:
+    ldrb r0, [r4, #6]
+    cmp r0, #0
+    beq .L7
+    movs r5, #1
+.L7:
+    cmp r5, #0
+    beq .L0
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L0:
+    movs r0, #16
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #0]
+    movs r0, #32
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #1]
+    movs r0, #64
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #2]
+    movs r5, #0
+    ldrb r0, [r4, #0]
+    cmp r0, #16
+    beq .L9
+    movs r5, #1
+.L9:
+    ldrb r0, [r4, #1]
+    cmp r0, #32
+    beq .L10
+    movs r5, #1
+.L10:
+    ldrb r0, [r4, #2]
+    cmp r0, #64
+    beq .L11
+    movs r5, #1
+.L11:
+    ldrb r0, [r4, #3]
+    cmp r0, #0
+    beq .L12
+    movs r5, #1
+.L12:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L13
+    movs r5, #1
+.L13:
+    ldrb r0, [r4, #5]
+    cmp r0, #0
+    beq .L14
+    movs r5, #1
+.L14:
+    ldrb r0, [r4, #6]
+    cmp r0, #0
+    beq .L15
+    movs r5, #1
+.L15:
+    cmp r5, #0
+    beq .L8
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L8:
+    movs r0, #32
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #8]
+    movs r0, #2
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #0]
+    strb r0, [r4, #10]
+    ldrb r0, [r4, #10]
+    ldrb r1, [r4, #9]
+    bl .Ldivide
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #9]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #10]
+    ldrb r0, [r4, #9]
+    ldrb r2, [r4, #10]
+    lsls r2, r2, #8
+    orrs r0, r2
+    ldrb r1, [r4, #7]
+    ldrb r3, [r4, #8]
+    lsls r3, r3, #8
+    orrs r1, r3
+    muls r0, r1, r0
+    strb r0, [r4, #7]
+    lsrs r0, r0, #8
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #3]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #0
+    beq .L17
+    movs r5, #1
+.L17:
+    ldrb r0, [r4, #4]
+    cmp r0, #1
+    beq .L18
+    movs r5, #1
+.L18:
+    ldrb r0, [r4, #5]
+    cmp r0, #0
+    beq .L19
+    movs r5, #1
+.L19:
+    ldrb r0, [r4, #6]
+    cmp r0, #0
+    beq .L20
+    movs r5, #1
+.L20:
+    cmp r5, #0
+    beq .L16
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L16:
+    movs r0, #0
+    strb r0, [r4, #7]
+    movs r0, #1
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #6]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #0
+    beq .L22
+    movs r5, #1
+.L22:
+    ldrb r0, [r4, #4]
+    cmp r0, #1
+    beq .L23
+    movs r5, #1
+.L23:
+    ldrb r0, [r4, #5]
+    cmp r0, #0
+    beq .L24
+    movs r5, #1
+.L24:
+    ldrb r0, [r4, #6]
+    cmp r0, #1
+    beq .L25
+    movs r5, #1
+.L25:
+    cmp r5, #0
+    beq .L21
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L21:
+    movs r0, #1
+    strb r0, [r4, #7]
+    movs r0, #1
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #3]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #1
+    beq .L27
+    movs r5, #1
+.L27:
+    ldrb r0, [r4, #4]
+    cmp r0, #1
+    beq .L28
+    movs r5, #1
+.L28:
+    ldrb r0, [r4, #5]
+    cmp r0, #0
+    beq .L29
+    movs r5, #1
+.L29:
+    ldrb r0, [r4, #6]
+    cmp r0, #1
+    beq .L30
+    movs r5, #1
+.L30:
+    cmp r5, #0
+    beq .L26
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L26:
+    movs r0, #255
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #6]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #1
+    beq .L32
+    movs r5, #1
+.L32:
+    ldrb r0, [r4, #4]
+    cmp r0, #1
+    beq .L33
+    movs r5, #1
+.L33:
+    ldrb r0, [r4, #5]
+    cmp r0, #255
+    beq .L34
+    movs r5, #1
+.L34:
+    ldrb r0, [r4, #6]
+    cmp r0, #255
+    beq .L35
+    movs r5, #1
+.L35:
+    cmp r5, #0
+    beq .L31
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L31:
+    movs r0, #1
+    strb r0, [r4, #7]
+    movs r0, #1
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #7]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #3]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #1
+    beq .L37
+    movs r5, #1
+.L37:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L38
+    movs r5, #1
+.L38:
+    ldrb r0, [r4, #5]
+    cmp r0, #255
+    beq .L39
+    movs r5, #1
+.L39:
+    ldrb r0, [r4, #6]
+    cmp r0, #255
+    beq .L40
+    movs r5, #1
+.L40:
+    cmp r5, #0
+    beq .L36
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L36:
+    ldrb r0, [r4, #2]
+    strb r0, [r4, #7]
+    ldrb r0, [r4, #7]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #1]
+    strb r0, [r4, #9]
+    ldrb r0, [r4, #9]
+    sxtb r0, r0
+    asrs r0, r0, #31
+    strb r0, [r4, #10]
+    ldrb r0, [r4, #9]
+    ldrb r2, [r4, #10]
+    lsls r2, r2, #8
+    orrs r0, r2
+    ldrb r1, [r4, #7]
+    ldrb r3, [r4, #8]
+    lsls r3, r3, #8
+    orrs r1, r3
+    adds r0, r0, r1
+    strb r0, [r4, #7]
+    lsrs r0, r0, #8
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #5]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #6]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #1
+    beq .L42
+    movs r5, #1
+.L42:
+    ldrb r0, [r4, #4]
+    cmp r0, #0
+    beq .L43
+    movs r5, #1
+.L43:
+    ldrb r0, [r4, #5]
+    cmp r0, #96
+    beq .L44
+    movs r5, #1
+.L44:
+    ldrb r0, [r4, #6]
+    cmp r0, #0
+    beq .L45
+    movs r5, #1
+.L45:
+    cmp r5, #0
+    beq .L41
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L41:
+    movs r0, #255
+    strb r0, [r4, #7]
+    movs r0, #127
+    strb r0, [r4, #8]
+    ldrb r0, [r4, #7]
+    strb r0, [r4, #3]
+    ldrb r0, [r4, #8]
+    strb r0, [r4, #4]
+    movs r5, #0
+    ldrb r0, [r4, #3]
+    cmp r0, #255
+    beq .L47
+    movs r5, #1
+.L47:
+    ldrb r0, [r4, #4]
+    cmp r0, #127
+    beq .L48
+    movs r5, #1
+.L48:
+    ldrb r0, [r4, #5]
+    cmp r0, #96
+    beq .L49
+    movs r5, #1
+.L49:
+    ldrb r0, [r4, #6]
+    cmp r0, #0
+    beq .L50
+    movs r5, #1
+.L50:
+    cmp r5, #0
+    beq .L46
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #1
+    pop {r4, r5, r6, r7, pc}
+.L46:
+    ldr r0, [r6]
+    movs r1, #7
+    adds r0, r0, r1
+    str r0, [r6]
+    movs r0, #0
+    pop {r4, r5, r6, r7, pc}
+
+    .thumb_func
+.Ldivide:
+    cmp r1, #0
+    bne .Ldivide_start
+    udf #0
+.Ldivide_start:
+    movs r2, #0
+    movs r3, #1
+.Ldivide_align:
+    cmp r1, r0
+    bhs .Ldivide_subtract
+    lsls r1, r1, #1
+    lsls r3, r3, #1
+    b .Ldivide_align
+.Ldivide_subtract:
+    cmp r0, r1
+    blo .Ldivide_next
+    subs r0, r0, r1
+    orrs r2, r3
+.Ldivide_next:
+    lsrs r1, r1, #1
+    lsrs r3, r3, #1
+    bne .Ldivide_subtract
+    movs r0, r2
+    bx lr
+
+.ifdef SHABBY_MAIN
+    .global _start
+    .thumb_func
+_start:
+    ldr r0, =.Lstack
+    ldr r1, =.Lcount
+    bl shabby_short_assignment
+    movs r7, #1
+    svc #0
+    .ltorg
+    .bss
+    .balign 4
+.Lcount:
+    .space 4
+.Lstack:
+    .space 12
+.endif
@@ -10,31 +10,35 @@ mkdir ../bin/compilation/
 
 set -e
 
+# RELEASE=1 compiles every stage without node names, bytecode names or tracing
+flags="-Wall -Wextra -Werror -Wpedantic"
+if [ -n "$RELEASE" ]; then flags="$flags -O2 -DSHABBY_RELEASE"; fi
+
 echo "#############"
 echo "# Tokenizer #"
 echo "#############"
-gcc tokenizer.c utils/symbols.c utils/file.c -I include -o "../bin/tokenizer" -Wall -Wextra -Werror -Wpedantic
+gcc tokenizer.c utils/symbols.c utils/file.c utils/trace.c utils/tokens.c utils/intern.c -I include -o "../bin/tokenizer" $flags
 if [ "$#" -eq 1 ]; then ../bin/tokenizer $src_file; fi
 
 echo ""
 echo "##########"
 echo "# Parser #"
 echo "##########"
-gcc parser.c utils/symbols.c utils/file.c utils/nodes.c -I include -o "../bin/parser" -Wall -Wextra -Werror -Wpedantic
+gcc parser.c utils/symbols.c utils/file.c utils/trace.c utils/nodes.c utils/tokens.c utils/intern.c -I include -o "../bin/parser" $flags
 if [ "$#" -eq 1 ]; then ../bin/parser $src_file; fi
 
 echo ""
 echo "##########"
 echo "# Symgen #"
 echo "##########"
-gcc symgen.c utils/symbols.c utils/file.c utils/nodes.c utils/types.c utils/variables.c -I include -o "../bin/symgen" -Wall -Wextra -Werror -Wpedantic
+gcc symgen.c utils/symbols.c utils/file.c utils/trace.c utils/nodes.c utils/types.c utils/variables.c utils/intern.c -I include -o "../bin/symgen" $flags
 if [ "$#" -eq 1 ]; then ../bin/symgen $src_file; fi
 
 echo ""
 echo "###############"
 echo "# Typechecker #"
 echo "###############"
-gcc typechecker.c utils/symbols.c utils/file.c utils/nodes.c utils/types.c utils/variables.c -I include -o "../bin/typec" -Wall -Wextra -Werror -Wpedantic
+gcc typechecker.c utils/symbols.c utils/file.c utils/trace.c utils/nodes.c utils/types.c utils/variables.c utils/intern.c -I include -o "../bin/typec" $flags
 if [ "$#" -eq 1 ]; then ../bin/typec $src_file; fi
 
 
@@ -45,7 +49,7 @@ if [ "$#" -eq 1 ]; then
     echo "#########"
     echo "# Graph #"
     echo "#########"
-    gcc graphviz.c utils/symbols.c utils/file.c utils/nodes.c -I include -o "../bin/graph" -Wall -Wextra -Werror -Wpedantic
+    gcc graphviz.c utils/symbols.c utils/file.c utils/trace.c utils/nodes.c -I include -o "../bin/graph" $flags
     ../bin/graph $src_file
     dot -Tpng ../bin/compilation/out.dot > ../bin/compilation/out.png
   fi
@@ -59,21 +63,51 @@ echo ""
 echo "###########"
 echo "# Codegen #"
 echo "###########"
-gcc codegen.c utils/symbols.c utils/file.c utils/nodes.c utils/types.c utils/variables.c -I include -o "../bin/codegen" -Wall -Wextra -Werror -Wpedantic
+gcc codegen.c utils/symbols.c utils/file.c utils/trace.c utils/nodes.c utils/types.c utils/variables.c utils/intern.c -I include -o "../bin/codegen" $flags
 if [ "$#" -eq 1 ]; then ../bin/codegen $src_file; fi
 
 echo ""
 echo "#################"
 echo "# Jump Resolver #"
 echo "#################"
-gcc jumpresolver.c utils/file.c -I include -o "../bin/jumpr" -Wall -Wextra -Werror -Wpedantic
+gcc jumpresolver.c utils/file.c utils/trace.c utils/image.c utils/verify.c -I include -o "../bin/jumpr" $flags
 if [ "$#" -eq 1 ]; then ../bin/jumpr $src_file; fi
 
 
+echo ""
+echo "############"
+echo "# Emitters #"
+echo "############"
+gcc emitc.c utils/file.c utils/trace.c utils/image.c utils/verify.c -I include -o "../bin/emitc" $flags
+if [ "$#" -eq 1 ]; then ../bin/emitc $src_file; fi
+gcc emitthumb.c utils/file.c utils/trace.c utils/image.c utils/verify.c -I include -o "../bin/emitthumb" $flags
+if [ "$#" -eq 1 ]; then ../bin/emitthumb $src_file; fi
+
 echo ""
 echo "######"
 echo "# VM #"
 echo "######"
-gcc vm.c utils/symbols.c utils/file.c -I include -o "../bin/vm" -Wall -Wextra -Werror -Wpedantic
+gcc vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c -I include -o "../bin/vm" $flags
+gcc vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c -I include -o "../bin/vm_switch" -DVM_SWITCH_DISPATCH $flags
+gcc vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c utils/rom.c -I include -o "../bin/vm_rom" -DSHABBY_CODE_IN_ROM $flags
 if [ "$#" -eq 1 ]; then ../bin/vm $src_file; fi
 
+echo ""
+echo "###########"
+echo "# Shabbyc #"
+echo "###########"
+gcc -DSHABBY_LIBRARY shabbyc.c tokenizer.c parser.c symgen.c typechecker.c codegen.c jumpresolver.c emitc.c emitthumb.c vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c utils/nodes.c utils/types.c utils/variables.c utils/intern.c utils/tokens.c -I include -o "../bin/shabbyc" -pthread $flags
+gcc -DSHABBY_LIBRARY shabbyc.c tokenizer.c parser.c symgen.c typechecker.c codegen.c jumpresolver.c emitc.c emitthumb.c vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c utils/nodes.c utils/types.c utils/variables.c utils/intern.c utils/tokens.c -I include -o "../bin/shabbyc_wide" -DSHABBY_WIDE -pthread $flags
+gcc -DSHABBY_LIBRARY shabbyc.c tokenizer.c parser.c symgen.c typechecker.c codegen.c jumpresolver.c emitc.c emitthumb.c vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c utils/nodes.c utils/types.c utils/variables.c utils/intern.c utils/tokens.c -I include -o "../bin/shabbyc_release" -O2 -DSHABBY_RELEASE -pthread $flags
+
+echo ""
+echo "##############"
+echo "# Shabby-run #"
+echo "##############"
+gcc -DSHABBY_LIBRARY shabbyrun.c vm.c jit.c utils/symbols.c utils/file.c utils/trace.c utils/image.c utils/verify.c -I include -o "../bin/shabby-run" -pthread $flags
+
+echo ""
+echo "##############"
+echo "# Thumb-run #"
+echo "##############"
+gcc thumbrun.c -I include -o "../bin/thumb-run" $flags
@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "stages.h"
+#include "tokens.h"
+
+// times the tokenizer over a generated multi megabyte source
+
+static const char* statements[] = {
+    "byte value_%u = %u;\n",
+    "short total_%u = (left_%u + right) * %u / scale;\n",
+    "\tcounter_%u = counter_%u - -%u;\n",
+    "class shape_%u {\n    byte width;\n    byte height_%u;\n}\n",
+    "$TEST %u 0 1 -%u;\n",
+    "    result = <byte> (a_%u*b_%u)+%u;\r\n",
+};
+
+int main(int argc, char *argv[]) {
+    size_t megabytes = (argc > 1) ? (size_t)atol(argv[1]) : 8;
+    long iterations = (argc > 2) ? atol(argv[2]) : 10;
+
+    // generate source with a few hundred distinct identifiers
+    size_t capacity = megabytes * 1024 * 1024;
+    uint8_t* src = malloc(capacity + 64);
+    assert(src != NULL);
+    size_t size = 0;
+    uint32_t n = 0;
+    while (size < capacity - 128) {
+        const char* statement = statements[n % (sizeof(statements) / sizeof(statements[0]))];
+        size += sprintf((char*)&src[size], statement, n % 397, n % 211, n % 256);
+        n++;
+    }
+    memset(&src[size], 0, 64);
+
+    token_array_s tokens = { 0 };
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < iterations; i++) {
+        tokens.count = 0;
+        tokenize_buffer(src, size, &tokens);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    double mb = (double)size * iterations / (1024 * 1024);
+    printf("%-24s %.1f MB, %u tokens, %.0f MB/s\n", argv[0], (double)size / (1024 * 1024), tokens.count, mb / seconds);
+
+    tokens_free(&tokens);
+    free(src);
+    return 0;
+}
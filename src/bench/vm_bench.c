@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+#include "vm.h"
+
+// times repeated runs of a compiled binary on one reused vm instance
+
+int main(int argc, char *argv[]) {
+    assert(argc >= 2);
+    long iterations = (argc > 2) ? atol(argv[2]) : 200000;
+
+    // the mapped image stays in memory so only the vm is measured
+    image_s image;
+    bool loaded = image_map(&image, argv[1]);
+    assert(loaded);
+    (void)loaded;
+    shabby_vm_t* instance = vm_create_image(&image);
+    assert(instance != NULL);
+    #ifdef VM_BENCH_JIT
+        bool native = vm_jit(instance);
+        assert(native);
+        (void)native;
+    #endif
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long i = 0; i < iterations; i++) {
+        vm_reset(instance);
+        vm_status_t status = vm_run(instance, VM_FUEL_MAX);
+        assert(status == VM_FINISHED);
+        (void)status;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%-12s %ld runs in %.3fs, %.0f ns/run\n", argv[0], iterations, seconds, seconds * 1e9 / iterations);
+
+    vm_destroy(instance);
+    image_unmap(&image);
+    return 0;
+}
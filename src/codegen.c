@@ -5,27 +5,27 @@
 #include <stdarg.h>
 #include "symbols.h"
 #include "file.h"
+#include "stages.h"
 #include "nodes.h"
 #include "bytecode.h"
 #include "types.h"
 #include "variables.h"
+#include "trace.h"
 
   ///////////////////
  // file pointers //
 ///////////////////
 
-static FILE *src_ptr = NULL; // source code
-static FILE *ast_ptr = NULL; // abstract syntax tree
-static FILE *gen_ptr = NULL; // output
+static thread_local FILE *src_ptr = NULL; // source code
+static thread_local ast_arena_s *ast_ptr = NULL; // abstract syntax tree
+static thread_local FILE *gen_ptr = NULL; // output
 
   //////////
  // misc //
 //////////
 
-static ast_s cur_node = { 0 };
-static ast_s peeked_node = { 0 };
-
-#define BIT_CLASS_END (1 << 15)
+static thread_local ast_s cur_node = { 0 };
+static thread_local ast_s peeked_node = { 0 };
 
 #define SIZE_BC(x) (x + cur_node.value_type - 1)
 
@@ -33,14 +33,9 @@ static ast_s peeked_node = { 0 };
  // token utilities //
 /////////////////////
 
-static char token[MAX_TOKEN_LEN+1];
-// TODO: consolidate
+static thread_local char token[MAX_TOKEN_LEN+1];
 static void read_token(void) {
-    int last_position = ftell(ast_ptr);
-    memset(token, NULL, MAX_TOKEN_LEN);
-    fgets(token, MAX_TOKEN_LEN, ast_ptr);
-    assert(strlen(token) < MAX_TOKEN_LEN);
-    fseek(ast_ptr, last_position + strlen(token) + 1, 0);
+    ast_peek_token(ast_ptr, token);
 }
 
   /////////////////////
@@ -48,7 +43,7 @@ static void read_token(void) {
 /////////////////////
 
 // TODO: remove me or consolidate with symgen
-static bool is_class_member(uint16_t offset) {
+static bool is_class_member(addr_t offset) {
     // search up
     while (offset != NULL) {
         // read current
@@ -61,6 +56,28 @@ static bool is_class_member(uint16_t offset) {
     return FALSE;
 }
 
+  ////////////////////////
+ // variable utilities //
+////////////////////////
+
+// does the expression read the variable at address
+static bool reads_address(addr_t offset, uint16_t address) {
+    if (offset == NULL) { return FALSE; }
+    ast_s node = { 0 };
+    ast_read_node(ast_ptr, offset, &node);
+    if (node.node_type == NT_VARIABLE) {
+        char variable_token[MAX_TOKEN_LEN+1];
+        ast_peek_token(ast_ptr, variable_token);
+        var_s* var = get_variable(variable_token);
+        assert(var != NULL);
+        return var->address == address;
+    }
+    for (uint8_t i = 0; i < node_constants[node.node_type].child_count; i++) {
+        if (reads_address(node.children[i], address)) { return TRUE; }
+    }
+    return FALSE;
+}
+
   ////////////////////////////
  // scheduled future nodes //
 ////////////////////////////
@@ -73,13 +90,13 @@ typedef enum {
 
 typedef struct {
     future_info_t type;
-    uint16_t data;
+    addr_t data;
 } future_info_s;
 
-static future_info_s future_stack[FUTURE_STACK_SIZE] = { 0 };
-static uint16_t future_stack_count = 0;
+static thread_local future_info_s future_stack[FUTURE_STACK_SIZE] = { 0 };
+static thread_local uint16_t future_stack_count = 0;
 
-static void future_push_offset(uint16_t offset) {
+static void future_push_offset(addr_t offset) {
     if (offset == NULL) { return; }
     future_stack[future_stack_count].type = FUTURE_OFFSET;
     future_stack[future_stack_count].data = offset;
@@ -94,7 +111,7 @@ static void future_push_bytecode(bytecode_t bc) {
     assert(future_stack_count < FUTURE_STACK_SIZE);
 }
 
-static void future_push_class_end(uint16_t offset) {
+static void future_push_class_end(addr_t offset) {
     if (offset == NULL) { return; }
     future_stack[future_stack_count].type = FUTURE_CLASS_END;
     future_stack[future_stack_count].data = offset;
@@ -115,9 +132,7 @@ static future_info_s* future_pop(void) {
 static void output(bytecode_t type, ...) {
     // output type
     fputc(type, gen_ptr);
-    #ifdef DEBUG
-        printf("%s", bytecode[type].name);
-    #endif
+    TRACE(TRACE_STEPS, "%s", bytecode[type].name);
 
     // output params
     if (bytecode[type].params > 0) {
@@ -130,17 +145,14 @@ static void output(bytecode_t type, ...) {
                 case 0: break;
                 case 1: fputc((uint8_t)param, gen_ptr); break;
                 case 2: fput16((uint16_t)param, gen_ptr); break;
+                case 4: fput32((uint32_t)param, gen_ptr); break;
                 default: assert(FALSE);
             }
-            #ifdef DEBUG
-                printf(" %d", param);
-            #endif
+            TRACE(TRACE_STEPS, " %d", param);
         }
         va_end(args);
     }
-    #ifdef DEBUG
-        printf("\n");
-    #endif
+    TRACE(TRACE_STEPS, "\n");
 }
 
   /////////////////////
@@ -148,25 +160,25 @@ static void output(bytecode_t type, ...) {
 /////////////////////
 
 static void gen_test(void) {
-    uint16_t token_start = ftell(ast_ptr);
+    addr_t token_start = ast_ptr->position;
 
     // output start of test BC
     fputc(BC_TEST, gen_ptr);
 
     // count number of constants and output
-    uint8_t c = fgetc(ast_ptr);
+    uint8_t c = ast_getc(ast_ptr);
     uint16_t count = 0;
     while (c != NULL) {
         if (c == ' ') { count++; }
-        c = fgetc(ast_ptr);
+        c = ast_getc(ast_ptr);
     }
     fput16(count, gen_ptr);
 
     // output constants
     int8_t constant = 0;
     int8_t sign = 1;
-    fseek(ast_ptr, token_start, 0);
-    c = fgetc(ast_ptr);
+    ast_ptr->position = token_start;
+    c = ast_getc(ast_ptr);
     while (c != NULL) {
         if (c == ' ') {
             fputc(constant * sign, gen_ptr);
@@ -178,7 +190,7 @@ static void gen_test(void) {
              constant *= 10;
              constant += (c - '0');
          }
-        c = fgetc(ast_ptr);
+        c = ast_getc(ast_ptr);
     }
 }
 
@@ -236,8 +248,8 @@ static void gen_unary_op(void) {
 }
 
 static void gen_factor(void) {
-    uint16_t unary_op = cur_node.children[0];
-    uint16_t value = cur_node.children[1];
+    addr_t unary_op = cur_node.children[0];
+    addr_t value = cur_node.children[1];
     future_push_offset(unary_op);
     future_push_offset(value);
 }
@@ -252,9 +264,9 @@ static void gen_term_op(void) {
 }
 
 static void gen_term(void) {
-    uint16_t right_factor = cur_node.children[0];
-    uint16_t term_op = cur_node.children[1];
-    uint16_t left_factor = cur_node.children[2];
+    addr_t right_factor = cur_node.children[0];
+    addr_t term_op = cur_node.children[1];
+    addr_t left_factor = cur_node.children[2];
     future_push_offset(term_op);
     future_push_offset(left_factor);
     future_push_offset(right_factor);
@@ -270,14 +282,110 @@ static void gen_expression_op(void) {
 }
 
 static void gen_expression(void) {
-    uint16_t right_term = cur_node.children[0];
-    uint16_t expression_op = cur_node.children[1];
-    uint16_t left_term = cur_node.children[2];
+    addr_t right_term = cur_node.children[0];
+    addr_t expression_op = cur_node.children[1];
+    addr_t left_term = cur_node.children[2];
     future_push_offset(expression_op);
     future_push_offset(left_term);
     future_push_offset(right_term);
 }
 
+  ///////////////////
+ // slots backend //
+///////////////////
+
+backend_t gen_backend = BACKEND_STACK;
+
+// skip the nodes that only pass a value through
+static void slot_operand(addr_t offset, ast_s* node) {
+    while (TRUE) {
+        ast_read_node(ast_ptr, offset, node);
+        switch (node->node_type) {
+            case NT_EXPRESSION:
+            case NT_TERM:
+                if (node->children[1] != NULL) { return; }
+                offset = node->children[2];
+                break;
+            case NT_FACTOR:
+                if (node->children[0] != NULL) { return; }
+                offset = node->children[1];
+                break;
+            default: return;
+        }
+    }
+}
+
+// the frame slot of a plain variable of the given type
+static bool slot_address(addr_t offset, type_t type, uint16_t* address) {
+    ast_s node = { 0 };
+    slot_operand(offset, &node);
+    if (node.node_type != NT_VARIABLE || node.value_type != type) { return FALSE; }
+
+    char variable_token[MAX_TOKEN_LEN+1];
+    ast_peek_token(ast_ptr, variable_token);
+    var_s* var = get_variable(variable_token);
+    assert(var != NULL);
+    *address = var->address + ast_get_param(ast_ptr, NT_VARIABLE, node.offset, NTP_VARIABLE_ADDRESS);
+    return TRUE;
+}
+
+static bool slots_overlap(uint16_t a, uint16_t b, type_t type) {
+    return a < b + types[type].size && b < a + types[type].size;
+}
+
+// computes the expression into the slot at address with one slot op per operator,
+// after the first op writes there the other operands can't read it any more
+static bool gen_slot_expression(addr_t offset, type_t type, uint16_t address, bool emit) {
+    uint16_t left, right;
+    if (slot_address(offset, type, &left)) {
+        if (emit && left != address) { output(SIZE_BC(BC_SLOT_MOV8), address, left); }
+        return TRUE;
+    }
+
+    ast_s node = { 0 };
+    slot_operand(offset, &node);
+    if (node.node_type != NT_EXPRESSION && node.node_type != NT_TERM) { return FALSE; }
+    if (node.value_type != type) { return FALSE; }
+
+    ast_read_node(ast_ptr, node.children[1], &peeked_node);
+    read_token();
+    bytecode_t op = BC_NOOP;
+    switch (token[0]) {
+        case '+': op = SIZE_BC(BC_SLOT_ADD8); break;
+        case '-': op = SIZE_BC(BC_SLOT_SUB8); break;
+        case '*': op = SIZE_BC(BC_SLOT_MUL8); break;
+        case '/': op = SIZE_BC(BC_SLOT_DIV8); break;
+        default: assert(FALSE); break;
+    }
+
+    bool left_plain = slot_address(node.children[2], type, &left);
+    bool right_plain = slot_address(node.children[0], type, &right);
+    if (left_plain && right_plain) {
+        if (emit) { output(op, address, left, right); }
+        return TRUE;
+    }
+    // a = (...) op c
+    if (right_plain && !slots_overlap(right, address, type) && gen_slot_expression(node.children[2], type, address, emit)) {
+        if (emit) { output(op, address, address, right); }
+        return TRUE;
+    }
+    // a = b op (...)
+    if (left_plain && !slots_overlap(left, address, type) && gen_slot_expression(node.children[0], type, address, emit)) {
+        if (emit) { output(op, address, left, address); }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+// assignments the slot ops can compute in place, anything else goes through the stack
+static bool gen_slot_assignment(uint16_t address) {
+    type_t type = cur_node.value_type;
+    if (gen_backend != BACKEND_SLOTS || type == TYPE_USER_DEFINED) { return FALSE; }
+    if (!gen_slot_expression(cur_node.children[0], type, address, FALSE)) { return FALSE; }
+    gen_slot_expression(cur_node.children[0], type, address, TRUE);
+    return TRUE;
+}
+
 static void gen_assignment(void) {
     // variable identifier
     read_token();
@@ -287,6 +395,9 @@ static void gen_assignment(void) {
     // get address offset
     uint16_t address = var->address + ast_get_param(ast_ptr, NT_ASSIGNMENT, cur_node.offset, NTP_ASSIGNMENT_ADDRESS);
 
+    // the slots backend does math on plain variables in place
+    if (gen_slot_assignment(address)) { return; }
+
     // user types are handled differently: copy instead of set
     if (cur_node.value_type == TYPE_USER_DEFINED) {
         uint16_t user_type_size = ast_get_param(ast_ptr, NT_CLASS, var->user_type_offset, NTP_CLASS_BYTES);
@@ -300,7 +411,7 @@ static void gen_assignment(void) {
     }
 
     // schedule expression
-    uint16_t expression = cur_node.children[0];
+    addr_t expression = cur_node.children[0];
     future_push_offset(expression);
 }
 
@@ -309,11 +420,11 @@ static void gen_declaration(void) {
     read_token();
     type_t type = get_type(token);
     // resolve user type
-    uint16_t user_type_offset = NULL;
+    addr_t user_type_offset = NULL;
     if (type == TYPE_NONE) {
-        uint16_t return_to = ftell(ast_ptr);
+        addr_t return_to = ast_ptr->position;
         user_type_offset = get_user_type(ast_ptr, token, cur_node.offset);
-        fseek(ast_ptr, return_to, 0);
+        ast_ptr->position = return_to;
         type = TYPE_USER_DEFINED;
     }
     assert(type != TYPE_NONE);
@@ -325,8 +436,17 @@ static void gen_declaration(void) {
     read_token();
     uint16_t addr = store_variable(type, token, bytes, cur_node.offset, user_type_offset);
 
+    // the initial value is pushed right where the zeros would go, unless it reads them
+    bool class_member = is_class_member(cur_node.parent_offset);
+    bool initialized = cur_node.children[0] != NULL;
+    if (initialized && !class_member && type != TYPE_USER_DEFINED && !reads_address(cur_node.children[0], addr)) {
+        assert(bytes > 0 && bytes <= 2);
+        future_push_offset(cur_node.children[0]);
+        return;
+    }
+
     // allocate bytes
-    if (!is_class_member(cur_node.parent_offset)) {
+    if (!class_member) {
         switch (bytes) {
             case 0: assert(FALSE);
             case 1: output(BC_PUSH8, 0); break;
@@ -343,7 +463,7 @@ static void gen_declaration(void) {
     }
 
     // don't set anything if there is nothing to set
-    if (cur_node.children[0] == NULL) {
+    if (!initialized) {
         return;
     }
 
@@ -355,48 +475,49 @@ static void gen_declaration(void) {
     future_push_bytecode(SIZE_BC(BC_SET8));
 
     // schedule expression
-    uint16_t expression = cur_node.children[0];
+    addr_t expression = cur_node.children[0];
     future_push_offset(expression);
 }
 
 static void gen_statement(void) {
-    uint16_t next_statement = cur_node.children[0];
-    uint16_t this_statement = cur_node.children[1];
+    addr_t next_statement = cur_node.children[0];
+    addr_t this_statement = cur_node.children[1];
     future_push_offset(next_statement);
     future_push_offset(this_statement);
 }
 
 static void gen_class(void) {
     scope_increment();
+    output(BC_LAYOUT, cur_node.offset, ast_get_param(ast_ptr, NT_CLASS, cur_node.offset, NTP_CLASS_BYTES));
     output(BC_IJUMP, (BIT_CLASS_END | cur_node.offset));
     output(BC_LABEL, cur_node.offset);
     future_push_class_end(cur_node.offset);
     future_push_offset(cur_node.children[0]);
 }
 
-static void gen_class_end(uint16_t offset) {
+static void gen_class_end(addr_t offset) {
     scope_decrement();
     output(BC_RET);
     output(BC_LABEL, (BIT_CLASS_END | offset));
 }
 
-void gen(FILE* src_ptr_arg, FILE* ast_ptr_arg, FILE* gen_ptr_arg) {
-    #ifdef DEBUG
-        // print debug header
-        printf("\n");
-        printf("assembly\n");
-        printf("-------------------\n");
-    #endif
+void gen(FILE* src_ptr_arg, ast_arena_s* ast_ptr_arg, FILE* gen_ptr_arg) {
+    // print debug header
+    TRACE(TRACE_STAGES, "\n");
+    TRACE(TRACE_STAGES, "assembly\n");
+    TRACE(TRACE_STAGES, "-------------------\n");
 
     src_ptr = src_ptr_arg;
     ast_ptr = ast_ptr_arg;
     gen_ptr = gen_ptr_arg;
+    variables_clear();
 
     // move to root node
-    future_push_offset(fget16(ast_ptr));
+    ast_ptr->position = 0;
+    future_push_offset(ast_get_addr(ast_ptr));
 
-    int bail = 0;
-    while(future_stack_count > 0 && ++bail < 1000) {
+    size_t bail = 0;
+    while(future_stack_count > 0 && ++bail < BAIL_LIMIT(ast_ptr->size)) {
         future_info_s* cur_info = future_pop();
         switch (cur_info->type) {
             case FUTURE_CLASS_END: gen_class_end(cur_info->data); continue;
@@ -406,7 +527,7 @@ void gen(FILE* src_ptr_arg, FILE* ast_ptr_arg, FILE* gen_ptr_arg) {
 
         // navigate to offset and parse node
         ast_read_node(ast_ptr, cur_info->data, &cur_node);
-        printf("                %s:\n", node_constants[cur_node.node_type].name);
+        TRACE(TRACE_STEPS, "                %s:\n", node_constants[cur_node.node_type].name);
         switch(cur_node.node_type) {
             case NT_CLASS: gen_class(); break;
             case NT_STATEMENT: gen_statement(); break;
@@ -425,15 +546,17 @@ void gen(FILE* src_ptr_arg, FILE* ast_ptr_arg, FILE* gen_ptr_arg) {
             default: assert(FALSE); break;
        }
     }
-    assert(bail < 1000);
+    assert(bail < BAIL_LIMIT(ast_ptr->size));
 }
 
   //////////
  // main //
 //////////
 
+#ifndef SHABBY_LIBRARY
 int main(int argc, char *argv[]) {
     assert(argc == 2);
+    trace_level = TRACE_STEPS;
 
     char src_buffer[256] = { 0 };
     sprintf(src_buffer, "%s", argv[1]);
@@ -441,23 +564,21 @@ int main(int argc, char *argv[]) {
 
     char ast_buffer[256] = { 0 };
     sprintf(ast_buffer, "../bin/compilation/%s.ast", "out");
-    ast_ptr = fopen(ast_buffer, "rb");
+    FILE* ast_file_ptr = fopen(ast_buffer, "rb");
+    ast_arena_s ast = { 0 };
+    ast_arena_load(&ast, ast_file_ptr);
+    fclose(ast_file_ptr);
 
     char gen_buffer[256] = { 0 };
     sprintf(gen_buffer, "../bin/compilation/%s.gen", "out");
     gen_ptr = fopen(gen_buffer, "wb+");
 
-    gen(src_ptr, ast_ptr, gen_ptr);
+    gen(src_ptr, &ast, gen_ptr);
 
     fclose(src_ptr);
-    fclose(ast_ptr);
+    ast_arena_free(&ast);
     fclose(gen_ptr);
 
     return 0;
-
-    #ifdef DEBUG
-    // make pedantic compilers happy
-    node_constants[0] = node_constants[0];
-    types[0] = types[0];
-    #endif
 }
+#endif
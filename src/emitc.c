@@ -0,0 +1,401 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include "file.h"
+#include "stages.h"
+#include "bytecode.h"
+#include "image.h"
+#include "verify.h"
+#include "trace.h"
+
+// translates a verified image into one self-contained C function, verified code has no loops,
+// recursion or runtime jumps so every exec stack byte sits at a known offset and becomes a local,
+// calls are inlined and jumps are followed
+
+  ///////////////////
+ // file pointers //
+///////////////////
+
+static thread_local FILE *c_ptr = NULL; // c output
+
+  ///////////
+ // state //
+///////////
+
+static thread_local const uint8_t* code = NULL;
+
+// exec stack bytes pushed as constants, addresses are always pushed right before their use
+static thread_local bool* known = NULL;
+static thread_local uint8_t* values = NULL;
+static thread_local uint32_t local_count = 0;
+
+static uint16_t operand16(const uint8_t* at) {
+    return (at[0] << 8) | at[1];
+}
+
+static addr_t operand_addr(const uint8_t* at) {
+    #ifdef SHABBY_WIDE
+        return ((addr_t)operand16(at) << 16) | operand16(&at[2]);
+    #else
+        return operand16(at);
+    #endif
+}
+
+static void push_constant8(uint32_t* depth, uint8_t value) {
+    assert(*depth < local_count);
+    fprintf(c_ptr, "    s%u = %u;\n", *depth, value);
+    known[*depth] = TRUE;
+    values[*depth] = value;
+    (*depth)++;
+}
+
+// little endian like the vm's exec stack on every host it runs on
+static void push_constant16(uint32_t* depth, uint16_t value) {
+    push_constant8(depth, value & 0xFF);
+    push_constant8(depth, value >> 8);
+}
+
+static uint16_t constant16(uint32_t at) {
+    assert(known[at] && known[at + 1]);
+    return values[at] | (values[at + 1] << 8);
+}
+
+// anything written by a computation stops being a constant
+static void forget(uint32_t at, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) { known[at + i] = FALSE; }
+}
+
+  //////////////
+ // emitting //
+//////////////
+
+// the locals go back onto the caller's stack
+static void emit_store(uint32_t depth, const char* indent) {
+    for (uint32_t i = 0; i < depth; i++) {
+        fprintf(c_ptr, "%stop[%u] = s%u;\n", indent, i, i);
+    }
+    fprintf(c_ptr, "%s*count += %u;\n", indent, depth);
+}
+
+static void emit_binary8(uint32_t to, uint32_t left, uint32_t right, char op) {
+    fprintf(c_ptr, "    s%u = (uint8_t)((uint32_t)s%u %c s%u);\n", to, left, op, right);
+    forget(to, 1);
+}
+
+static void emit_binary16(uint32_t to, uint32_t left, uint32_t right, char op) {
+    fprintf(c_ptr, "    SET16(s%u, s%u, GET16(s%u, s%u) %c GET16(s%u, s%u));\n", to, to + 1, left, left + 1, op, right, right + 1);
+    forget(to, 2);
+}
+
+// dividing by zero stops the program with the stack as it is, like the vm's fault
+static void emit_divisor_check(uint32_t divisor, uint32_t size, uint32_t depth) {
+    if (size == 1) {
+        fprintf(c_ptr, "    if (s%u == 0) {\n", divisor);
+    } else {
+        fprintf(c_ptr, "    if (GET16(s%u, s%u) == 0) {\n", divisor, divisor + 1);
+    }
+    fprintf(c_ptr, "        fprintf(stderr, \"Division by zero!\\n\");\n");
+    emit_store(depth, "        ");
+    fprintf(c_ptr, "        return 2;\n");
+    fprintf(c_ptr, "    }\n");
+}
+
+static void emit_move(uint32_t to, uint32_t from, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        fprintf(c_ptr, "    s%u = s%u;\n", to + i, from + i);
+    }
+    forget(to, size);
+}
+
+static char binary_op(uint8_t type) {
+    switch (type) {
+        case BC_ADD8: case BC_ADD16: case BC_SLOT_ADD8: case BC_SLOT_ADD16: case BC_IGET_ADD8: case BC_IGET_ADD16: return '+';
+        case BC_SUB8: case BC_SUB16: case BC_SLOT_SUB8: case BC_SLOT_SUB16: return '-';
+        case BC_MUL8: case BC_MUL16: case BC_SLOT_MUL8: case BC_SLOT_MUL16: case BC_IGET_MUL8: case BC_IGET_MUL16: return '*';
+        default: return '/';
+    }
+}
+
+// walks straight through from pc until the function returns or the program ends,
+// frame and depth are exec stack offsets from the program's frame
+static void emit_walk(addr_t pc, uint32_t frame, uint32_t* depth) {
+    while (TRUE) {
+        // compact forms are emitted as the long forms they stand for
+        uint8_t expanded[BC_EXPANDED_SIZE];
+        const uint8_t* at = bytecode_expand(&code[pc], expanded);
+        uint32_t length;
+        uint16_t pops, pushes;
+        bool decoded = bytecode_length(&code[pc], (uint32_t)-1, &length) && bytecode_effect(at, &pops, &pushes);
+        assert(decoded);
+        (void)decoded;
+        uint32_t d = *depth;
+
+        switch (at[0]) {
+            case BC_NOOP: break;
+            case BC_EXTEND:
+                fprintf(c_ptr, "    s%u = (s%u & 0x80) ? 0xFF : 0;\n", d, d - 1);
+                forget(d, 1);
+                break;
+
+            // jumps and calls
+            case BC_IJUMP:
+                pc = operand_addr(&at[1]);
+                continue;
+
+            case BC_CALL: {
+                // the return pc and frame change are pushed like the vm would
+                addr_t ret = pc + length;
+                #ifdef SHABBY_WIDE
+                    push_constant16(depth, (uint16_t)(ret >> 16));
+                #endif
+                push_constant16(depth, (uint16_t)ret);
+                uint16_t fp_change = (uint16_t)operand_addr(&at[1]);
+                push_constant16(depth, fp_change);
+                emit_walk(operand_addr(&at[1 + BC_ADDR]), frame + fp_change, depth);
+                pc += length;
+                continue;
+            }
+
+            case BC_RET:
+                *depth -= pops;
+                return;
+
+            // stack basics
+            case BC_PUSH_ZEROS:
+                for (uint16_t i = 0; i < pushes; i++) { push_constant8(depth, 0); }
+                break;
+            case BC_PUSH8: push_constant8(depth, at[1]); break;
+            case BC_PUSH16: push_constant16(depth, operand16(&at[1])); break;
+            case BC_POP8: case BC_POP16: break;
+
+            // pointers
+            case BC_IGET8: case BC_IGET16:
+                emit_move(d, frame + operand16(&at[1]), pushes);
+                break;
+            case BC_GET8: case BC_GET16:
+                emit_move(d - 2, frame + constant16(d - 2), pushes);
+                break;
+            case BC_SET8: case BC_SET16:
+                emit_move(frame + constant16(d - pops), d - pops + 2, pops - 2);
+                break;
+            case BC_COPY: {
+                uint32_t from = frame + constant16(d - 2);
+                uint32_t to = frame + constant16(d - 4);
+                uint16_t size = constant16(d - 6);
+                // the ranges can overlap
+                if (to <= from) {
+                    emit_move(to, from, size);
+                } else {
+                    for (uint16_t i = size; i > 0; i--) { emit_move(to + i - 1, from + i - 1, 1); }
+                }
+                break;
+            }
+
+            // math, the left operand is on top
+            case BC_NEG8:
+                fprintf(c_ptr, "    s%u = (uint8_t)-s%u;\n", d - 1, d - 1);
+                forget(d - 1, 1);
+                break;
+            case BC_NEG16:
+                fprintf(c_ptr, "    SET16(s%u, s%u, -GET16(s%u, s%u));\n", d - 2, d - 1, d - 2, d - 1);
+                forget(d - 2, 2);
+                break;
+            case BC_ADD8: case BC_SUB8: case BC_MUL8: case BC_DIV8:
+                if (at[0] == BC_DIV8) { emit_divisor_check(d - 2, 1, d); }
+                emit_binary8(d - 2, d - 1, d - 2, binary_op(at[0]));
+                break;
+            case BC_ADD16: case BC_SUB16: case BC_MUL16: case BC_DIV16:
+                if (at[0] == BC_DIV16) { emit_divisor_check(d - 4, 2, d); }
+                emit_binary16(d - 4, d - 2, d - 4, binary_op(at[0]));
+                break;
+
+            // superinstructions
+            case BC_SETI8: case BC_SETI16:
+                emit_move(frame + operand16(&at[1]), d - pops, pops);
+                break;
+            case BC_ADDI8:
+                fprintf(c_ptr, "    s%u = (uint8_t)(s%u + %u);\n", d - 1, d - 1, at[1]);
+                forget(d - 1, 1);
+                break;
+            case BC_ADDI16:
+                fprintf(c_ptr, "    SET16(s%u, s%u, GET16(s%u, s%u) + %u);\n", d - 2, d - 1, d - 2, d - 1, operand16(&at[1]));
+                forget(d - 2, 2);
+                break;
+            case BC_IGET_ADD8: case BC_IGET_MUL8:
+                emit_binary8(d - 1, frame + operand16(&at[1]), d - 1, binary_op(at[0]));
+                break;
+            case BC_IGET_ADD16: case BC_IGET_MUL16:
+                emit_binary16(d - 2, frame + operand16(&at[1]), d - 2, binary_op(at[0]));
+                break;
+
+            // slot ops, the destination comes first
+            case BC_SLOT_MOV8: case BC_SLOT_MOV16:
+                emit_move(frame + operand16(&at[1]), frame + operand16(&at[3]), 1 + (at[0] - BC_SLOT_MOV8) % 2);
+                break;
+            case BC_SLOT_ADD8: case BC_SLOT_SUB8: case BC_SLOT_MUL8: case BC_SLOT_DIV8:
+                if (at[0] == BC_SLOT_DIV8) { emit_divisor_check(frame + operand16(&at[5]), 1, d); }
+                emit_binary8(frame + operand16(&at[1]), frame + operand16(&at[3]), frame + operand16(&at[5]), binary_op(at[0]));
+                break;
+            case BC_SLOT_ADD16: case BC_SLOT_SUB16: case BC_SLOT_MUL16: case BC_SLOT_DIV16:
+                if (at[0] == BC_SLOT_DIV16) { emit_divisor_check(frame + operand16(&at[5]), 2, d); }
+                emit_binary16(frame + operand16(&at[1]), frame + operand16(&at[3]), frame + operand16(&at[5]), binary_op(at[0]));
+                break;
+
+            // a mismatch stops the program with the stack as it is
+            case BC_TEST: {
+                uint16_t count = operand16(&at[1]);
+                fprintf(c_ptr, "    failed = 0;\n");
+                for (uint16_t i = 0; i < count; i++) {
+                    fprintf(c_ptr, "    failed |= check(%d, s%u);\n", (int8_t)at[3 + i], d - count + i);
+                }
+                fprintf(c_ptr, "    if (failed) {\n");
+                emit_store(d, "        ");
+                fprintf(c_ptr, "        return 1;\n");
+                fprintf(c_ptr, "    }\n");
+                break;
+            }
+
+            case (uint8_t)BC_EOF:
+                emit_store(d, "    ");
+                fprintf(c_ptr, "    return 0;\n");
+                return;
+
+            // verified code has nothing else
+            default:
+                assert(FALSE);
+        }
+
+        // pushes were written above, pops only move the depth
+        *depth = d - pops + pushes;
+        pc += length;
+    }
+}
+
+// names become part of the function's name
+static void emit_name(const char* name) {
+    for (const char* c = name; *c != '\0'; c++) {
+        fputc(isalnum((unsigned char)*c) ? *c : '_', c_ptr);
+    }
+}
+
+static void emit_function(const char* name) {
+    // header
+    fprintf(c_ptr, "// generated by shabbyc, the exec stack is little endian like the vm's\n");
+    fprintf(c_ptr, "#include <stdio.h>\n");
+    fprintf(c_ptr, "#include <stdint.h>\n\n");
+    fprintf(c_ptr, "#define GET16(lo, hi) ((uint32_t)(lo) | (uint32_t)(hi) << 8)\n");
+    fprintf(c_ptr, "#define SET16(lo, hi, value) do { uint32_t v = (value); lo = (uint8_t)v; hi = (uint8_t)(v >> 8); } while (0)\n\n");
+    fprintf(c_ptr, "static int check(int8_t expected, uint8_t got) {\n");
+    fprintf(c_ptr, "    if ((int8_t)got == expected) { return 0; }\n");
+    fprintf(c_ptr, "    fprintf(stderr, \"Test mismatch, expected: %%d, got %%d!\\n\", expected, (int8_t)got);\n");
+    fprintf(c_ptr, "    return 1;\n");
+    fprintf(c_ptr, "}\n\n");
+
+    // the function
+    fprintf(c_ptr, "// appends what the program leaves on the exec stack, which needs room for %u more bytes,\n", local_count);
+    fprintf(c_ptr, "// 0 when it finished, 1 when a test failed and 2 when it divided by zero\n");
+    fprintf(c_ptr, "int shabby_");
+    emit_name(name);
+    fprintf(c_ptr, "(uint8_t* stack, uint32_t* count) {\n");
+    fprintf(c_ptr, "    uint8_t* top = &stack[*count];\n");
+    fprintf(c_ptr, "    int failed = 0;\n");
+    for (uint32_t i = 0; i < local_count; i++) {
+        fprintf(c_ptr, "%s s%u = 0%s", (i % 8 == 0) ? "    uint8_t" : ",", i, (i % 8 == 7 || i + 1 == local_count) ? ";\n" : "");
+    }
+    // not every program reads every local or has tests
+    fprintf(c_ptr, "    (void)check;\n");
+    fprintf(c_ptr, "    (void)failed;\n");
+    for (uint32_t i = 0; i < local_count; i++) {
+        fprintf(c_ptr, "%s(void)s%u;%s", (i % 8 == 0) ? "    " : " ", i, (i % 8 == 7 || i + 1 == local_count) ? "\n" : "");
+    }
+
+    uint32_t depth = 0;
+    emit_walk(0, 0, &depth);
+    fprintf(c_ptr, "}\n\n");
+
+    // a standalone program for testing
+    fprintf(c_ptr, "#ifdef SHABBY_MAIN\n");
+    fprintf(c_ptr, "int main(void) {\n");
+    fprintf(c_ptr, "    static uint8_t stack[%u];\n", local_count + 1);
+    fprintf(c_ptr, "    uint32_t count = 0;\n");
+    fprintf(c_ptr, "    return shabby_");
+    emit_name(name);
+    fprintf(c_ptr, "(stack, &count);\n");
+    fprintf(c_ptr, "}\n");
+    fprintf(c_ptr, "#endif\n");
+}
+
+  ////////////
+ // emit c //
+////////////
+
+// FALSE if the image is invalid or doesn't verify, only verified code has a fixed stack layout
+bool emit_c(FILE* bin_ptr_arg, FILE* c_ptr_arg, const char* name) {
+    c_ptr = c_ptr_arg;
+
+    fseek(bin_ptr_arg, 0, SEEK_END);
+    long size = ftell(bin_ptr_arg);
+    assert(size >= 0);
+    fseek(bin_ptr_arg, 0, 0);
+    uint8_t* bytes = malloc(size);
+    assert(size == 0 || bytes != NULL);
+    size_t read = fread(bytes, 1, size, bin_ptr_arg);
+    assert(read == (size_t)size);
+    (void)read;
+
+    image_s image;
+    bool emitted = image_load(&image, bytes, size);
+    if (emitted && !image.verified) {
+        fprintf(stderr, "Can't emit C, the code doesn't verify!\n");
+        emitted = FALSE;
+    }
+
+    if (emitted) {
+        code = image.code;
+        local_count = image.stack_needed;
+        known = calloc(local_count + 1, sizeof(bool));
+        values = calloc(local_count + 1, sizeof(uint8_t));
+        assert(known != NULL && values != NULL);
+        emit_function(name);
+        free(known);
+        free(values);
+        known = NULL;
+        values = NULL;
+        code = NULL;
+    }
+
+    free(bytes);
+    return emitted;
+}
+
+  //////////
+ // main //
+//////////
+
+#ifndef SHABBY_LIBRARY
+int main(int argc, char *argv[]) {
+    assert(argc == 2);
+    trace_level = TRACE_STEPS;
+
+    char bin_buffer[256] = { 0 };
+    sprintf(bin_buffer, "../bin/compilation/%s.bin", "out");
+    FILE* bin_ptr = fopen(bin_buffer, "rb");
+    assert(bin_ptr != NULL);
+
+    char c_buffer[256] = { 0 };
+    sprintf(c_buffer, "../bin/compilation/%s.c", "out");
+    FILE* out_ptr = fopen(c_buffer, "wb");
+    assert(out_ptr != NULL);
+
+    bool emitted = emit_c(bin_ptr, out_ptr, "out");
+
+    fclose(bin_ptr);
+    fclose(out_ptr);
+    return emitted ? 0 : 1;
+
+    // make pedantic compilers happy
+    argv[0] = argv[0];
+}
+#endif
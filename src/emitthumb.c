@@ -0,0 +1,506 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+#include "file.h"
+#include "stages.h"
+#include "bytecode.h"
+#include "image.h"
+#include "verify.h"
+#include "trace.h"
+
+// translates a verified image into ARMv6-M thumb assembly for Cortex-M parts, the same walk as the c emitter,
+// the exec stack stays in the caller's ram at fixed offsets and every constant is an immediate in flash
+//
+//   r0-r3 scratch
+//   r4    the program's frame, where it starts pushing
+//   r5    test results
+//   r6    the caller's count
+//   r7    offsets too far for an immediate
+
+  ///////////////////
+ // file pointers //
+///////////////////
+
+static thread_local FILE *s_ptr = NULL; // assembly output
+
+  ///////////
+ // state //
+///////////
+
+static thread_local const uint8_t* code = NULL;
+
+// exec stack bytes pushed as constants, addresses are always pushed right before their use
+static thread_local bool* known = NULL;
+static thread_local uint8_t* values = NULL;
+static thread_local uint32_t stack_count = 0;
+static thread_local uint32_t label_count = 0;
+static thread_local bool divides = FALSE;
+
+static uint16_t operand16(const uint8_t* at) {
+    return (at[0] << 8) | at[1];
+}
+
+static addr_t operand_addr(const uint8_t* at) {
+    #ifdef SHABBY_WIDE
+        return ((addr_t)operand16(at) << 16) | operand16(&at[2]);
+    #else
+        return operand16(at);
+    #endif
+}
+
+static uint16_t constant16(uint32_t at) {
+    assert(known[at] && known[at + 1]);
+    return values[at] | (values[at + 1] << 8);
+}
+
+// anything written by a computation stops being a constant
+static void forget(uint32_t at, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) { known[at + i] = FALSE; }
+}
+
+  //////////////////
+ // instructions //
+//////////////////
+
+// immediates are 8 bits, anything wider is built a byte at a time
+static void emit_const(const char* reg, uint16_t value) {
+    if (value > 0xFF) {
+        fprintf(s_ptr, "    movs %s, #%u\n", reg, value >> 8);
+        fprintf(s_ptr, "    lsls %s, %s, #8\n", reg, reg);
+        if (value & 0xFF) { fprintf(s_ptr, "    adds %s, #%u\n", reg, value & 0xFF); }
+    } else {
+        fprintf(s_ptr, "    movs %s, #%u\n", reg, value);
+    }
+}
+
+// byte accesses reach 31 bytes past r4, further ones go through r7,
+// halfword accesses would fault on unaligned slots so there are none
+static void emit_byte(const char* op, const char* reg, uint32_t offset) {
+    assert(offset < stack_count);
+    if (offset < 32) {
+        fprintf(s_ptr, "    %s %s, [r4, #%u]\n", op, reg, offset);
+    } else {
+        emit_const("r7", (uint16_t)offset);
+        fprintf(s_ptr, "    %s %s, [r4, r7]\n", op, reg);
+    }
+}
+
+static void emit_load16(const char* reg, const char* scratch, uint32_t offset) {
+    emit_byte("ldrb", reg, offset);
+    emit_byte("ldrb", scratch, offset + 1);
+    fprintf(s_ptr, "    lsls %s, %s, #8\n", scratch, scratch);
+    fprintf(s_ptr, "    orrs %s, %s\n", reg, scratch);
+}
+
+// little endian like the vm's exec stack, clobbers the value
+static void emit_store16(const char* reg, uint32_t offset) {
+    emit_byte("strb", reg, offset);
+    fprintf(s_ptr, "    lsrs %s, %s, #8\n", reg, reg);
+    emit_byte("strb", reg, offset + 1);
+}
+
+static void push_constant8(uint32_t* depth, uint8_t value) {
+    emit_const("r0", value);
+    emit_byte("strb", "r0", *depth);
+    known[*depth] = TRUE;
+    values[*depth] = value;
+    (*depth)++;
+}
+
+static void push_constant16(uint32_t* depth, uint16_t value) {
+    push_constant8(depth, value & 0xFF);
+    push_constant8(depth, value >> 8);
+}
+
+static void emit_move(uint32_t to, uint32_t from, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        emit_byte("ldrb", "r0", from + i);
+        emit_byte("strb", "r0", to + i);
+    }
+    forget(to, size);
+}
+
+// left in r0, right in r1, result in r0
+static void emit_op(uint8_t type) {
+    switch (type) {
+        case BC_ADD8: case BC_ADD16: case BC_SLOT_ADD8: case BC_SLOT_ADD16: case BC_IGET_ADD8: case BC_IGET_ADD16:
+            fprintf(s_ptr, "    adds r0, r0, r1\n");
+            break;
+        case BC_SUB8: case BC_SUB16: case BC_SLOT_SUB8: case BC_SLOT_SUB16:
+            fprintf(s_ptr, "    subs r0, r0, r1\n");
+            break;
+        case BC_MUL8: case BC_MUL16: case BC_SLOT_MUL8: case BC_SLOT_MUL16: case BC_IGET_MUL8: case BC_IGET_MUL16:
+            fprintf(s_ptr, "    muls r0, r1, r0\n");
+            break;
+        default:
+            // cortex-m0 has no divide instruction
+            fprintf(s_ptr, "    bl .Ldivide\n");
+            divides = TRUE;
+            break;
+    }
+}
+
+static void emit_binary8(uint8_t type, uint32_t to, uint32_t left, uint32_t right) {
+    emit_byte("ldrb", "r0", left);
+    emit_byte("ldrb", "r1", right);
+    emit_op(type);
+    emit_byte("strb", "r0", to);
+    forget(to, 1);
+}
+
+static void emit_binary16(uint8_t type, uint32_t to, uint32_t left, uint32_t right) {
+    emit_load16("r0", "r2", left);
+    emit_load16("r1", "r3", right);
+    emit_op(type);
+    emit_store16("r0", to);
+    forget(to, 2);
+}
+
+// hands the pushed bytes to the caller and returns the status
+static void emit_return(uint32_t depth, uint8_t status) {
+    fprintf(s_ptr, "    ldr r0, [r6]\n");
+    emit_const("r1", (uint16_t)depth);
+    fprintf(s_ptr, "    adds r0, r0, r1\n");
+    fprintf(s_ptr, "    str r0, [r6]\n");
+    fprintf(s_ptr, "    movs r0, #%u\n", status);
+    fprintf(s_ptr, "    pop {r4, r5, r6, r7, pc}\n");
+}
+
+  //////////
+ // walk //
+//////////
+
+// walks straight through from pc until the function returns or the program ends,
+// frame and depth are exec stack offsets from the program's frame
+static void emit_walk(addr_t pc, uint32_t frame, uint32_t* depth) {
+    while (TRUE) {
+        // compact forms are emitted as the long forms they stand for
+        uint8_t expanded[BC_EXPANDED_SIZE];
+        const uint8_t* at = bytecode_expand(&code[pc], expanded);
+        uint32_t length;
+        uint16_t pops, pushes;
+        bool decoded = bytecode_length(&code[pc], (uint32_t)-1, &length) && bytecode_effect(at, &pops, &pushes);
+        assert(decoded);
+        (void)decoded;
+        uint32_t d = *depth;
+
+        switch (at[0]) {
+            case BC_NOOP: break;
+            case BC_EXTEND:
+                emit_byte("ldrb", "r0", d - 1);
+                fprintf(s_ptr, "    sxtb r0, r0\n");
+                fprintf(s_ptr, "    asrs r0, r0, #31\n");
+                emit_byte("strb", "r0", d);
+                forget(d, 1);
+                break;
+
+            // jumps and calls
+            case BC_IJUMP:
+                pc = operand_addr(&at[1]);
+                continue;
+
+            case BC_CALL: {
+                // the return pc and frame change are pushed like the vm would
+                addr_t ret = pc + length;
+                #ifdef SHABBY_WIDE
+                    push_constant16(depth, (uint16_t)(ret >> 16));
+                #endif
+                push_constant16(depth, (uint16_t)ret);
+                uint16_t fp_change = (uint16_t)operand_addr(&at[1]);
+                push_constant16(depth, fp_change);
+                emit_walk(operand_addr(&at[1 + BC_ADDR]), frame + fp_change, depth);
+                pc += length;
+                continue;
+            }
+
+            case BC_RET:
+                *depth -= pops;
+                return;
+
+            // stack basics
+            case BC_PUSH_ZEROS:
+                for (uint16_t i = 0; i < pushes; i++) { push_constant8(depth, 0); }
+                break;
+            case BC_PUSH8: push_constant8(depth, at[1]); break;
+            case BC_PUSH16: push_constant16(depth, operand16(&at[1])); break;
+            case BC_POP8: case BC_POP16: break;
+
+            // pointers
+            case BC_IGET8: case BC_IGET16:
+                emit_move(d, frame + operand16(&at[1]), pushes);
+                break;
+            case BC_GET8: case BC_GET16:
+                emit_move(d - 2, frame + constant16(d - 2), pushes);
+                break;
+            case BC_SET8: case BC_SET16:
+                emit_move(frame + constant16(d - pops), d - pops + 2, pops - 2);
+                break;
+            case BC_COPY: {
+                uint32_t from = frame + constant16(d - 2);
+                uint32_t to = frame + constant16(d - 4);
+                uint16_t size = constant16(d - 6);
+                // the ranges can overlap
+                if (to <= from) {
+                    emit_move(to, from, size);
+                } else {
+                    for (uint16_t i = size; i > 0; i--) { emit_move(to + i - 1, from + i - 1, 1); }
+                }
+                break;
+            }
+
+            // math, the left operand is on top
+            case BC_NEG8:
+                emit_byte("ldrb", "r0", d - 1);
+                fprintf(s_ptr, "    rsbs r0, r0, #0\n");
+                emit_byte("strb", "r0", d - 1);
+                forget(d - 1, 1);
+                break;
+            case BC_NEG16:
+                emit_load16("r0", "r2", d - 2);
+                fprintf(s_ptr, "    rsbs r0, r0, #0\n");
+                emit_store16("r0", d - 2);
+                forget(d - 2, 2);
+                break;
+            case BC_ADD8: case BC_SUB8: case BC_MUL8: case BC_DIV8:
+                emit_binary8(at[0], d - 2, d - 1, d - 2);
+                break;
+            case BC_ADD16: case BC_SUB16: case BC_MUL16: case BC_DIV16:
+                emit_binary16(at[0], d - 4, d - 2, d - 4);
+                break;
+
+            // superinstructions
+            case BC_SETI8: case BC_SETI16:
+                emit_move(frame + operand16(&at[1]), d - pops, pops);
+                break;
+            case BC_ADDI8:
+                emit_byte("ldrb", "r0", d - 1);
+                fprintf(s_ptr, "    adds r0, #%u\n", at[1]);
+                emit_byte("strb", "r0", d - 1);
+                forget(d - 1, 1);
+                break;
+            case BC_ADDI16:
+                emit_load16("r0", "r2", d - 2);
+                emit_const("r1", operand16(&at[1]));
+                fprintf(s_ptr, "    adds r0, r0, r1\n");
+                emit_store16("r0", d - 2);
+                forget(d - 2, 2);
+                break;
+            case BC_IGET_ADD8: case BC_IGET_MUL8:
+                emit_binary8(at[0], d - 1, frame + operand16(&at[1]), d - 1);
+                break;
+            case BC_IGET_ADD16: case BC_IGET_MUL16:
+                emit_binary16(at[0], d - 2, frame + operand16(&at[1]), d - 2);
+                break;
+
+            // slot ops, the destination comes first
+            case BC_SLOT_MOV8: case BC_SLOT_MOV16:
+                emit_move(frame + operand16(&at[1]), frame + operand16(&at[3]), 1 + (at[0] - BC_SLOT_MOV8) % 2);
+                break;
+            case BC_SLOT_ADD8: case BC_SLOT_SUB8: case BC_SLOT_MUL8: case BC_SLOT_DIV8:
+                emit_binary8(at[0], frame + operand16(&at[1]), frame + operand16(&at[3]), frame + operand16(&at[5]));
+                break;
+            case BC_SLOT_ADD16: case BC_SLOT_SUB16: case BC_SLOT_MUL16: case BC_SLOT_DIV16:
+                emit_binary16(at[0], frame + operand16(&at[1]), frame + operand16(&at[3]), frame + operand16(&at[5]));
+                break;
+
+            // a mismatch stops the program with the stack as it is
+            case BC_TEST: {
+                uint16_t count = operand16(&at[1]);
+                uint32_t passed = label_count++;
+                fprintf(s_ptr, "    movs r5, #0\n");
+                for (uint16_t i = 0; i < count; i++) {
+                    uint32_t match = label_count++;
+                    emit_byte("ldrb", "r0", d - count + i);
+                    fprintf(s_ptr, "    cmp r0, #%u\n", at[3 + i]);
+                    fprintf(s_ptr, "    beq .L%u\n", match);
+                    fprintf(s_ptr, "    movs r5, #1\n");
+                    fprintf(s_ptr, ".L%u:\n", match);
+                }
+                fprintf(s_ptr, "    cmp r5, #0\n");
+                fprintf(s_ptr, "    beq .L%u\n", passed);
+                emit_return(d, 1);
+                fprintf(s_ptr, ".L%u:\n", passed);
+                break;
+            }
+
+            case (uint8_t)BC_EOF:
+                emit_return(d, 0);
+                return;
+
+            // verified code has nothing else
+            default:
+                assert(FALSE);
+        }
+
+        // pushes were written above, pops only move the depth
+        *depth = d - pops + pushes;
+        pc += length;
+    }
+}
+
+  //////////////
+ // function //
+//////////////
+
+// r0 = r0 / r1 unsigned, by shifting and subtracting, dividing by zero traps like it does in the vm
+static void emit_divide(void) {
+    fprintf(s_ptr, "\n    .thumb_func\n");
+    fprintf(s_ptr, ".Ldivide:\n");
+    fprintf(s_ptr, "    cmp r1, #0\n");
+    fprintf(s_ptr, "    bne .Ldivide_start\n");
+    fprintf(s_ptr, "    udf #0\n");
+    fprintf(s_ptr, ".Ldivide_start:\n");
+    fprintf(s_ptr, "    movs r2, #0\n");
+    fprintf(s_ptr, "    movs r3, #1\n");
+    fprintf(s_ptr, ".Ldivide_align:\n");
+    fprintf(s_ptr, "    cmp r1, r0\n");
+    fprintf(s_ptr, "    bhs .Ldivide_subtract\n");
+    fprintf(s_ptr, "    lsls r1, r1, #1\n");
+    fprintf(s_ptr, "    lsls r3, r3, #1\n");
+    fprintf(s_ptr, "    b .Ldivide_align\n");
+    fprintf(s_ptr, ".Ldivide_subtract:\n");
+    fprintf(s_ptr, "    cmp r0, r1\n");
+    fprintf(s_ptr, "    blo .Ldivide_next\n");
+    fprintf(s_ptr, "    subs r0, r0, r1\n");
+    fprintf(s_ptr, "    orrs r2, r3\n");
+    fprintf(s_ptr, ".Ldivide_next:\n");
+    fprintf(s_ptr, "    lsrs r1, r1, #1\n");
+    fprintf(s_ptr, "    lsrs r3, r3, #1\n");
+    fprintf(s_ptr, "    bne .Ldivide_subtract\n");
+    fprintf(s_ptr, "    movs r0, r2\n");
+    fprintf(s_ptr, "    bx lr\n");
+}
+
+// names become part of the function's name
+static void emit_name(const char* name) {
+    for (const char* c = name; *c != '\0'; c++) {
+        fputc(isalnum((unsigned char)*c) ? *c : '_', s_ptr);
+    }
+}
+
+static void emit_function(const char* name) {
+    // header
+    fprintf(s_ptr, "@ generated by shabbyc for armv6-m, the exec stack is little endian like the vm's\n");
+    fprintf(s_ptr, "    .syntax unified\n");
+    fprintf(s_ptr, "    .cpu cortex-m0\n");
+    fprintf(s_ptr, "    .thumb\n");
+    fprintf(s_ptr, "    .text\n\n");
+
+    // the function, called like the c emitter's
+    fprintf(s_ptr, "@ int shabby_");
+    emit_name(name);
+    fprintf(s_ptr, "(uint8_t* stack, uint32_t* count)\n");
+    fprintf(s_ptr, "@ appends what the program leaves on the exec stack, which needs room for %u more bytes,\n", stack_count);
+    fprintf(s_ptr, "@ 0 when it finished and 1 when a test failed\n");
+    fprintf(s_ptr, "    .global shabby_");
+    emit_name(name);
+    fprintf(s_ptr, "\n    .thumb_func\n");
+    fprintf(s_ptr, "shabby_");
+    emit_name(name);
+    fprintf(s_ptr, ":\n");
+    fprintf(s_ptr, "    push {r4, r5, r6, r7, lr}\n");
+    fprintf(s_ptr, "    ldr r2, [r1]\n");
+    fprintf(s_ptr, "    adds r4, r0, r2\n");
+    fprintf(s_ptr, "    mov r6, r1\n");
+
+    uint32_t depth = 0;
+    emit_walk(0, 0, &depth);
+    if (divides) { emit_divide(); }
+
+    // a standalone linux program for qemu-arm, assembled with --defsym SHABBY_MAIN=1
+    fprintf(s_ptr, "\n.ifdef SHABBY_MAIN\n");
+    fprintf(s_ptr, "    .global _start\n");
+    fprintf(s_ptr, "    .thumb_func\n");
+    fprintf(s_ptr, "_start:\n");
+    fprintf(s_ptr, "    ldr r0, =.Lstack\n");
+    fprintf(s_ptr, "    ldr r1, =.Lcount\n");
+    fprintf(s_ptr, "    bl shabby_");
+    emit_name(name);
+    fprintf(s_ptr, "\n    movs r7, #1\n");
+    fprintf(s_ptr, "    svc #0\n");
+    fprintf(s_ptr, "    .ltorg\n");
+    fprintf(s_ptr, "    .bss\n");
+    fprintf(s_ptr, "    .balign 4\n");
+    fprintf(s_ptr, ".Lcount:\n");
+    fprintf(s_ptr, "    .space 4\n");
+    fprintf(s_ptr, ".Lstack:\n");
+    fprintf(s_ptr, "    .space %u\n", stack_count + 1);
+    fprintf(s_ptr, ".endif\n");
+}
+
+  ////////////////
+ // emit thumb //
+////////////////
+
+// FALSE if the image is invalid or doesn't verify, only verified code has a fixed stack layout
+bool emit_thumb(FILE* bin_ptr_arg, FILE* s_ptr_arg, const char* name) {
+    s_ptr = s_ptr_arg;
+
+    fseek(bin_ptr_arg, 0, SEEK_END);
+    long size = ftell(bin_ptr_arg);
+    assert(size >= 0);
+    fseek(bin_ptr_arg, 0, 0);
+    uint8_t* bytes = malloc(size);
+    assert(size == 0 || bytes != NULL);
+    size_t read = fread(bytes, 1, size, bin_ptr_arg);
+    assert(read == (size_t)size);
+    (void)read;
+
+    image_s image;
+    bool emitted = image_load(&image, bytes, size);
+    if (emitted && !image.verified) {
+        fprintf(stderr, "Can't emit thumb, the code doesn't verify!\n");
+        emitted = FALSE;
+    }
+
+    if (emitted) {
+        code = image.code;
+        stack_count = image.stack_needed;
+        label_count = 0;
+        divides = FALSE;
+        known = calloc(stack_count + 1, sizeof(bool));
+        values = calloc(stack_count + 1, sizeof(uint8_t));
+        assert(known != NULL && values != NULL);
+        emit_function(name);
+        free(known);
+        free(values);
+        known = NULL;
+        values = NULL;
+        code = NULL;
+    }
+
+    free(bytes);
+    return emitted;
+}
+
+  //////////
+ // main //
+//////////
+
+#ifndef SHABBY_LIBRARY
+int main(int argc, char *argv[]) {
+    assert(argc == 2);
+    trace_level = TRACE_STEPS;
+
+    char bin_buffer[256] = { 0 };
+    sprintf(bin_buffer, "../bin/compilation/%s.bin", "out");
+    FILE* bin_ptr = fopen(bin_buffer, "rb");
+    assert(bin_ptr != NULL);
+
+    char s_buffer[256] = { 0 };
+    sprintf(s_buffer, "../bin/compilation/%s.s", "out");
+    FILE* out_ptr = fopen(s_buffer, "wb");
+    assert(out_ptr != NULL);
+
+    bool emitted = emit_thumb(bin_ptr, out_ptr, "out");
+
+    fclose(bin_ptr);
+    fclose(out_ptr);
+    return emitted ? 0 : 1;
+
+    // make pedantic compilers happy
+    argv[0] = argv[0];
+}
+#endif
@@ -12,24 +12,24 @@
  // file pointers //
 ///////////////////
 
-static FILE *ast_ptr = NULL; // ast input
+static ast_arena_s *ast_ptr = NULL; // ast input
 static FILE *dot_ptr = NULL; // output for graphviz
 
   ////////////////////////////
  // scheduled future nodes //
 ////////////////////////////
 
-static uint16_t future_stack[FUTURE_STACK_SIZE] = { 0 };
+static addr_t future_stack[FUTURE_STACK_SIZE] = { 0 };
 static uint16_t future_stack_count = 0;
 
-static void future_push(uint16_t offset) {
+static void future_push(addr_t offset) {
     if (offset == NULL) { return; }
     future_stack[future_stack_count] = offset;
     future_stack_count++;
     assert(future_stack_count < FUTURE_STACK_SIZE);
 }
 
-static uint16_t future_pop(void) {
+static addr_t future_pop(void) {
     assert(future_stack_count > 0);
     future_stack_count--;
     return future_stack[future_stack_count];
@@ -41,18 +41,14 @@ static uint16_t future_pop(void) {
 
 static char token[MAX_TOKEN_LEN+1];
 static void read_token(void) {
-    int last_position = ftell(ast_ptr);
-    memset(token, NULL, MAX_TOKEN_LEN);
-    fgets(token, MAX_TOKEN_LEN, ast_ptr);
-    assert(strlen(token) < MAX_TOKEN_LEN);
-    fseek(ast_ptr, last_position + strlen(token) + 1, 0);
+    ast_peek_token(ast_ptr, token);
 }
 
   //////////////
  // graphing //
 //////////////
 
-void graph(FILE *ast_ptr_arg, FILE *dot_ptr_arg) {
+void graph(ast_arena_s *ast_ptr_arg, FILE *dot_ptr_arg) {
     ast_ptr = ast_ptr_arg;
     dot_ptr = dot_ptr_arg;
 
@@ -61,13 +57,14 @@ void graph(FILE *ast_ptr_arg, FILE *dot_ptr_arg) {
     fputs("  node [shape=Mrecord,style=filled]\n", dot_ptr);
 
     // move past root pointer
-    future_push(fget16(ast_ptr));
+    ast_ptr->position = 0;
+    future_push(ast_get_addr(ast_ptr));
 
-    int bail = 0;
-    while(future_stack_count > 0 && ++bail < 1000) {
+    size_t bail = 0;
+    while(future_stack_count > 0 && ++bail < BAIL_LIMIT(ast_ptr->size)) {
         ast_s node = { 0 };
         // navigate to offset and parse node
-        uint16_t offset = future_pop();
+        addr_t offset = future_pop();
         ast_read_node(ast_ptr, offset, &node);
 
         // write node header
@@ -82,7 +79,7 @@ void graph(FILE *ast_ptr_arg, FILE *dot_ptr_arg) {
         // write params
         if (constants.param_count > 0) {
             for (int i = 0; i < constants.param_count; i++) {
-                uint16_t param = ast_get_param(ast_ptr, node.node_type, node.offset, i);
+                addr_t param = ast_get_param(ast_ptr, node.node_type, node.offset, i);
                 fprintf(dot_ptr, "%d", param);
                 if (i != constants.param_count - 1) {
                     fputs(", ", dot_ptr);
@@ -139,7 +136,7 @@ void graph(FILE *ast_ptr_arg, FILE *dot_ptr_arg) {
         }
 
     }
-    assert(bail < 1000);
+    assert(bail < BAIL_LIMIT(ast_ptr->size));
 
     // write footer
     fputs("}\n", dot_ptr);
@@ -154,25 +151,29 @@ int main(int argc, char *argv[]) {
 
     char ast_buffer[256] = { 0 };
     sprintf(ast_buffer, "../bin/compilation/%s.ast", "out");
-    ast_ptr = fopen(ast_buffer, "rb");
+    FILE* ast_file_ptr = fopen(ast_buffer, "rb");
+    ast_arena_s ast = { 0 };
+    ast_arena_load(&ast, ast_file_ptr);
+    fclose(ast_file_ptr);
 
     char dot_buffer[256] = { 0 };
     sprintf(dot_buffer, "../bin/compilation/%s.dot", "out");
     dot_ptr = fopen(dot_buffer, "w+");
 
-    graph(ast_ptr, dot_ptr);
+    graph(&ast, dot_ptr);
     printf("Created graph: ../bin/compilation/%s.png\n", "out");
     fclose(dot_ptr);
-    fclose(ast_ptr);
+    ast_arena_free(&ast);
 
     return 0;
 
     // make pedantic compilers happy
-    types[0] = types[0];
     argv[0] = argv[0];
 }
 #else
-int main(int argc, char *argv[]) {
-    return 0;
+// node names are compiled out of release builds
+int main(void) {
+    fprintf(stderr, "graph needs a debug build!\n");
+    return 1;
 }
 #endif
@@ -5,6 +5,26 @@
 
 #define BC_VARIABLE_PARAMS ((uint8_t)-1)
 
+// operands of varint instructions are leb128, seven bits a byte with the low ones first
+#define BC_VARINT ((uint8_t)-2)
+#define BC_VARINT_MAX ((ADDR_SIZE * 8 + 6) / 7)
+
+// small pushes keep their value in the opcode, one opcode for each
+#define BC_SMALL_COUNT 16
+
+// code addresses follow addr_t, data addresses stay 16 bits
+#define BC_ADDR ADDR_SIZE
+
+// bytes of exec stack the vm gives a program, wide builds get the whole data range
+#ifdef SHABBY_WIDE
+    #define EXEC_STACK_SIZE 0xFFFD
+#else
+    #define EXEC_STACK_SIZE 255
+#endif
+
+// labels are ast offsets, the top bit marks the end of a class instead of its start
+#define BIT_CLASS_END ((addr_t)1 << (ADDR_SIZE * 8 - 1))
+
 typedef struct {
     uint8_t params;
     uint8_t param_size;
@@ -72,25 +92,104 @@ typedef enum {
     BC_DIV8,
     BC_DIV16,
 
+    // superinstructions, fused by the jump resolver
+    BC_SETI8,
+    BC_SETI16,
+
+    BC_ADDI8,
+    BC_ADDI16,
+
+    BC_IGET_ADD8,
+    BC_IGET_ADD16,
+
+    BC_IGET_MUL8,
+    BC_IGET_MUL16,
+
+    // slot ops, three address math straight on frame slots for the slots backend
+    BC_SLOT_MOV8,
+    BC_SLOT_MOV16,
+
+    BC_SLOT_ADD8,
+    BC_SLOT_ADD16,
+
+    BC_SLOT_SUB8,
+    BC_SLOT_SUB16,
+
+    BC_SLOT_MUL8,
+    BC_SLOT_MUL16,
+
+    BC_SLOT_DIV8,
+    BC_SLOT_DIV16,
+
     // testing
     BC_TEST,
 
+    // compact forms, picked by the jump resolver in compact mode
+    BC_PUSH_SMALL8,
+    BC_PUSH_SMALL16 = BC_PUSH_SMALL8 + BC_SMALL_COUNT,
+
+    // byte operands
+    BC_PUSH_ZEROS_S = BC_PUSH_SMALL16 + BC_SMALL_COUNT,
+    BC_PUSH16_S,
+    BC_ADDI16_S,
+
+    BC_IGET8_S,
+    BC_IGET16_S,
+
+    BC_SETI8_S,
+    BC_SETI16_S,
+
+    BC_IGET_ADD8_S,
+    BC_IGET_ADD16_S,
+
+    BC_IGET_MUL8_S,
+    BC_IGET_MUL16_S,
+
+    BC_SLOT_MOV8_S,
+    BC_SLOT_MOV16_S,
+
+    BC_SLOT_ADD8_S,
+    BC_SLOT_ADD16_S,
+
+    BC_SLOT_SUB8_S,
+    BC_SLOT_SUB16_S,
+
+    BC_SLOT_MUL8_S,
+    BC_SLOT_MUL16_S,
+
+    BC_SLOT_DIV8_S,
+    BC_SLOT_DIV16_S,
+
+    // varint code addresses
+    BC_IJUMP_V,
+    BC_CALL_V,
+
+    // gen only like labels, the jump resolver moves class layouts into rodata
+    BC_LAYOUT,
+
     // misc
     BC_EOF = EOF,
 } bytecode_t;
 
-static bytecode_s bytecode[] = {
+// every opcode of a small push range
+#define BC_SMALL_RANGE(base, ...) \
+    [base + 0] = __VA_ARGS__, [base + 1] = __VA_ARGS__, [base + 2] = __VA_ARGS__, [base + 3] = __VA_ARGS__, \
+    [base + 4] = __VA_ARGS__, [base + 5] = __VA_ARGS__, [base + 6] = __VA_ARGS__, [base + 7] = __VA_ARGS__, \
+    [base + 8] = __VA_ARGS__, [base + 9] = __VA_ARGS__, [base + 10] = __VA_ARGS__, [base + 11] = __VA_ARGS__, \
+    [base + 12] = __VA_ARGS__, [base + 13] = __VA_ARGS__, [base + 14] = __VA_ARGS__, [base + 15] = __VA_ARGS__
+
+static const bytecode_s bytecode[] = {
     // misc
     [BC_NOOP] = { 0, 0, DBG_STR("noop") },
     [BC_EXTEND] = { 0, 1, DBG_STR("extend") },
 
     // jumps
     [BC_JUMP] = { 0, 0, DBG_STR("jump") },
-    [BC_IJUMP] = { 1, 2, DBG_STR("ijump") },
-    [BC_LABEL] = { 1, 2, DBG_STR("label") },
+    [BC_IJUMP] = { 1, BC_ADDR, DBG_STR("ijump") },
+    [BC_LABEL] = { 1, BC_ADDR, DBG_STR("label") },
 
     // functions
-    [BC_CALL] = { 2, 2, DBG_STR("call") },
+    [BC_CALL] = { 2, BC_ADDR, DBG_STR("call") },
     [BC_RET] = { 0, 0, DBG_STR("ret") },
 
     // program counter
@@ -138,8 +237,117 @@ static bytecode_s bytecode[] = {
     [BC_DIV8] = { 0, 0, DBG_STR("div8") },
     [BC_DIV16] = { 0, 0, DBG_STR("div16") },
 
+    // superinstructions, fused by the jump resolver
+    [BC_SETI8] = { 1, 2, DBG_STR("seti8") },
+    [BC_SETI16] = { 1, 2, DBG_STR("seti16") },
+
+    [BC_ADDI8] = { 1, 1, DBG_STR("addi8") },
+    [BC_ADDI16] = { 1, 2, DBG_STR("addi16") },
+
+    [BC_IGET_ADD8] = { 1, 2, DBG_STR("iget_add8") },
+    [BC_IGET_ADD16] = { 1, 2, DBG_STR("iget_add16") },
+
+    [BC_IGET_MUL8] = { 1, 2, DBG_STR("iget_mul8") },
+    [BC_IGET_MUL16] = { 1, 2, DBG_STR("iget_mul16") },
+
+    // slot ops, destination first
+    [BC_SLOT_MOV8] = { 2, 2, DBG_STR("slot_mov8") },
+    [BC_SLOT_MOV16] = { 2, 2, DBG_STR("slot_mov16") },
+
+    [BC_SLOT_ADD8] = { 3, 2, DBG_STR("slot_add8") },
+    [BC_SLOT_ADD16] = { 3, 2, DBG_STR("slot_add16") },
+
+    [BC_SLOT_SUB8] = { 3, 2, DBG_STR("slot_sub8") },
+    [BC_SLOT_SUB16] = { 3, 2, DBG_STR("slot_sub16") },
+
+    [BC_SLOT_MUL8] = { 3, 2, DBG_STR("slot_mul8") },
+    [BC_SLOT_MUL16] = { 3, 2, DBG_STR("slot_mul16") },
+
+    [BC_SLOT_DIV8] = { 3, 2, DBG_STR("slot_div8") },
+    [BC_SLOT_DIV16] = { 3, 2, DBG_STR("slot_div16") },
+
     // testing
     [BC_TEST] = { BC_VARIABLE_PARAMS, BC_VARIABLE_PARAMS, DBG_STR("test") },
+
+    // compact forms
+    BC_SMALL_RANGE(BC_PUSH_SMALL8, { 0, 0, DBG_STR("push_small8") }),
+    BC_SMALL_RANGE(BC_PUSH_SMALL16, { 0, 0, DBG_STR("push_small16") }),
+
+    [BC_PUSH_ZEROS_S] = { 1, 1, DBG_STR("push_zeros_s") },
+    [BC_PUSH16_S] = { 1, 1, DBG_STR("push16_s") },
+    [BC_ADDI16_S] = { 1, 1, DBG_STR("addi16_s") },
+
+    [BC_IGET8_S] = { 1, 1, DBG_STR("iget8_s") },
+    [BC_IGET16_S] = { 1, 1, DBG_STR("iget16_s") },
+
+    [BC_SETI8_S] = { 1, 1, DBG_STR("seti8_s") },
+    [BC_SETI16_S] = { 1, 1, DBG_STR("seti16_s") },
+
+    [BC_IGET_ADD8_S] = { 1, 1, DBG_STR("iget_add8_s") },
+    [BC_IGET_ADD16_S] = { 1, 1, DBG_STR("iget_add16_s") },
+
+    [BC_IGET_MUL8_S] = { 1, 1, DBG_STR("iget_mul8_s") },
+    [BC_IGET_MUL16_S] = { 1, 1, DBG_STR("iget_mul16_s") },
+
+    [BC_SLOT_MOV8_S] = { 2, 1, DBG_STR("slot_mov8_s") },
+    [BC_SLOT_MOV16_S] = { 2, 1, DBG_STR("slot_mov16_s") },
+
+    [BC_SLOT_ADD8_S] = { 3, 1, DBG_STR("slot_add8_s") },
+    [BC_SLOT_ADD16_S] = { 3, 1, DBG_STR("slot_add16_s") },
+
+    [BC_SLOT_SUB8_S] = { 3, 1, DBG_STR("slot_sub8_s") },
+    [BC_SLOT_SUB16_S] = { 3, 1, DBG_STR("slot_sub16_s") },
+
+    [BC_SLOT_MUL8_S] = { 3, 1, DBG_STR("slot_mul8_s") },
+    [BC_SLOT_MUL16_S] = { 3, 1, DBG_STR("slot_mul16_s") },
+
+    [BC_SLOT_DIV8_S] = { 3, 1, DBG_STR("slot_div8_s") },
+    [BC_SLOT_DIV16_S] = { 3, 1, DBG_STR("slot_div16_s") },
+
+    [BC_IJUMP_V] = { 1, BC_VARINT, DBG_STR("ijump_v") },
+    [BC_CALL_V] = { 2, BC_VARINT, DBG_STR("call_v") },
+
+    // class, instance bytes
+    [BC_LAYOUT] = { 2, BC_ADDR, DBG_STR("layout") },
+};
+
+#undef BC_SMALL_RANGE
+
+// the long form each compact opcode with operands stands for, small pushes are push8 and push16
+static const uint8_t bytecode_long_form[256] = {
+    [BC_PUSH_ZEROS_S] = BC_PUSH_ZEROS,
+    [BC_PUSH16_S] = BC_PUSH16,
+    [BC_ADDI16_S] = BC_ADDI16,
+
+    [BC_IGET8_S] = BC_IGET8,
+    [BC_IGET16_S] = BC_IGET16,
+
+    [BC_SETI8_S] = BC_SETI8,
+    [BC_SETI16_S] = BC_SETI16,
+
+    [BC_IGET_ADD8_S] = BC_IGET_ADD8,
+    [BC_IGET_ADD16_S] = BC_IGET_ADD16,
+
+    [BC_IGET_MUL8_S] = BC_IGET_MUL8,
+    [BC_IGET_MUL16_S] = BC_IGET_MUL16,
+
+    [BC_SLOT_MOV8_S] = BC_SLOT_MOV8,
+    [BC_SLOT_MOV16_S] = BC_SLOT_MOV16,
+
+    [BC_SLOT_ADD8_S] = BC_SLOT_ADD8,
+    [BC_SLOT_ADD16_S] = BC_SLOT_ADD16,
+
+    [BC_SLOT_SUB8_S] = BC_SLOT_SUB8,
+    [BC_SLOT_SUB16_S] = BC_SLOT_SUB16,
+
+    [BC_SLOT_MUL8_S] = BC_SLOT_MUL8,
+    [BC_SLOT_MUL16_S] = BC_SLOT_MUL16,
+
+    [BC_SLOT_DIV8_S] = BC_SLOT_DIV8,
+    [BC_SLOT_DIV16_S] = BC_SLOT_DIV16,
+
+    [BC_IJUMP_V] = BC_IJUMP,
+    [BC_CALL_V] = BC_CALL,
 };
 
 #endif
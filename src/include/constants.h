@@ -10,16 +10,38 @@
 #undef NULL
 #define NULL 0
 
-#define DEBUG 1
+// stage state is per thread, so a driver can run one compile on each thread
+#ifndef thread_local
+    #define thread_local _Thread_local
+#endif
+
+// SHABBY_RELEASE compiles out node and bytecode names along with all tracing
+#ifndef SHABBY_RELEASE
+    #define DEBUG 1
+#endif
+
 #ifdef DEBUG
     #define DBG_STR(x) x
 #else
     #define DBG_STR(x)
 #endif
 
+// offsets into sources, the ast and bytecode, SHABBY_WIDE makes them 32 bits for large host programs
+#ifdef SHABBY_WIDE
+    typedef uint32_t addr_t;
+    #define ADDR_SIZE 4
+#else
+    typedef uint16_t addr_t;
+    #define ADDR_SIZE 2
+#endif
+#define ADDR_MAX ((addr_t)-1)
+
 #define MAX_TOKEN_LEN 32
 #define FUTURE_STACK_SIZE 100
 
+// runaway guard for the future stack loops, every node is at least a byte so it scales with the ast
+#define BAIL_LIMIT(ast_size) (1000 + (ast_size))
+
 // required because pedantic mode is on
 extern bool make_iso_compilers_happy;
 
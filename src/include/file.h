@@ -6,5 +6,26 @@
 
 void fput16(uint16_t, FILE*);
 uint16_t fget16(FILE*);
+void fput32(uint32_t, FILE*);
+uint32_t fget32(FILE*);
+
+// offsets are as wide as addr_t
+#ifdef SHABBY_WIDE
+    #define fput_addr fput32
+    #define fget_addr fget32
+#else
+    #define fput_addr fput16
+    #define fget_addr fget16
+#endif
+
+// growable memory that can be read and written through a FILE*
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} buffer_s;
+
+FILE* buffer_open(buffer_s*);
+void buffer_free(buffer_s*);
 
 #endif
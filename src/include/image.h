@@ -0,0 +1,78 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "constants.h"
+
+// a compiled program, everything is big endian like the bytecode operands
+//
+//   0  magic "SHBY"
+//   4  u16 version
+//   6  u8 address size, 2 or 4
+//   7  u8 section count
+//   8  u16 exec stack bytes the program needs, all of it if the compiler couldn't tell
+//  10  u16 reserved, zero
+//  12  u32 fnv-1a checksum of everything after the header
+//  16  section table, a u32 type, offset and size for each section
+//      sections, code first and always ending in BC_EOF
+//
+// code and rodata never change at runtime, so a harvard target can leave the whole image in flash
+// and read it through the accessors in rom.h, only the exec stack needs ram
+
+#define IMAGE_MAGIC "SHBY"
+// bumped whenever opcodes are renumbered
+#define IMAGE_VERSION 2
+#define IMAGE_HEADER_SIZE 16
+#define IMAGE_SECTION_SIZE 12
+#define IMAGE_ENTRY_SIZE 12
+#define IMAGE_LAYOUT_SIZE 8
+
+typedef enum {
+    SECTION_CODE,
+    SECTION_RODATA, // a u32 layout count and the class layouts, constants will follow them once the language has any
+    SECTION_ENTRIES, // where the program and each class constructor start
+    SECTION_COUNT,
+} section_t;
+
+typedef enum {
+    ENTRY_PROGRAM,
+    ENTRY_CLASS,
+} entry_t;
+
+typedef struct {
+    uint32_t type;
+    uint32_t id; // ast offset of the class
+    uint32_t offset; // into the code section
+} image_entry_s;
+
+typedef struct {
+    uint32_t id; // ast offset of the class, like its entry
+    uint32_t bytes; // size of an instance
+} image_layout_s;
+
+typedef struct {
+    const uint8_t* bytes; // the whole file
+    size_t size;
+    bool mapped;
+    uint16_t stack_size;
+    bool verified; // by the loader, the header is never trusted for it
+    uint32_t stack_needed;
+    const uint8_t* code; // followed by its BC_EOF sentinel
+    addr_t code_size; // without the sentinel
+    const uint8_t* rodata;
+    uint32_t rodata_size;
+    const uint8_t* layouts;
+    uint32_t layout_count;
+    const uint8_t* entries;
+    uint32_t entry_count;
+} image_s;
+
+void image_write(FILE*, const uint8_t* code, size_t code_size, const image_entry_s* entries, uint32_t entry_count, const image_layout_s* layouts, uint32_t layout_count, uint16_t stack_size);
+bool image_load(image_s*, const uint8_t* bytes, size_t size);
+bool image_map(image_s*, const char* path);
+void image_unmap(image_s*);
+image_entry_s image_entry(const image_s*, uint32_t index);
+image_layout_s image_layout(const image_s*, uint32_t index);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include "constants.h"
+
+#define INTERN_NONE ((uint32_t)-1)
+
+// identifiers are stored once and referred to by a dense id
+uint32_t intern(const char*);
+uint32_t intern_span(const char*, uint32_t);
+uint32_t intern_find(const char*);
+uint32_t intern_find_span(const char*, uint32_t);
+const char* interned(uint32_t);
+uint32_t intern_count(void);
+void intern_clear(void);
+
+#endif
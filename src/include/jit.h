@@ -0,0 +1,31 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "constants.h"
+
+typedef enum {
+    JIT_FINISHED,
+    JIT_YIELDED,
+    JIT_FAULTED,
+    JIT_INTERPRET, // reached an instruction without a template, the interpreter carries on from pc
+} jit_status_t;
+
+// the interpreter's registers as native code sees them, both share the exec stack itself
+typedef struct {
+    uint8_t* top; // one past the top of the exec stack
+    uint8_t* frame;
+    uint64_t native_sp; // host stack on entry, exits unwind to it from inside native calls
+    uint32_t pc;
+    uint32_t fuel;
+} jit_context_s;
+
+typedef struct jit_code_s jit_code_t;
+
+// x86-64 for code that verified, NULL on any other host
+jit_code_t* jit_compile(const uint8_t* code, addr_t size);
+
+// runs from the first instruction until the code finishes, yields, faults or needs the interpreter
+jit_status_t jit_run(const jit_code_t*, jit_context_s*);
+void jit_free(jit_code_t*);
+
+#endif
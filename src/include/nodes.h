@@ -41,79 +41,69 @@ typedef enum {
 #define NTP_ASSIGNMENT_ADDRESS 0
 #define NTP_VARIABLE_ADDRESS 0
 
-#ifdef DEBUG
 typedef struct {
-    char name[MAX_TOKEN_LEN+1];
     uint8_t child_count;
     uint8_t param_count;
     uint8_t output_token_count;
+    #ifdef DEBUG
+    char name[MAX_TOKEN_LEN+1];
+    #endif
 } node_s;
 
-static node_s node_constants[] = {
-    // Parser Only
-    [NT_NONE] = { "none", 0, 0, 0 },
-    [NT_ROOT] = { "root", 0, 0, 0 },
-    [NT_CONSUME] = { "consume", 0, 0, 0 },
-    [NT_STATEMENT_LIST] = { "statement_list", 0, 0, 0 },
-
-    // Shared
-    [NT_CLASS] = { "class", 1, 2, 1 },
-    [NT_STATEMENT] = { "statement", 2, 0, 0 },
-    [NT_DECLARATION] = { "declaration", 1, 1, 2 },
-    [NT_ASSIGNMENT] = { "assignment", 2, 1, 1 },
-    [NT_EXPRESSION] = { "expression", 3, 0, 0 },
-    [NT_EXPRESSION_OP] = { "expression_op", 0, 0, 1 },
-    [NT_TERM] = { "term", 3, 0, 0 },
-    [NT_TERM_OP] = { "term_op", 0, 0, 1 },
-    [NT_FACTOR] = { "factor", 2, 0, 0 },
-    [NT_UNARY_OP] = { "unary_op", 0, 0, 1 },
-    [NT_VARIABLE] = { "variable", 1, 1, 1 },
-    [NT_MEMBER] = { "member", 1, 0, 1 },
-    [NT_CONSTANT] = { "constant", 0, 0, 1 },
-    [NT_CAST] = { "cast", 1, 0, 1 },
-
-    // Testing
-    [NT_TEST] = {"$TEST", 0, 0, 1 },
-
-    // debug
-    [NT_DEBUG_UNINDENT_NODE] = { "debug_unindent_node", 0, 0, 0 },
-};
-#endif
+extern const node_s node_constants[];
 
 #define MAX_AST_CHILDREN 4
 typedef struct {
-    uint16_t offset;
+    addr_t offset;
     node_t node_type;
     uint8_t value_type;
-    uint16_t scratch;
-    uint16_t parent_offset;
-    uint16_t children[MAX_AST_CHILDREN];
+    addr_t scratch;
+    addr_t parent_offset;
+    addr_t children[MAX_AST_CHILDREN];
 } ast_s;
 
 #define AST_ADDR_NODE_TYPE(offset) (offset)
 #define AST_ADDR_VALUE_TYPE(offset) (AST_ADDR_NODE_TYPE(offset) + 1)
 #define AST_ADDR_SCRATCH(offset) (AST_ADDR_VALUE_TYPE(offset) + 1)
-#define AST_ADDR_PARENT(offset) (AST_ADDR_SCRATCH(offset) + 2)
+#define AST_ADDR_PARENT(offset) (AST_ADDR_SCRATCH(offset) + ADDR_SIZE)
 #define AST_ADDR_CHILD(offset, child_index) ((offset == 0) \
                              ? 0 \
-                             : (AST_ADDR_PARENT(offset) + 2 + (uint16_t)child_index * 2))
+                             : (AST_ADDR_PARENT(offset) + ADDR_SIZE + (addr_t)child_index * ADDR_SIZE))
 #define AST_ADDR_PARAM(node_type, offset, param_index) ((offset == 0) \
                              ? 0 \
-                             : (AST_ADDR_CHILD(offset, node_constants[node_type].child_count ) + (uint16_t)param_index * 2))
+                             : (AST_ADDR_CHILD(offset, node_constants[node_type].child_count ) + (addr_t)param_index * ADDR_SIZE))
+
+// the tree lives in memory, nodes are addressed by their offset into data
+typedef struct ast_arena_s {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    addr_t position; // read/write cursor
+} ast_arena_s;
+
+void ast_arena_load(ast_arena_s*, FILE*);
+void ast_arena_save(ast_arena_s*, FILE*);
+void ast_arena_free(ast_arena_s*);
+
+int ast_getc(ast_arena_s*);
+void ast_putc(uint8_t, ast_arena_s*);
+void ast_puts(const char*, ast_arena_s*);
+addr_t ast_get_addr(ast_arena_s*);
+void ast_put_addr(addr_t, ast_arena_s*);
 
-void ast_read_node(FILE*, uint16_t, ast_s*);
+void ast_read_node(ast_arena_s*, addr_t, ast_s*);
 
-uint16_t ast_new_node(FILE*, node_t, uint16_t, uint8_t);
-uint16_t ast_insert_new_node(FILE*, ast_s*);
+addr_t ast_new_node(ast_arena_s*, node_t, addr_t, uint8_t);
+addr_t ast_insert_new_node(ast_arena_s*, ast_s*);
 
-void ast_overwrite_scratch(FILE*, uint16_t, uint16_t);
+void ast_overwrite_scratch(ast_arena_s*, addr_t, addr_t);
 
-uint16_t ast_get_param(FILE*, node_t, uint16_t, uint8_t);
-void ast_set_param(FILE*, node_t, uint16_t, uint8_t, uint16_t);
+addr_t ast_get_param(ast_arena_s*, node_t, addr_t, uint8_t);
+void ast_set_param(ast_arena_s*, node_t, addr_t, uint8_t, addr_t);
 
-void ast_peek_token(FILE*, char*);
+void ast_peek_token(ast_arena_s*, char*);
 
-uint16_t ast_get_member(FILE*, uint16_t, char*);
-uint16_t ast_get_member_address(FILE*, uint16_t);
+addr_t ast_get_member(ast_arena_s*, addr_t, char*);
+addr_t ast_get_member_address(ast_arena_s*, addr_t);
 
 #endif
@@ -0,0 +1,40 @@
+#ifndef ROM_H
+#define ROM_H
+
+#include "constants.h"
+
+// how images and bytecode are read, harvard targets keep them in flash behind their own load instructions
+//
+// SHABBY_CODE_IN_ROM has the port supply rom_read8 and rom_read16 for its flash, pgm_read_byte and
+// friends on avr, everywhere else they read straight through the pointer and compile away
+
+// the longest instruction without its test values, a wide varint call
+#define ROM_WINDOW_SIZE (1 + 2 * 5)
+
+#ifdef SHABBY_CODE_IN_ROM
+    uint8_t rom_read8(const uint8_t* at);
+    uint16_t rom_read16(const uint8_t* at); // big endian like the operands
+#else
+    static inline uint8_t rom_read8(const uint8_t* at) { return *at; }
+    static inline uint16_t rom_read16(const uint8_t* at) { return (at[0] << 8) | at[1]; }
+#endif
+
+static inline uint32_t rom_read32(const uint8_t* at) {
+    return ((uint32_t)rom_read16(at) << 16) | rom_read16(&at[2]);
+}
+
+// the instruction at, as far as remaining allows, somewhere it can be read like ram,
+// code in rom is copied into window and everything else is used in place
+static inline const uint8_t* rom_window(const uint8_t* at, uint32_t remaining, uint8_t* window) {
+    #ifdef SHABBY_CODE_IN_ROM
+        if (remaining > ROM_WINDOW_SIZE) { remaining = ROM_WINDOW_SIZE; }
+        for (uint32_t i = 0; i < remaining; i++) { window[i] = rom_read8(&at[i]); }
+        return window;
+    #else
+        (void)remaining;
+        (void)window;
+        return at;
+    #endif
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef STAGES_H
+#define STAGES_H
+
+#include <stdio.h>
+
+#include "tokens.h"
+
+typedef struct ast_arena_s ast_arena_s;
+
+// what codegen targets, slot ops run arithmetic on variables in one dispatch at the cost of code size
+typedef enum {
+    BACKEND_STACK,
+    BACKEND_SLOTS,
+} backend_t;
+extern backend_t gen_backend;
+
+// the jump resolver picks the shortest encoding of every instruction, byte operands, small pushes and varint jumps
+extern bool resolve_compact;
+
+// the vm stage runs verified code natively where the host has a jit
+extern bool vm_use_jit;
+
+// entry points of every compilation stage, shared with the single process driver
+void tokenize(FILE*, token_array_s*);
+void tokenize_buffer(const uint8_t*, size_t, token_array_s*);
+void parse(token_array_s*, ast_arena_s*);
+void symgen(ast_arena_s*);
+void typecheck(ast_arena_s*);
+void gen(FILE*, ast_arena_s*, FILE*);
+void jump_resolution(FILE*, FILE*);
+bool vm(FILE*);
+bool emit_c(FILE* bin, FILE* c, const char* name);
+bool emit_thumb(FILE* bin, FILE* s, const char* name);
+
+#endif
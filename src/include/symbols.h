@@ -3,6 +3,16 @@
 
 #include "constants.h"
 
+// bits of char_classes, one lookup classifies a character
+#define CHAR_WHITESPACE (1 << 0)
+#define CHAR_ALPHA (1 << 1)
+#define CHAR_NUMERIC (1 << 2)
+#define CHAR_UNDERSCORE (1 << 3)
+#define CHAR_MATH_OP (1 << 4)
+#define CHAR_IDENTIFIER (CHAR_ALPHA | CHAR_NUMERIC | CHAR_UNDERSCORE)
+
+extern const uint8_t char_classes[256];
+
 bool is_whitespace(uint8_t);
 bool is_alpha(uint8_t);
 bool is_numeric(uint8_t);
@@ -12,6 +22,6 @@ bool is_term_op(uint8_t);
 bool is_expression_op(uint8_t);
 bool is_binary_op(uint8_t);
 bool is_unary_op(uint8_t);
-bool is_identifier(char*);
+bool is_identifier(const char*);
 
 #endif
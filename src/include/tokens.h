@@ -0,0 +1,33 @@
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include <stdio.h>
+#include "constants.h"
+
+typedef enum {
+    TOKEN_IDENTIFIER,
+    TOKEN_NUMBER,
+    TOKEN_SYMBOL,
+} token_kind_t;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t length;
+    uint32_t start; // offset of the token in the source
+    uint32_t id; // interned token text
+} token_s;
+
+// every token of a source file, produced once by the tokenizer
+typedef struct {
+    token_s* data;
+    uint32_t count;
+    uint32_t capacity;
+} token_array_s;
+
+token_kind_t token_kind(uint8_t);
+void tokens_add(token_array_s*, token_kind_t, uint32_t, const char*, uint8_t);
+void tokens_save(token_array_s*, FILE*);
+void tokens_load(token_array_s*, FILE*, FILE*);
+void tokens_free(token_array_s*);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include "constants.h"
+
+// how much the stages print, chosen at runtime
+#define TRACE_NONE 0
+#define TRACE_STAGES 1 // tables and phase headers
+#define TRACE_STEPS 2 // every node, label and instruction
+
+extern uint8_t trace_level;
+
+// release builds compile the traces and their arguments out entirely
+#ifdef DEBUG
+    #define TRACING(level) (trace_level >= (level))
+    #define TRACE(level, ...) do { if (TRACING(level)) { printf(__VA_ARGS__); } } while (0)
+#else
+    #define TRACING(level) FALSE
+    #define TRACE(level, ...) do { } while (0)
+#endif
+
+#endif
@@ -15,7 +15,7 @@ typedef struct {
     char name[MAX_TOKEN_LEN+1];
 } type_s;
 
-static type_s types[] = {
+static const type_s types[] = {
     [TYPE_USER_DEFINED] = { .size = 0, .name = "<user defined>" },
     [TYPE_BYTE] = { .size = 1, .name = "byte" },
     [TYPE_SHORT] = { .size = 2, .name = "short" },
@@ -23,7 +23,9 @@ static type_s types[] = {
     //[TYPE_FLOAT] = { .size = 4, .name = "float" },
 };
 
+typedef struct ast_arena_s ast_arena_s;
+
 type_t get_type(char* s);
-uint16_t get_user_type(FILE*, char*, uint16_t);
+addr_t get_user_type(ast_arena_s*, char*, addr_t);
 
 #endif
@@ -4,21 +4,21 @@
 #include "constants.h"
 #include "types.h"
 
-#define MAX_VARS_IN_SCOPE 64
-
 typedef struct {
     type_t type;
-    char name[MAX_TOKEN_LEN+1];
-    uint8_t scope;
-    uint8_t address;
+    uint32_t name; // interned identifier
+    uint16_t scope;
+    uint16_t address;
     uint16_t size;
-    uint16_t offset;
-    uint16_t user_type_offset;
+    addr_t offset;
+    addr_t user_type_offset;
+    int32_t shadowed; // index of the variable with the same name this one hides, or -1
 } var_s;
 
 var_s* get_variable(char*);
-uint16_t store_variable(type_t, char*, uint16_t, uint16_t, uint16_t);
+uint16_t store_variable(type_t, char*, uint16_t, addr_t, addr_t);
 void scope_increment(void);
 void scope_decrement(void);
+void variables_clear(void);
 
 #endif
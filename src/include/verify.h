@@ -0,0 +1,23 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include "constants.h"
+
+// instruction size with operands, FALSE for labels, unknown opcodes or operands past the end
+bool bytecode_length(const uint8_t* at, uint32_t remaining, uint32_t* length);
+
+// the longest long form without test values, a wide call
+#define BC_EXPANDED_SIZE (1 + 2 * 4)
+
+// the long form of a compact instruction written to buffer, anything else comes back as it is,
+// so code past the decoder only ever deals with long forms
+const uint8_t* bytecode_expand(const uint8_t* at, uint8_t* buffer);
+
+// bytes an instruction pops off and pushes onto the exec stack, FALSE for unknown opcodes
+bool bytecode_effect(const uint8_t* at, uint16_t* pops, uint16_t* pushes);
+
+// TRUE if the code never leaves its stack or frame on any path and can run without checks,
+// stack_needed is the most exec stack it ever uses
+bool verify(const uint8_t* code, addr_t size, uint32_t* stack_needed);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef VM_H
+#define VM_H
+
+#include <stddef.h>
+#include "constants.h"
+#include "image.h"
+
+typedef enum {
+    VM_FINISHED, // reached the end of the image
+    VM_YIELDED, // out of fuel, run again to continue
+    VM_FAULTED, // invalid instruction or failed test, stays faulted until reset
+} vm_status_t;
+
+// fuel is spent on backward jumps and calls only
+#define VM_FUEL_MAX ((uint32_t)-1)
+
+// an independent vm with its own stack and registers, the bytecode is copied or shared read only
+// and has to be shared from rom, code that verifies runs without per instruction checks, and as native code after vm_jit
+typedef struct shabby_vm_s shabby_vm_t;
+
+shabby_vm_t* vm_create(const uint8_t* image, size_t size);
+shabby_vm_t* vm_create_shared(const uint8_t* image, size_t size);
+shabby_vm_t* vm_create_image(const image_s*);
+void vm_check(shabby_vm_t*);
+bool vm_checked(const shabby_vm_t*);
+bool vm_jit(shabby_vm_t*);
+const uint8_t* vm_stack(shabby_vm_t*, uint32_t* count);
+void vm_reset(shabby_vm_t*);
+void vm_load_frame(shabby_vm_t*, const uint8_t* frame, uint16_t size);
+vm_status_t vm_run(shabby_vm_t*, uint32_t fuel);
+void vm_destroy(shabby_vm_t*);
+
+#endif
@@ -0,0 +1,790 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include "bytecode.h"
+#include "verify.h"
+#include "jit.h"
+
+// translates verified bytecode by pasting a pre-assembled machine code template for every instruction,
+// jump and call targets are already resolved so they're patched straight to the target's template
+
+#if defined(__x86_64__) && defined(__linux__)
+    #define JIT_X86_64
+    #include <sys/mman.h>
+#endif
+
+struct jit_code_s {
+    uint8_t* memory; // read and execute only once written
+    size_t size;
+    uint32_t entry; // template of the first instruction
+};
+
+#ifdef JIT_X86_64
+
+  ///////////////
+ // templates //
+///////////////
+
+// registers while native code runs
+//   r12  top of the exec stack
+//   r13  frame pointer
+//   r14d fuel
+//   r15  context
+//   rbp  host stack across helper calls, which realign it
+// calls and returns use the host stack, the exec stack still gets the return pc and frame change
+// so the interpreter can take over at any instruction boundary
+
+// the entry and exit templates hard code the context layout
+_Static_assert(offsetof(jit_context_s, top) == 0 && offsetof(jit_context_s, frame) == 8 && offsetof(jit_context_s, native_sp) == 16
+    && offsetof(jit_context_s, pc) == 24 && offsetof(jit_context_s, fuel) == 28, "jit context layout");
+
+// assembled with gas in intel syntax, the defines are where each operand gets patched in
+
+// push rbp; push rbx; push r12; push r13; push r14; push r15; mov r15, rdi; mov r12, [r15]; mov r13, [r15+8]; mov r14d, [r15+28]; mov [r15+16], rsp; jmp rsi
+static const uint8_t t_enter[] = {
+    0x55, 0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57, 0x49, 0x89,
+    0xFF, 0x4D, 0x8B, 0x27, 0x4D, 0x8B, 0x6F, 0x08, 0x45, 0x8B, 0x77, 0x1C,
+    0x49, 0x89, 0x67, 0x10, 0xFF, 0xE6,
+};
+
+// mov [r15+24], eax; mov [r15], r12; mov [r15+8], r13; mov [r15+28], r14d; mov rsp, [r15+16]; mov eax, edx; pop r15; pop r14; pop r13; pop r12; pop rbx; pop rbp; ret
+static const uint8_t t_exit[] = {
+    0x41, 0x89, 0x47, 0x18, 0x4D, 0x89, 0x27, 0x4D, 0x89, 0x6F, 0x08, 0x45,
+    0x89, 0x77, 0x1C, 0x49, 0x8B, 0x67, 0x10, 0x89, 0xD0, 0x41, 0x5F, 0x41,
+    0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5B, 0x5D, 0xC3,
+};
+
+// mov eax, imm32; mov edx, imm32; jmp rel32
+static const uint8_t t_leave[] = {
+    0xB8, 0x13, 0x11, 0x11, 0x11, 0xBA, 0x14, 0x11, 0x11, 0x11, 0xE9, 0x00,
+    0x00, 0x00, 0x00,
+};
+#define LEAVE_PC 1
+#define LEAVE_STATUS 6
+#define LEAVE_EXIT 11
+
+// movsx eax, byte [r12-1]; sar eax, 31; mov [r12], al; add r12, 1
+static const uint8_t t_extend[] = {
+    0x41, 0x0F, 0xBE, 0x44, 0x24, 0xFF, 0xC1, 0xF8, 0x1F, 0x41, 0x88, 0x04,
+    0x24, 0x49, 0x83, 0xC4, 0x01,
+};
+
+// mov byte [r12], imm8; add r12, 1
+static const uint8_t t_push8[] = {
+    0x41, 0xC6, 0x04, 0x24, 0x7B, 0x49, 0x83, 0xC4, 0x01,
+};
+#define PUSH8_VALUE 4
+
+// mov word [r12], imm16; add r12, 2
+static const uint8_t t_push16[] = {
+    0x66, 0x41, 0xC7, 0x04, 0x24, 0xCD, 0x7B, 0x49, 0x83, 0xC4, 0x02,
+};
+#define PUSH16_VALUE 5
+
+// sub r12, 1
+static const uint8_t t_pop8[] = {
+    0x49, 0x83, 0xEC, 0x01,
+};
+
+// sub r12, 2
+static const uint8_t t_pop16[] = {
+    0x49, 0x83, 0xEC, 0x02,
+};
+
+// mov rdi, r12; mov ecx, imm32; xor eax, eax; rep stosb; mov r12, rdi
+static const uint8_t t_push_zeros[] = {
+    0x4C, 0x89, 0xE7, 0xB9, 0x13, 0x11, 0x11, 0x11, 0x31, 0xC0, 0xF3, 0xAA,
+    0x49, 0x89, 0xFC,
+};
+#define PUSH_ZEROS_COUNT 4
+
+// movzx ecx, word [r12-3]; mov al, [r12-1]; mov [r13+rcx], al; sub r12, 3
+static const uint8_t t_set8[] = {
+    0x41, 0x0F, 0xB7, 0x4C, 0x24, 0xFD, 0x41, 0x8A, 0x44, 0x24, 0xFF, 0x41,
+    0x88, 0x44, 0x0D, 0x00, 0x49, 0x83, 0xEC, 0x03,
+};
+
+// movzx ecx, word [r12-4]; mov ax, [r12-2]; mov [r13+rcx], ax; sub r12, 4
+static const uint8_t t_set16[] = {
+    0x41, 0x0F, 0xB7, 0x4C, 0x24, 0xFC, 0x66, 0x41, 0x8B, 0x44, 0x24, 0xFE,
+    0x66, 0x41, 0x89, 0x44, 0x0D, 0x00, 0x49, 0x83, 0xEC, 0x04,
+};
+
+// movzx ecx, word [r12-2]; mov al, [r13+rcx]; mov [r12-2], al; sub r12, 1
+static const uint8_t t_get8[] = {
+    0x41, 0x0F, 0xB7, 0x4C, 0x24, 0xFE, 0x41, 0x8A, 0x44, 0x0D, 0x00, 0x41,
+    0x88, 0x44, 0x24, 0xFE, 0x49, 0x83, 0xEC, 0x01,
+};
+
+// movzx ecx, word [r12-2]; mov ax, [r13+rcx]; mov [r12-2], ax
+static const uint8_t t_get16[] = {
+    0x41, 0x0F, 0xB7, 0x4C, 0x24, 0xFE, 0x66, 0x41, 0x8B, 0x44, 0x0D, 0x00,
+    0x66, 0x41, 0x89, 0x44, 0x24, 0xFE,
+};
+
+// mov al, [r13+slot0]; mov [r12], al; add r12, 1
+static const uint8_t t_iget8[] = {
+    0x41, 0x8A, 0x85, 0x10, 0x11, 0x11, 0x11, 0x41, 0x88, 0x04, 0x24, 0x49,
+    0x83, 0xC4, 0x01,
+};
+#define IGET8_SLOT0 3
+
+// mov ax, [r13+slot0]; mov [r12], ax; add r12, 2
+static const uint8_t t_iget16[] = {
+    0x66, 0x41, 0x8B, 0x85, 0x10, 0x11, 0x11, 0x11, 0x66, 0x41, 0x89, 0x04,
+    0x24, 0x49, 0x83, 0xC4, 0x02,
+};
+#define IGET16_SLOT0 4
+
+// mov rdi, r13; mov rsi, r12; mov rax, imm64; mov rbp, rsp; and rsp, -16; call rax; mov rsp, rbp; sub r12, 6
+static const uint8_t t_copy[] = {
+    0x4C, 0x89, 0xEF, 0x4C, 0x89, 0xE6, 0x48, 0xB8, 0x15, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x11, 0x11, 0x48, 0x89, 0xE5, 0x48, 0x83, 0xE4, 0xF0, 0xFF,
+    0xD0, 0x48, 0x89, 0xEC, 0x49, 0x83, 0xEC, 0x06,
+};
+#define COPY_HELPER 8
+
+// neg byte [r12-1]
+static const uint8_t t_neg8[] = {
+    0x41, 0xF6, 0x5C, 0x24, 0xFF,
+};
+
+// neg word [r12-2]
+static const uint8_t t_neg16[] = {
+    0x66, 0x41, 0xF7, 0x5C, 0x24, 0xFE,
+};
+
+// mov al, [r12-1]; add [r12-2], al; sub r12, 1
+static const uint8_t t_add8[] = {
+    0x41, 0x8A, 0x44, 0x24, 0xFF, 0x41, 0x00, 0x44, 0x24, 0xFE, 0x49, 0x83,
+    0xEC, 0x01,
+};
+
+// mov ax, [r12-2]; add [r12-4], ax; sub r12, 2
+static const uint8_t t_add16[] = {
+    0x66, 0x41, 0x8B, 0x44, 0x24, 0xFE, 0x66, 0x41, 0x01, 0x44, 0x24, 0xFC,
+    0x49, 0x83, 0xEC, 0x02,
+};
+
+// mov al, [r12-1]; sub al, [r12-2]; mov [r12-2], al; sub r12, 1
+static const uint8_t t_sub8[] = {
+    0x41, 0x8A, 0x44, 0x24, 0xFF, 0x41, 0x2A, 0x44, 0x24, 0xFE, 0x41, 0x88,
+    0x44, 0x24, 0xFE, 0x49, 0x83, 0xEC, 0x01,
+};
+
+// mov ax, [r12-2]; sub ax, [r12-4]; mov [r12-4], ax; sub r12, 2
+static const uint8_t t_sub16[] = {
+    0x66, 0x41, 0x8B, 0x44, 0x24, 0xFE, 0x66, 0x41, 0x2B, 0x44, 0x24, 0xFC,
+    0x66, 0x41, 0x89, 0x44, 0x24, 0xFC, 0x49, 0x83, 0xEC, 0x02,
+};
+
+// mov al, [r12-1]; mul byte [r12-2]; mov [r12-2], al; sub r12, 1
+static const uint8_t t_mul8[] = {
+    0x41, 0x8A, 0x44, 0x24, 0xFF, 0x41, 0xF6, 0x64, 0x24, 0xFE, 0x41, 0x88,
+    0x44, 0x24, 0xFE, 0x49, 0x83, 0xEC, 0x01,
+};
+
+// mov ax, [r12-2]; mul word [r12-4]; mov [r12-4], ax; sub r12, 2
+static const uint8_t t_mul16[] = {
+    0x66, 0x41, 0x8B, 0x44, 0x24, 0xFE, 0x66, 0x41, 0xF7, 0x64, 0x24, 0xFC,
+    0x66, 0x41, 0x89, 0x44, 0x24, 0xFC, 0x49, 0x83, 0xEC, 0x02,
+};
+
+// movzx eax, byte [r12-1]; movzx ecx, byte [r12-2]; test ecx, ecx; jnz 1f; mov eax, imm32; mov edx, imm32; jmp rel32; 1: xor edx, edx; div ecx; mov [r12-2], al; sub r12, 1
+static const uint8_t t_div8[] = {
+    0x41, 0x0F, 0xB6, 0x44, 0x24, 0xFF, 0x41, 0x0F, 0xB6, 0x4C, 0x24, 0xFE,
+    0x85, 0xC9, 0x75, 0x0F, 0xB8, 0x13, 0x11, 0x11, 0x11, 0xBA, 0x14, 0x11,
+    0x11, 0x11, 0xE9, 0x00, 0x00, 0x00, 0x00, 0x31, 0xD2, 0xF7, 0xF1, 0x41,
+    0x88, 0x44, 0x24, 0xFE, 0x49, 0x83, 0xEC, 0x01,
+};
+#define DIV8_PC 17
+#define DIV8_STATUS 22
+#define DIV8_EXIT 27
+
+// movzx eax, word [r12-2]; movzx ecx, word [r12-4]; test ecx, ecx; jnz 1f; mov eax, imm32; mov edx, imm32; jmp rel32; 1: xor edx, edx; div ecx; mov [r12-4], ax; sub r12, 2
+static const uint8_t t_div16[] = {
+    0x41, 0x0F, 0xB7, 0x44, 0x24, 0xFE, 0x41, 0x0F, 0xB7, 0x4C, 0x24, 0xFC,
+    0x85, 0xC9, 0x75, 0x0F, 0xB8, 0x13, 0x11, 0x11, 0x11, 0xBA, 0x14, 0x11,
+    0x11, 0x11, 0xE9, 0x00, 0x00, 0x00, 0x00, 0x31, 0xD2, 0xF7, 0xF1, 0x66,
+    0x41, 0x89, 0x44, 0x24, 0xFC, 0x49, 0x83, 0xEC, 0x02,
+};
+#define DIV16_PC 17
+#define DIV16_STATUS 22
+#define DIV16_EXIT 27
+
+// mov al, [r12-1]; mov [r13+slot0], al; sub r12, 1
+static const uint8_t t_seti8[] = {
+    0x41, 0x8A, 0x44, 0x24, 0xFF, 0x41, 0x88, 0x85, 0x10, 0x11, 0x11, 0x11,
+    0x49, 0x83, 0xEC, 0x01,
+};
+#define SETI8_SLOT0 8
+
+// mov ax, [r12-2]; mov [r13+slot0], ax; sub r12, 2
+static const uint8_t t_seti16[] = {
+    0x66, 0x41, 0x8B, 0x44, 0x24, 0xFE, 0x66, 0x41, 0x89, 0x85, 0x10, 0x11,
+    0x11, 0x11, 0x49, 0x83, 0xEC, 0x02,
+};
+#define SETI16_SLOT0 10
+
+// add byte [r12-1], imm8
+static const uint8_t t_addi8[] = {
+    0x41, 0x80, 0x44, 0x24, 0xFF, 0x7B,
+};
+#define ADDI8_VALUE 5
+
+// add word [r12-2], imm16
+static const uint8_t t_addi16[] = {
+    0x66, 0x41, 0x81, 0x44, 0x24, 0xFE, 0xCD, 0x7B,
+};
+#define ADDI16_VALUE 6
+
+// mov al, [r13+slot0]; add [r12-1], al
+static const uint8_t t_iget_add8[] = {
+    0x41, 0x8A, 0x85, 0x10, 0x11, 0x11, 0x11, 0x41, 0x00, 0x44, 0x24, 0xFF,
+};
+#define IGET_ADD8_SLOT0 3
+
+// mov ax, [r13+slot0]; add [r12-2], ax
+static const uint8_t t_iget_add16[] = {
+    0x66, 0x41, 0x8B, 0x85, 0x10, 0x11, 0x11, 0x11, 0x66, 0x41, 0x01, 0x44,
+    0x24, 0xFE,
+};
+#define IGET_ADD16_SLOT0 4
+
+// mov al, [r13+slot0]; mul byte [r12-1]; mov [r12-1], al
+static const uint8_t t_iget_mul8[] = {
+    0x41, 0x8A, 0x85, 0x10, 0x11, 0x11, 0x11, 0x41, 0xF6, 0x64, 0x24, 0xFF,
+    0x41, 0x88, 0x44, 0x24, 0xFF,
+};
+#define IGET_MUL8_SLOT0 3
+
+// mov ax, [r13+slot0]; mul word [r12-2]; mov [r12-2], ax
+static const uint8_t t_iget_mul16[] = {
+    0x66, 0x41, 0x8B, 0x85, 0x10, 0x11, 0x11, 0x11, 0x66, 0x41, 0xF7, 0x64,
+    0x24, 0xFE, 0x66, 0x41, 0x89, 0x44, 0x24, 0xFE,
+};
+#define IGET_MUL16_SLOT0 4
+
+// mov al, [r13+slot1]; mov [r13+slot0], al
+static const uint8_t t_slot_mov8[] = {
+    0x41, 0x8A, 0x85, 0x11, 0x11, 0x11, 0x11, 0x41, 0x88, 0x85, 0x10, 0x11,
+    0x11, 0x11,
+};
+#define SLOT_MOV8_SLOT1 3
+#define SLOT_MOV8_SLOT0 10
+
+// mov al, [r13+slot1]; add al, [r13+slot2]; mov [r13+slot0], al
+static const uint8_t t_slot_add8[] = {
+    0x41, 0x8A, 0x85, 0x11, 0x11, 0x11, 0x11, 0x41, 0x02, 0x85, 0x12, 0x11,
+    0x11, 0x11, 0x41, 0x88, 0x85, 0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_ADD8_SLOT1 3
+#define SLOT_ADD8_SLOT2 10
+#define SLOT_ADD8_SLOT0 17
+
+// mov al, [r13+slot1]; sub al, [r13+slot2]; mov [r13+slot0], al
+static const uint8_t t_slot_sub8[] = {
+    0x41, 0x8A, 0x85, 0x11, 0x11, 0x11, 0x11, 0x41, 0x2A, 0x85, 0x12, 0x11,
+    0x11, 0x11, 0x41, 0x88, 0x85, 0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_SUB8_SLOT1 3
+#define SLOT_SUB8_SLOT2 10
+#define SLOT_SUB8_SLOT0 17
+
+// mov al, [r13+slot1]; mul byte [r13+slot2]; mov [r13+slot0], al
+static const uint8_t t_slot_mul8[] = {
+    0x41, 0x8A, 0x85, 0x11, 0x11, 0x11, 0x11, 0x41, 0xF6, 0xA5, 0x12, 0x11,
+    0x11, 0x11, 0x41, 0x88, 0x85, 0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_MUL8_SLOT1 3
+#define SLOT_MUL8_SLOT2 10
+#define SLOT_MUL8_SLOT0 17
+
+// movzx eax, byte [r13+slot1]; movzx ecx, byte [r13+slot2]; test ecx, ecx; jnz 1f; mov eax, imm32; mov edx, imm32; jmp rel32; 1: xor edx, edx; div ecx; mov [r13+slot0], al
+static const uint8_t t_slot_div8[] = {
+    0x41, 0x0F, 0xB6, 0x85, 0x11, 0x11, 0x11, 0x11, 0x41, 0x0F, 0xB6, 0x8D,
+    0x12, 0x11, 0x11, 0x11, 0x85, 0xC9, 0x75, 0x0F, 0xB8, 0x13, 0x11, 0x11,
+    0x11, 0xBA, 0x14, 0x11, 0x11, 0x11, 0xE9, 0x00, 0x00, 0x00, 0x00, 0x31,
+    0xD2, 0xF7, 0xF1, 0x41, 0x88, 0x85, 0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_DIV8_SLOT1 4
+#define SLOT_DIV8_SLOT2 12
+#define SLOT_DIV8_PC 21
+#define SLOT_DIV8_STATUS 26
+#define SLOT_DIV8_EXIT 31
+#define SLOT_DIV8_SLOT0 42
+
+// mov ax, [r13+slot1]; mov [r13+slot0], ax
+static const uint8_t t_slot_mov16[] = {
+    0x66, 0x41, 0x8B, 0x85, 0x11, 0x11, 0x11, 0x11, 0x66, 0x41, 0x89, 0x85,
+    0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_MOV16_SLOT1 4
+#define SLOT_MOV16_SLOT0 12
+
+// mov ax, [r13+slot1]; add ax, [r13+slot2]; mov [r13+slot0], ax
+static const uint8_t t_slot_add16[] = {
+    0x66, 0x41, 0x8B, 0x85, 0x11, 0x11, 0x11, 0x11, 0x66, 0x41, 0x03, 0x85,
+    0x12, 0x11, 0x11, 0x11, 0x66, 0x41, 0x89, 0x85, 0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_ADD16_SLOT1 4
+#define SLOT_ADD16_SLOT2 12
+#define SLOT_ADD16_SLOT0 20
+
+// mov ax, [r13+slot1]; sub ax, [r13+slot2]; mov [r13+slot0], ax
+static const uint8_t t_slot_sub16[] = {
+    0x66, 0x41, 0x8B, 0x85, 0x11, 0x11, 0x11, 0x11, 0x66, 0x41, 0x2B, 0x85,
+    0x12, 0x11, 0x11, 0x11, 0x66, 0x41, 0x89, 0x85, 0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_SUB16_SLOT1 4
+#define SLOT_SUB16_SLOT2 12
+#define SLOT_SUB16_SLOT0 20
+
+// mov ax, [r13+slot1]; mul word [r13+slot2]; mov [r13+slot0], ax
+static const uint8_t t_slot_mul16[] = {
+    0x66, 0x41, 0x8B, 0x85, 0x11, 0x11, 0x11, 0x11, 0x66, 0x41, 0xF7, 0xA5,
+    0x12, 0x11, 0x11, 0x11, 0x66, 0x41, 0x89, 0x85, 0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_MUL16_SLOT1 4
+#define SLOT_MUL16_SLOT2 12
+#define SLOT_MUL16_SLOT0 20
+
+// movzx eax, word [r13+slot1]; movzx ecx, word [r13+slot2]; test ecx, ecx; jnz 1f; mov eax, imm32; mov edx, imm32; jmp rel32; 1: xor edx, edx; div ecx; mov [r13+slot0], ax
+static const uint8_t t_slot_div16[] = {
+    0x41, 0x0F, 0xB7, 0x85, 0x11, 0x11, 0x11, 0x11, 0x41, 0x0F, 0xB7, 0x8D,
+    0x12, 0x11, 0x11, 0x11, 0x85, 0xC9, 0x75, 0x0F, 0xB8, 0x13, 0x11, 0x11,
+    0x11, 0xBA, 0x14, 0x11, 0x11, 0x11, 0xE9, 0x00, 0x00, 0x00, 0x00, 0x31,
+    0xD2, 0xF7, 0xF1, 0x66, 0x41, 0x89, 0x85, 0x10, 0x11, 0x11, 0x11,
+};
+#define SLOT_DIV16_SLOT1 4
+#define SLOT_DIV16_SLOT2 12
+#define SLOT_DIV16_PC 21
+#define SLOT_DIV16_STATUS 26
+#define SLOT_DIV16_EXIT 31
+#define SLOT_DIV16_SLOT0 43
+
+// jmp rel32
+static const uint8_t t_ijump[] = {
+    0xE9, 0x00, 0x00, 0x00, 0x00,
+};
+#define IJUMP_TARGET 1
+
+// sub r14d, 1; jnz rel32; mov eax, imm32; mov edx, imm32; jmp rel32
+static const uint8_t t_ijump_back[] = {
+    0x41, 0x83, 0xEE, 0x01, 0x0F, 0x85, 0x00, 0x00, 0x00, 0x00, 0xB8, 0x13,
+    0x11, 0x11, 0x11, 0xBA, 0x14, 0x11, 0x11, 0x11, 0xE9, 0x00, 0x00, 0x00,
+    0x00,
+};
+#define IJUMP_BACK_TARGET 6
+#define IJUMP_BACK_PC 11
+#define IJUMP_BACK_STATUS 16
+#define IJUMP_BACK_EXIT 21
+
+// add r13, imm32; sub r14d, 1; jnz 1f; mov eax, imm32; mov edx, imm32; jmp rel32; 1: call rel32
+static const uint8_t t_call[] = {
+    0x49, 0x81, 0xC5, 0x13, 0x11, 0x11, 0x11, 0x41, 0x83, 0xEE, 0x01, 0x75,
+    0x0F, 0xB8, 0x13, 0x11, 0x11, 0x11, 0xBA, 0x14, 0x11, 0x11, 0x11, 0xE9,
+    0x00, 0x00, 0x00, 0x00, 0xE8, 0x00, 0x00, 0x00, 0x00,
+};
+#define CALL_FP_CHANGE 3
+#define CALL_PC 14
+#define CALL_STATUS 19
+#define CALL_EXIT 24
+#define CALL_TARGET 29
+
+// movzx eax, word [r12-2]; sub r13, rax; sub r12, imm8; ret
+static const uint8_t t_ret[] = {
+    0x41, 0x0F, 0xB7, 0x44, 0x24, 0xFE, 0x49, 0x29, 0xC5, 0x49, 0x83, 0xEC,
+    0x7B, 0xC3,
+};
+#define RET_POPPED 12
+
+// mov rdi, r12; mov rsi, imm64; mov rax, imm64; mov rbp, rsp; and rsp, -16; call rax; mov rsp, rbp; test al, al; jnz 1f; mov eax, imm32; mov edx, imm32; jmp rel32; 1:
+static const uint8_t t_test[] = {
+    0x4C, 0x89, 0xE7, 0x48, 0xBE, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x48, 0xB8, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x48,
+    0x89, 0xE5, 0x48, 0x83, 0xE4, 0xF0, 0xFF, 0xD0, 0x48, 0x89, 0xEC, 0x84,
+    0xC0, 0x75, 0x0F, 0xB8, 0x13, 0x11, 0x11, 0x11, 0xBA, 0x14, 0x11, 0x11,
+    0x11, 0xE9, 0x00, 0x00, 0x00, 0x00,
+};
+#define TEST_VALUES 5
+#define TEST_HELPER 15
+#define TEST_PC 40
+#define TEST_STATUS 45
+#define TEST_EXIT 50
+
+
+  /////////////
+ // helpers //
+/////////////
+
+static uint16_t operand16(const uint8_t* at) {
+    return (at[0] << 8) | at[1];
+}
+
+static addr_t operand_addr(const uint8_t* at) {
+    #ifdef SHABBY_WIDE
+        return ((addr_t)operand16(at) << 16) | operand16(&at[2]);
+    #else
+        return operand16(at);
+    #endif
+}
+
+static uint16_t load16(const uint8_t* ptr) {
+    uint16_t value;
+    memcpy(&value, ptr, sizeof(uint16_t));
+    return value;
+}
+
+// called from native code, the ranges can overlap
+static void jit_copy(uint8_t* frame, uint8_t* top) {
+    uint16_t from = load16(&top[-2]);
+    uint16_t to = load16(&top[-4]);
+    uint16_t size = load16(&top[-6]);
+    memmove(&frame[to], &frame[from], size);
+}
+
+// called from native code, reports like the interpreter's test
+static bool jit_test(const uint8_t* top, const uint8_t* at) {
+    uint16_t count = operand16(&at[1]);
+    bool passed = TRUE;
+    for (uint16_t i = 0; i < count; i++) {
+        int8_t c = (int8_t)at[3 + i];
+        int8_t value = (int8_t)top[i - count];
+        if (value != c) {
+            fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", c, value);
+            passed = FALSE;
+        }
+    }
+    return passed;
+}
+
+  /////////////
+ // builder //
+/////////////
+
+// instructions that only need their frame slots patched in
+typedef struct {
+    const uint8_t* bytes;
+    uint8_t size;
+    uint8_t slots;
+    uint8_t slot[3]; // patch offsets in operand order
+} template_s;
+
+#define TEMPLATE(name, slots, ...) { t_##name, sizeof(t_##name), slots, { __VA_ARGS__ } }
+
+static const template_s templates[256] = {
+    [BC_EXTEND] = TEMPLATE(extend, 0, 0),
+    [BC_POP8] = TEMPLATE(pop8, 0, 0),
+    [BC_POP16] = TEMPLATE(pop16, 0, 0),
+
+    [BC_SET8] = TEMPLATE(set8, 0, 0),
+    [BC_SET16] = TEMPLATE(set16, 0, 0),
+    [BC_GET8] = TEMPLATE(get8, 0, 0),
+    [BC_GET16] = TEMPLATE(get16, 0, 0),
+    [BC_IGET8] = TEMPLATE(iget8, 1, IGET8_SLOT0),
+    [BC_IGET16] = TEMPLATE(iget16, 1, IGET16_SLOT0),
+
+    [BC_NEG8] = TEMPLATE(neg8, 0, 0),
+    [BC_ADD8] = TEMPLATE(add8, 0, 0),
+    [BC_SUB8] = TEMPLATE(sub8, 0, 0),
+    [BC_MUL8] = TEMPLATE(mul8, 0, 0),
+    [BC_DIV8] = TEMPLATE(div8, 0, 0),
+
+    [BC_NEG16] = TEMPLATE(neg16, 0, 0),
+    [BC_ADD16] = TEMPLATE(add16, 0, 0),
+    [BC_SUB16] = TEMPLATE(sub16, 0, 0),
+    [BC_MUL16] = TEMPLATE(mul16, 0, 0),
+    [BC_DIV16] = TEMPLATE(div16, 0, 0),
+
+    [BC_SETI8] = TEMPLATE(seti8, 1, SETI8_SLOT0),
+    [BC_SETI16] = TEMPLATE(seti16, 1, SETI16_SLOT0),
+    [BC_IGET_ADD8] = TEMPLATE(iget_add8, 1, IGET_ADD8_SLOT0),
+    [BC_IGET_ADD16] = TEMPLATE(iget_add16, 1, IGET_ADD16_SLOT0),
+    [BC_IGET_MUL8] = TEMPLATE(iget_mul8, 1, IGET_MUL8_SLOT0),
+    [BC_IGET_MUL16] = TEMPLATE(iget_mul16, 1, IGET_MUL16_SLOT0),
+
+    [BC_SLOT_MOV8] = TEMPLATE(slot_mov8, 2, SLOT_MOV8_SLOT0, SLOT_MOV8_SLOT1),
+    [BC_SLOT_MOV16] = TEMPLATE(slot_mov16, 2, SLOT_MOV16_SLOT0, SLOT_MOV16_SLOT1),
+    [BC_SLOT_ADD8] = TEMPLATE(slot_add8, 3, SLOT_ADD8_SLOT0, SLOT_ADD8_SLOT1, SLOT_ADD8_SLOT2),
+    [BC_SLOT_ADD16] = TEMPLATE(slot_add16, 3, SLOT_ADD16_SLOT0, SLOT_ADD16_SLOT1, SLOT_ADD16_SLOT2),
+    [BC_SLOT_SUB8] = TEMPLATE(slot_sub8, 3, SLOT_SUB8_SLOT0, SLOT_SUB8_SLOT1, SLOT_SUB8_SLOT2),
+    [BC_SLOT_SUB16] = TEMPLATE(slot_sub16, 3, SLOT_SUB16_SLOT0, SLOT_SUB16_SLOT1, SLOT_SUB16_SLOT2),
+    [BC_SLOT_MUL8] = TEMPLATE(slot_mul8, 3, SLOT_MUL8_SLOT0, SLOT_MUL8_SLOT1, SLOT_MUL8_SLOT2),
+    [BC_SLOT_MUL16] = TEMPLATE(slot_mul16, 3, SLOT_MUL16_SLOT0, SLOT_MUL16_SLOT1, SLOT_MUL16_SLOT2),
+    [BC_SLOT_DIV8] = TEMPLATE(slot_div8, 3, SLOT_DIV8_SLOT0, SLOT_DIV8_SLOT1, SLOT_DIV8_SLOT2),
+    [BC_SLOT_DIV16] = TEMPLATE(slot_div16, 3, SLOT_DIV16_SLOT0, SLOT_DIV16_SLOT1, SLOT_DIV16_SLOT2),
+};
+
+#undef TEMPLATE
+
+// the same walk measures the code first and writes it second, once every template's offset is known
+typedef struct {
+    const uint8_t* code;
+    addr_t size;
+    bool* boundaries; // where instructions start, the sentinel included
+    uint32_t* native; // offset of each instruction's template
+    uint8_t* out; // NULL while measuring
+    uint32_t at;
+} builder_s;
+
+// the exit every template leaves through sits right after the entry
+#define EXIT_OFFSET sizeof(t_enter)
+
+static uint32_t paste(builder_s* b, const uint8_t* bytes, uint32_t size) {
+    uint32_t start = b->at;
+    if (b->out != NULL) { memcpy(&b->out[start], bytes, size); }
+    b->at += size;
+    return start;
+}
+
+#define PASTE(b, name) paste(b, t_##name, sizeof(t_##name))
+
+// operands are little endian like the host
+static void patch(builder_s* b, uint32_t at, uint64_t value, uint8_t size) {
+    if (b->out != NULL) { memcpy(&b->out[at], &value, size); }
+}
+
+static void patch_rel32(builder_s* b, uint32_t at, uint32_t target) {
+    patch(b, at, target - (at + 4), 4);
+}
+
+static void patch_exit(builder_s* b, uint32_t start, uint32_t pc_at, uint32_t pc, uint32_t status_at, jit_status_t status, uint32_t exit_at) {
+    patch(b, start + pc_at, pc, 4);
+    patch(b, start + status_at, status, 4);
+    patch_rel32(b, start + exit_at, EXIT_OFFSET);
+}
+
+static void leave(builder_s* b, addr_t pc, jit_status_t status) {
+    uint32_t start = PASTE(b, leave);
+    patch_exit(b, start, LEAVE_PC, pc, LEAVE_STATUS, status, LEAVE_EXIT);
+}
+
+static void push16(builder_s* b, uint16_t value) {
+    uint32_t start = PASTE(b, push16);
+    patch(b, start + PUSH16_VALUE, value, 2);
+}
+
+// pastes an instruction's template with its frame slots patched in
+static uint32_t paste_template(builder_s* b, const uint8_t* at) {
+    const template_s* template = &templates[at[0]];
+    uint32_t start = paste(b, template->bytes, template->size);
+    for (uint8_t i = 0; i < template->slots; i++) {
+        patch(b, start + template->slot[i], operand16(&at[1 + i * 2]), 4);
+    }
+    return start;
+}
+
+static bool jumpable(builder_s* b, addr_t target) {
+    return target <= b->size && b->boundaries[target];
+}
+
+// compact forms translate as the long forms they stand for
+static void translate(builder_s* b, addr_t pc) {
+    uint8_t expanded[BC_EXPANDED_SIZE];
+    const uint8_t* at = bytecode_expand(&b->code[pc], expanded);
+    uint32_t length = 1;
+    if (pc < b->size) { bytecode_length(&b->code[pc], b->size - pc, &length); }
+    uint32_t start;
+    switch (at[0]) {
+        case BC_NOOP: break;
+
+        case BC_IJUMP: {
+            addr_t target = operand_addr(&at[1]);
+            if (!jumpable(b, target)) { leave(b, pc, JIT_INTERPRET); break; }
+            if (target > pc) {
+                start = PASTE(b, ijump);
+                patch_rel32(b, start + IJUMP_TARGET, b->native[target]);
+                break;
+            }
+            // backward jumps spend fuel like the interpreter's
+            start = PASTE(b, ijump_back);
+            patch_rel32(b, start + IJUMP_BACK_TARGET, b->native[target]);
+            patch_exit(b, start, IJUMP_BACK_PC, target, IJUMP_BACK_STATUS, JIT_YIELDED, IJUMP_BACK_EXIT);
+            break;
+        }
+
+        case BC_CALL: {
+            uint16_t fp_change = (uint16_t)operand_addr(&at[1]);
+            addr_t target = operand_addr(&at[1 + BC_ADDR]);
+            if (!jumpable(b, target)) { leave(b, pc, JIT_INTERPRET); break; }
+            // the exec stack gets what the interpreter's call pushes, low half of the pc last
+            addr_t ret = pc + length;
+            #ifdef SHABBY_WIDE
+                push16(b, (uint16_t)(ret >> 16));
+            #endif
+            push16(b, (uint16_t)ret);
+            push16(b, fp_change);
+            start = PASTE(b, call);
+            patch(b, start + CALL_FP_CHANGE, fp_change, 4);
+            patch_exit(b, start, CALL_PC, target, CALL_STATUS, JIT_YIELDED, CALL_EXIT);
+            patch_rel32(b, start + CALL_TARGET, b->native[target]);
+            break;
+        }
+
+        case BC_RET:
+            start = PASTE(b, ret);
+            patch(b, start + RET_POPPED, ADDR_SIZE + 2, 1);
+            break;
+
+        case BC_PUSH_ZEROS:
+            start = PASTE(b, push_zeros);
+            patch(b, start + PUSH_ZEROS_COUNT, operand16(&at[1]), 4);
+            break;
+
+        case BC_PUSH8:
+            start = PASTE(b, push8);
+            patch(b, start + PUSH8_VALUE, at[1], 1);
+            break;
+        case BC_PUSH16:
+            push16(b, operand16(&at[1]));
+            break;
+
+        case BC_ADDI8:
+            start = PASTE(b, addi8);
+            patch(b, start + ADDI8_VALUE, at[1], 1);
+            break;
+        case BC_ADDI16:
+            start = PASTE(b, addi16);
+            patch(b, start + ADDI16_VALUE, operand16(&at[1]), 2);
+            break;
+
+        case BC_COPY:
+            start = PASTE(b, copy);
+            patch(b, start + COPY_HELPER, (uintptr_t)jit_copy, 8);
+            break;
+
+        case BC_TEST: {
+            start = PASTE(b, test);
+            patch(b, start + TEST_VALUES, (uintptr_t)at, 8);
+            patch(b, start + TEST_HELPER, (uintptr_t)jit_test, 8);
+            // a failed test faults with the pc past it, like the interpreter
+            patch_exit(b, start, TEST_PC, pc + length, TEST_STATUS, JIT_FAULTED, TEST_EXIT);
+            break;
+        }
+
+        case (uint8_t)BC_EOF:
+            leave(b, pc, JIT_FINISHED);
+            break;
+
+        // a zero divisor leaves before anything changed, the interpreter runs the divide again and faults
+        case BC_DIV8:
+            start = paste_template(b, at);
+            patch_exit(b, start, DIV8_PC, pc, DIV8_STATUS, JIT_INTERPRET, DIV8_EXIT);
+            break;
+        case BC_DIV16:
+            start = paste_template(b, at);
+            patch_exit(b, start, DIV16_PC, pc, DIV16_STATUS, JIT_INTERPRET, DIV16_EXIT);
+            break;
+        case BC_SLOT_DIV8:
+            start = paste_template(b, at);
+            patch_exit(b, start, SLOT_DIV8_PC, pc, SLOT_DIV8_STATUS, JIT_INTERPRET, SLOT_DIV8_EXIT);
+            break;
+        case BC_SLOT_DIV16:
+            start = paste_template(b, at);
+            patch_exit(b, start, SLOT_DIV16_PC, pc, SLOT_DIV16_STATUS, JIT_INTERPRET, SLOT_DIV16_EXIT);
+            break;
+
+        // runtime jumps, frame pointer changes and anything unknown stay with the interpreter
+        default:
+            if (templates[at[0]].bytes == NULL) { leave(b, pc, JIT_INTERPRET); break; }
+            paste_template(b, at);
+            break;
+    }
+}
+
+static void build(builder_s* b) {
+    b->at = 0;
+    PASTE(b, enter);
+    PASTE(b, exit);
+    uint32_t length = 1;
+    for (uint32_t pc = 0; pc <= b->size; pc += length) {
+        b->native[pc] = b->at;
+        translate(b, pc);
+        if (pc < b->size) { bytecode_length(&b->code[pc], b->size - pc, &length); }
+    }
+}
+
+  /////////
+ // api //
+/////////
+
+jit_code_t* jit_compile(const uint8_t* code, addr_t size) {
+    builder_s b = {
+        .code = code,
+        .size = size,
+        .boundaries = calloc((size_t)size + 1, sizeof(bool)),
+        .native = calloc((size_t)size + 1, sizeof(uint32_t)),
+    };
+    assert(b.boundaries != NULL && b.native != NULL);
+
+    // verified code always decodes
+    uint32_t length;
+    for (uint32_t pc = 0; pc < size; pc += length) {
+        bool decoded = bytecode_length(&code[pc], size - pc, &length);
+        assert(decoded);
+        (void)decoded;
+        b.boundaries[pc] = TRUE;
+    }
+    b.boundaries[size] = TRUE;
+
+    build(&b);
+    jit_code_t* jit = malloc(sizeof(jit_code_t));
+    assert(jit != NULL);
+    jit->size = b.at;
+    jit->entry = b.native[0];
+    jit->memory = mmap(NULL, jit->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (jit->memory == MAP_FAILED) {
+        free(jit);
+        jit = NULL;
+    } else {
+        b.out = jit->memory;
+        build(&b);
+        mprotect(jit->memory, jit->size, PROT_READ | PROT_EXEC);
+    }
+
+    free(b.boundaries);
+    free(b.native);
+    return jit;
+}
+
+jit_status_t jit_run(const jit_code_t* jit, jit_context_s* context) {
+    // the entry template is a function taking the context and where to start
+    jit_status_t (*enter)(jit_context_s*, const uint8_t*);
+    void* memory = jit->memory;
+    memcpy(&enter, &memory, sizeof(enter));
+    return enter(context, &jit->memory[jit->entry]);
+}
+
+void jit_free(jit_code_t* jit) {
+    if (jit == NULL) { return; }
+    munmap(jit->memory, jit->size);
+    free(jit);
+}
+
+#else
+
+  /////////
+ // api //
+/////////
+
+// other hosts always interpret
+jit_code_t* jit_compile(const uint8_t* code, addr_t size) {
+    (void)code;
+    (void)size;
+    return NULL;
+}
+
+jit_status_t jit_run(const jit_code_t* jit, jit_context_s* context) {
+    (void)jit;
+    (void)context;
+    return JIT_INTERPRET;
+}
+
+void jit_free(jit_code_t* jit) {
+    (void)jit;
+}
+
+#endif
@@ -4,118 +4,615 @@
 #include <assert.h>
 #include <stdarg.h>
 #include "file.h"
+#include "stages.h"
 #include "bytecode.h"
+#include "image.h"
+#include "verify.h"
+#include "trace.h"
 
   ///////////////////
  // file pointers //
 ///////////////////
 
-static FILE *gen_ptr = NULL; // generated bytecode
-static FILE *bin_ptr = NULL; // binary output
+static thread_local FILE *gen_ptr = NULL; // generated bytecode
+static thread_local FILE *bin_ptr = NULL; // binary output
 
   ////////////////////
  // label tracking //
 ////////////////////
 
-#define MAX_LABELS 128
-
+// open addressed hash table keyed by label id, grows to stay at most half full
 typedef struct {
-    uint16_t label;
-    uint16_t offset;
+    addr_t label;
+    addr_t offset;
+    bool used;
 } label_s;
-static label_s labels[MAX_LABELS] = { 0 };
-static uint8_t on_label = 0;
-
-static void label_remember(uint16_t label, uint16_t offset) {
-    assert(on_label < MAX_LABELS);
-    labels[on_label].label = label;
-    labels[on_label].offset = offset;
-    printf("remembering label: %04X -> %04X\n", label, offset);
-    on_label++;
-}
-
-static label_s* label_get(uint16_t label) {
-    for (uint16_t i = 0; i < on_label; i++) {
-        if (labels[i].label == label) {
-            printf("retrieved label: %04X -> %04X\n", label, labels[i].offset);
-            return &labels[i];
-        }
+static thread_local label_s* labels = NULL;
+static thread_local uint32_t label_count = 0;
+static thread_local uint32_t label_capacity = 0;
+
+static uint32_t label_hash(addr_t label) {
+    return ((uint32_t)label * 2654435761u) & (label_capacity - 1);
+}
+
+static label_s* label_slot(addr_t label) {
+    uint32_t i = label_hash(label);
+    while (labels[i].used && labels[i].label != label) {
+        i = (i + 1) & (label_capacity - 1);
     }
-    printf("could not find label: %04X!\n", label);
+    return &labels[i];
+}
+
+static void label_grow(void) {
+    label_s* old = labels;
+    uint32_t old_capacity = label_capacity;
+    label_capacity = (label_capacity == 0) ? 64 : label_capacity * 2;
+    labels = calloc(label_capacity, sizeof(label_s));
+    assert(labels != NULL);
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        if (old[i].used) { *label_slot(old[i].label) = old[i]; }
+    }
+    free(old);
+}
+
+// TRUE if the label is new or moved, compact code places them over and over until none move
+static bool label_place(addr_t label, addr_t offset) {
+    if ((label_count + 1) * 2 > label_capacity) { label_grow(); }
+    label_s* slot = label_slot(label);
+    if (slot->used && slot->offset == offset) { return FALSE; }
+    if (!slot->used) { label_count++; }
+    slot->label = label;
+    slot->offset = offset;
+    slot->used = TRUE;
+    return TRUE;
+}
+
+// where a label is as far as the layout knows, labels it hasn't reached yet start out at zero
+static addr_t label_offset(addr_t label) {
+    label_s* slot = (label_capacity > 0) ? label_slot(label) : NULL;
+    return (slot != NULL && slot->used) ? slot->offset : 0;
+}
+
+static label_s* label_get(addr_t label) {
+    label_s* slot = (label_capacity > 0) ? label_slot(label) : NULL;
+    if (slot != NULL && slot->used) {
+        TRACE(TRACE_STEPS, "retrieved label: %04X -> %04X\n", (uint32_t)label, (uint32_t)slot->offset);
+        return slot;
+    }
+    fprintf(stderr, "could not find label: %04X!\n", (uint32_t)label);
     return NULL;
 }
 
-  /////////////////////
- // jump resolution //
-/////////////////////
+static void labels_free(void) {
+    free(labels);
+    labels = NULL;
+    label_count = 0;
+    label_capacity = 0;
+}
 
-void jump_resolution(FILE* gen_ptr_arg, FILE* bin_ptr_arg) {
-    gen_ptr = gen_ptr_arg;
-    bin_ptr = bin_ptr_arg;
+  ////////////
+ // output //
+////////////
+
+// the binary is built in memory and written out once it is patched
+static thread_local buffer_s code = { 0 };
+
+static void code_put8(uint8_t value) {
+    if (code.size >= code.capacity) {
+        code.capacity = (code.capacity == 0) ? 256 : code.capacity * 2;
+        code.data = realloc(code.data, code.capacity);
+        assert(code.data != NULL);
+    }
+    code.data[code.size++] = value;
+}
+
+static void code_put16(uint16_t value) {
+    code_put8(value >> 8);
+    code_put8(value & 0xFF);
+}
+
+static void code_put32(uint32_t value) {
+    code_put16(value >> 16);
+    code_put16(value & 0xFFFF);
+}
+
+// params are 1, 2 or 4 bytes big endian
+static void code_put(uint32_t value, uint8_t size) {
+    switch (size) {
+        case 1: code_put8((uint8_t)value); break;
+        case 2: code_put16((uint16_t)value); break;
+        case 4: code_put32(value); break;
+        default: assert(FALSE);
+    }
+}
+
+// leb128, seven bits a byte with the low ones first
+static void code_put_varint(uint32_t value) {
+    while (value >= 0x80) {
+        code_put8((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    code_put8(value);
+}
+
+static uint32_t varint_size(uint32_t value) {
+    uint32_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+  /////////////
+ // entries //
+/////////////
+
+// the program starts at zero and every class label is a constructor
+static thread_local image_entry_s* entries = NULL;
+static thread_local uint32_t entry_count = 0;
+static thread_local uint32_t entry_capacity = 0;
+
+static void entry_add(entry_t type, addr_t id, addr_t offset) {
+    if (entry_count >= entry_capacity) {
+        entry_capacity = (entry_capacity == 0) ? 16 : entry_capacity * 2;
+        entries = realloc(entries, entry_capacity * sizeof(image_entry_s));
+        assert(entries != NULL);
+    }
+    entries[entry_count++] = (image_entry_s){ .type = type, .id = id, .offset = offset };
+}
+
+static void entries_free(void) {
+    free(entries);
+    entries = NULL;
+    entry_count = 0;
+    entry_capacity = 0;
+}
+
+  /////////////
+ // layouts //
+/////////////
+
+// instance sizes of every class, for the rodata section
+static thread_local image_layout_s* layouts = NULL;
+static thread_local uint32_t layout_count = 0;
+static thread_local uint32_t layout_capacity = 0;
+
+static void layout_add(addr_t id, addr_t bytes) {
+    if (layout_count >= layout_capacity) {
+        layout_capacity = (layout_capacity == 0) ? 16 : layout_capacity * 2;
+        layouts = realloc(layouts, layout_capacity * sizeof(image_layout_s));
+        assert(layouts != NULL);
+    }
+    layouts[layout_count++] = (image_layout_s){ .id = id, .bytes = bytes };
+}
+
+static void layouts_free(void) {
+    free(layouts);
+    layouts = NULL;
+    layout_count = 0;
+    layout_capacity = 0;
+}
+
+  //////////////////
+ // instructions //
+//////////////////
+
+typedef struct {
+    bytecode_t type;
+    addr_t params[3];
+    long test_at; // where the values of a test start in gen
+    bool removed;
+    uint8_t form; // the encoding the layout picked
+} instruction_s;
 
-    // output gen to bin while stripping and remembering labels
-    int bail = 0;
-    while(++bail < 1000) {
+static thread_local instruction_s* instructions = NULL;
+static thread_local uint32_t instruction_count = 0;
+static thread_local uint32_t instruction_capacity = 0;
+
+static instruction_s* instruction_add(bytecode_t type) {
+    if (instruction_count >= instruction_capacity) {
+        instruction_capacity = (instruction_capacity == 0) ? 64 : instruction_capacity * 2;
+        instructions = realloc(instructions, instruction_capacity * sizeof(instruction_s));
+        assert(instructions != NULL);
+    }
+    instruction_s* inst = &instructions[instruction_count++];
+    memset(inst, 0, sizeof(instruction_s));
+    inst->type = type;
+    return inst;
+}
+
+// read gen into instructions, labels included
+static void instructions_read(void) {
+    instruction_count = 0;
+    while (TRUE) {
         bytecode_t type = fgetc(gen_ptr);
 
         // exit at EOF
         if (type == (bytecode_t)EOF) { break; }
 
-        // remember labels
-        if (type == BC_LABEL) {
-            label_remember(fget16(gen_ptr), ftell(bin_ptr));
+        instruction_s* inst = instruction_add(type);
+
+        // tests keep their values in gen
+        if (bytecode[type].params == BC_VARIABLE_PARAMS) {
+            inst->params[0] = fget16(gen_ptr);
+            inst->test_at = ftell(gen_ptr);
+            fseek(gen_ptr, inst->params[0], SEEK_CUR);
             continue;
         }
 
-        // copy type to bin
-        fputc(type, bin_ptr);
+        for (uint8_t i = 0; i < bytecode[type].params; i++) {
+            switch (bytecode[type].param_size) {
+                case 1: inst->params[i] = fgetc(gen_ptr); break;
+                case 2: inst->params[i] = fget16(gen_ptr); break;
+                case 4: inst->params[i] = fget32(gen_ptr); break;
+                default: assert(FALSE);
+            }
+        }
+
+        // layouts go straight to rodata, none of the passes ever see them
+        if (type == BC_LAYOUT) {
+            layout_add(inst->params[0], inst->params[1]);
+            instruction_count--;
+        }
+    }
+}
+
+  ////////////
+ // layout //
+////////////
 
-        // copy params to bin
-        uint16_t copy_amount = bytecode[type].params * bytecode[type].param_size;
-        while (copy_amount-- > 0) { fputc(fgetc(gen_ptr), bin_ptr); }
+bool resolve_compact = FALSE;
+
+// every operand of an instruction fits a byte
+static bool operands_fit_byte(const instruction_s* inst) {
+    for (uint8_t p = 0; p < bytecode[inst->type].params; p++) {
+        if (inst->params[p] > 0xFF) { return FALSE; }
     }
-    assert(bail < 1000);
+    return TRUE;
+}
 
-    // replace ijump values with label values
-    bail = 0;
-    fseek(bin_ptr, 0, 0);
-    while(++bail < 1000) {
-        bytecode_t type = fgetc(bin_ptr);
+// the encoding an instruction gets, compact code takes the shortest one its operands fit
+static uint8_t instruction_form(const instruction_s* inst) {
+    if (!resolve_compact) { return inst->type; }
+    switch (inst->type) {
+        case BC_PUSH8:
+            return (inst->params[0] < BC_SMALL_COUNT) ? BC_PUSH_SMALL8 + inst->params[0] : BC_PUSH8;
+        case BC_PUSH16:
+            if (inst->params[0] < BC_SMALL_COUNT) { return BC_PUSH_SMALL16 + inst->params[0]; }
+            return (inst->params[0] <= 0xFF) ? BC_PUSH16_S : BC_PUSH16;
 
-        // exit at EOF
-        if (type == (bytecode_t)EOF) { break; }
+        // varints only where they are shorter, the long forms decode faster
+        case BC_IJUMP:
+            return (varint_size(label_offset(inst->params[0])) < BC_ADDR) ? BC_IJUMP_V : BC_IJUMP;
+        case BC_CALL:
+            return (varint_size(inst->params[0]) + varint_size(label_offset(inst->params[1])) < 2 * BC_ADDR) ? BC_CALL_V : BC_CALL;
 
-        // save labels
-         if (type == BC_CALL) {
-            fget16(bin_ptr);
-         }
-        if (type == BC_IJUMP || type == BC_CALL) {
-            uint16_t ijump_param = ftell(bin_ptr);
-            label_s* label = label_get(fget16(bin_ptr));
-            assert(label != NULL);
-            fseek(bin_ptr, ijump_param, 0);
-            fput16(label->offset, bin_ptr);
+        default:
+            for (uint8_t form = BC_PUSH_ZEROS_S; form < BC_IJUMP_V; form++) {
+                if (bytecode_long_form[form] == inst->type) { return operands_fit_byte(inst) ? form : inst->type; }
+            }
+            return inst->type;
+    }
+}
+
+static uint32_t instruction_size(const instruction_s* inst) {
+    switch (inst->form) {
+        case BC_TEST: return 3 + inst->params[0];
+        case BC_IJUMP_V: return 1 + varint_size(label_offset(inst->params[0]));
+        case BC_CALL_V: return 1 + varint_size(inst->params[0]) + varint_size(label_offset(inst->params[1]));
+        default: return 1 + bytecode[inst->form].params * bytecode[inst->form].param_size;
+    }
+}
+
+// places every label before anything is written, a compact jump grows when its label moves past what
+// its varint holds and that moves the labels after it, they only ever move forward so this settles
+static void instructions_layout(void) {
+    bool moved = TRUE;
+    while (moved) {
+        moved = FALSE;
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < instruction_count; i++) {
+            instruction_s* inst = &instructions[i];
+            if (inst->removed) { continue; }
+            if (inst->type == BC_LABEL) {
+                if (offset > ADDR_MAX) {
+                    fprintf(stderr, "Code too large for %d bit addresses!\n", ADDR_SIZE * 8);
+                    exit(1);
+                }
+                moved |= label_place(inst->params[0], (addr_t)offset);
+                continue;
+            }
+            inst->form = instruction_form(inst);
+            offset += instruction_size(inst);
+        }
+    }
+}
+
+// write instructions to code in the forms the layout picked, stripping labels
+static void instructions_write(void) {
+    for (uint32_t i = 0; i < instruction_count; i++) {
+        instruction_s* inst = &instructions[i];
+        if (inst->removed) { continue; }
+
+        if (inst->type == BC_LABEL) {
+            assert(code.size == label_offset(inst->params[0]));
+            TRACE(TRACE_STEPS, "placed label: %04X -> %04X\n", (uint32_t)inst->params[0], (uint32_t)code.size);
+            if (!(inst->params[0] & BIT_CLASS_END)) { entry_add(ENTRY_CLASS, inst->params[0], (addr_t)code.size); }
             continue;
         }
 
-        // skip over params
-        uint16_t skip_amount = 0;
-        if (bytecode[type].params == BC_VARIABLE_PARAMS) {
-            skip_amount = fget16(gen_ptr);
-        } else {
-            skip_amount = bytecode[type].params * bytecode[type].param_size;
+        // copy type to code
+        code_put8(inst->form);
+
+        // copy test values to code
+        if (bytecode[inst->form].params == BC_VARIABLE_PARAMS) {
+            uint16_t copy_amount = inst->params[0];
+            code_put16(copy_amount);
+            fseek(gen_ptr, inst->test_at, 0);
+            while (copy_amount-- > 0) { code_put8(fgetc(gen_ptr)); }
+            continue;
+        }
+
+        // the last param of ijump and call is a label
+        addr_t params[3] = { inst->params[0], inst->params[1], inst->params[2] };
+        if (inst->type == BC_IJUMP || inst->type == BC_CALL) {
+            uint8_t label_param = bytecode[inst->type].params - 1;
+            label_s* label = label_get(params[label_param]);
+            assert(label != NULL);
+            params[label_param] = label->offset;
+        }
+
+        // copy params to code, small pushes have theirs in the opcode
+        for (uint8_t p = 0; p < bytecode[inst->form].params; p++) {
+            if (bytecode[inst->form].param_size == BC_VARINT) {
+                code_put_varint(params[p]);
+            } else {
+                code_put(params[p], bytecode[inst->form].param_size);
+            }
         }
-        fseek(bin_ptr, skip_amount, SEEK_CUR);
     }
-    assert(bail < 1000);
+}
+
+  ///////////////////////
+ // superinstructions //
+///////////////////////
+
+// bytes an instruction pops and pushes, FALSE if it does anything else to the stack or pc
+static bool stack_effect(instruction_s* inst, uint8_t* pops, uint8_t* pushes) {
+    switch (inst->type) {
+        case BC_NOOP: *pops = 0; *pushes = 0; return TRUE;
+        case BC_EXTEND: *pops = 1; *pushes = 2; return TRUE;
+
+        case BC_PUSH8: *pops = 0; *pushes = 1; return TRUE;
+        case BC_PUSH16: *pops = 0; *pushes = 2; return TRUE;
+        case BC_POP8: *pops = 1; *pushes = 0; return TRUE;
+        case BC_POP16: *pops = 2; *pushes = 0; return TRUE;
+
+        case BC_GET8: *pops = 2; *pushes = 1; return TRUE;
+        case BC_GET16: *pops = 2; *pushes = 2; return TRUE;
+        case BC_IGET8: *pops = 0; *pushes = 1; return TRUE;
+        case BC_IGET16: *pops = 0; *pushes = 2; return TRUE;
+
+        case BC_NEG8: *pops = 1; *pushes = 1; return TRUE;
+        case BC_NEG16: *pops = 2; *pushes = 2; return TRUE;
+
+        case BC_ADD8: case BC_SUB8: case BC_MUL8: case BC_DIV8: *pops = 2; *pushes = 1; return TRUE;
+        case BC_ADD16: case BC_SUB16: case BC_MUL16: case BC_DIV16: *pops = 4; *pushes = 2; return TRUE;
+
+        case BC_ADDI8: case BC_IGET_ADD8: case BC_IGET_MUL8: *pops = 1; *pushes = 1; return TRUE;
+        case BC_ADDI16: case BC_IGET_ADD16: case BC_IGET_MUL16: *pops = 2; *pushes = 2; return TRUE;
+
+        default: return FALSE;
+    }
+}
+
+// the closest instruction before index that is still in use
+static instruction_s* instruction_previous(uint32_t index) {
+    while (index-- > 0) {
+        if (!instructions[index].removed) { return &instructions[index]; }
+    }
+    return NULL;
+}
+
+// does the code between push and set compute exactly the value being set
+static bool computes_value(uint32_t push, uint32_t set, uint8_t value_size) {
+    int32_t depth = 0;
+    for (uint32_t i = push + 1; i < set; i++) {
+        if (instructions[i].removed) { continue; }
+        uint8_t pops, pushes;
+        if (!stack_effect(&instructions[i], &pops, &pushes)) { return FALSE; }
+        depth -= pops;
+        if (depth < 0) { return FALSE; }
+        depth += pushes;
+    }
+    return depth == value_size;
+}
+
+// push16 addr, <value>, set8 becomes <value>, seti8 addr
+static void fuse_set(uint32_t set) {
+    uint8_t wide = instructions[set].type - BC_SET8;
+    uint8_t pops, pushes;
+    for (uint32_t i = set; i-- > 0;) {
+        instruction_s* inst = &instructions[i];
+        if (inst->removed) { continue; }
+        if (inst->type == BC_PUSH16 && computes_value(i, set, 1 + wide)) {
+            instructions[set].type = BC_SETI8 + wide;
+            instructions[set].params[0] = inst->params[0];
+            inst->removed = TRUE;
+            return;
+        }
+        // the address can't be past a label or anything that isn't plain stack math
+        if (!stack_effect(inst, &pops, &pushes)) { return; }
+    }
+}
+
+// fuse common sequences from codegen into single instructions, labels are never crossed
+static void fuse(void) {
+    for (uint32_t i = 0; i < instruction_count; i++) {
+        instruction_s* inst = &instructions[i];
+        instruction_s* prev = instruction_previous(i);
+        uint8_t wide = 0;
+
+        switch (inst->type) {
+            case BC_SET8:
+            case BC_SET16:
+                fuse_set(i);
+                break;
+
+            case BC_ADD8:
+            case BC_ADD16:
+                wide = inst->type - BC_ADD8;
+                if (prev == NULL) { break; }
+                if (prev->type == BC_PUSH8 + wide) {
+                    // push8 k, add8 becomes addi8 k
+                    inst->type = BC_ADDI8 + wide;
+                } else if (prev->type == BC_IGET8 + wide) {
+                    // iget8 addr, add8 becomes iget_add8 addr
+                    inst->type = BC_IGET_ADD8 + wide;
+                } else {
+                    break;
+                }
+                inst->params[0] = prev->params[0];
+                prev->removed = TRUE;
+                break;
+
+            case BC_MUL8:
+            case BC_MUL16:
+                wide = inst->type - BC_MUL8;
+                if (prev == NULL || prev->type != BC_IGET8 + wide) { break; }
+                // iget8 addr, mul8 becomes iget_mul8 addr
+                inst->type = BC_IGET_MUL8 + wide;
+                inst->params[0] = prev->params[0];
+                prev->removed = TRUE;
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+  /////////////////
+ // dead stores //
+/////////////////
+
+static bool overlaps(addr_t a, uint8_t a_size, addr_t b, uint8_t b_size) {
+    return a < b + b_size && b < a + a_size;
+}
+
+// is a fused set overwritten before anything could read it
+static bool store_dead(uint32_t set) {
+    addr_t address = instructions[set].params[0];
+    uint8_t size = 1 + (instructions[set].type - BC_SETI8);
+    for (uint32_t i = set + 1; i < instruction_count; i++) {
+        instruction_s* inst = &instructions[i];
+        if (inst->removed) { continue; }
+        uint8_t pops, pushes;
+        switch (inst->type) {
+            case BC_SETI8:
+            case BC_SETI16:
+                if (inst->params[0] <= address && address + size <= inst->params[0] + 1 + (inst->type - BC_SETI8)) { return TRUE; }
+                break;
+            case BC_IGET8: case BC_IGET_ADD8: case BC_IGET_MUL8:
+                if (overlaps(inst->params[0], 1, address, size)) { return FALSE; }
+                break;
+            case BC_IGET16: case BC_IGET_ADD16: case BC_IGET_MUL16:
+                if (overlaps(inst->params[0], 2, address, size)) { return FALSE; }
+                break;
+            // slot ops read their sources before writing the destination
+            case BC_SLOT_MOV8: case BC_SLOT_ADD8: case BC_SLOT_SUB8: case BC_SLOT_MUL8: case BC_SLOT_DIV8:
+            case BC_SLOT_MOV16: case BC_SLOT_ADD16: case BC_SLOT_SUB16: case BC_SLOT_MUL16: case BC_SLOT_DIV16: {
+                uint8_t slot_size = 1 + (inst->type - BC_SLOT_MOV8) % 2;
+                for (uint8_t p = 1; p < bytecode[inst->type].params; p++) {
+                    if (overlaps(inst->params[p], slot_size, address, size)) { return FALSE; }
+                }
+                if (inst->params[0] <= address && address + size <= inst->params[0] + slot_size) { return TRUE; }
+                break;
+            }
+            // anything read through a popped address
+            case BC_GET8:
+            case BC_GET16:
+                return FALSE;
+            // labels, calls, tests and the end all might read it
+            default:
+                if (!stack_effect(inst, &pops, &pushes)) { return FALSE; }
+                break;
+        }
+    }
+    return FALSE;
+}
+
+// where the plain stack math that computes the value a set pops starts
+static bool value_start(uint32_t set, uint8_t value_size, uint32_t* start) {
+    int32_t needed = value_size;
+    for (uint32_t i = set; i-- > 0;) {
+        instruction_s* inst = &instructions[i];
+        if (inst->removed) { continue; }
+        uint8_t pops, pushes;
+        if (!stack_effect(inst, &pops, &pushes)) { return FALSE; }
+        needed -= pushes;
+        if (needed < 0) { return FALSE; }
+        needed += pops;
+        if (needed == 0) {
+            *start = i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// drop stores that are overwritten before being read, along with the math computing them
+static void eliminate_dead_stores(void) {
+    for (uint32_t i = 0; i < instruction_count; i++) {
+        instruction_s* inst = &instructions[i];
+        if (inst->removed || (inst->type != BC_SETI8 && inst->type != BC_SETI16)) { continue; }
+        uint32_t start;
+        if (!store_dead(i) || !value_start(i, 1 + (inst->type - BC_SETI8), &start)) { continue; }
+        TRACE(TRACE_STEPS, "dead store: %04X\n", (uint32_t)inst->params[0]);
+        for (uint32_t j = start; j <= i; j++) { instructions[j].removed = TRUE; }
+    }
+}
+
+  /////////////////////
+ // jump resolution //
+/////////////////////
+
+void jump_resolution(FILE* gen_ptr_arg, FILE* bin_ptr_arg) {
+    gen_ptr = gen_ptr_arg;
+    bin_ptr = bin_ptr_arg;
+    code.size = 0;
+    entry_add(ENTRY_PROGRAM, 0, 0);
+
+    instructions_read();
+    fuse();
+    eliminate_dead_stores();
+    instructions_layout();
+    instructions_write();
+
+    // the header records how much stack the program needs when that can be worked out
+    uint32_t stack_needed;
+    verify(code.data, (addr_t)code.size, &stack_needed);
+    image_write(bin_ptr, code.data, code.size, entries, entry_count, layouts, layout_count, (uint16_t)stack_needed);
+
+    free(instructions);
+    instructions = NULL;
+    instruction_capacity = 0;
+    free(code.data);
+    code = (buffer_s){ 0 };
+    labels_free();
+    entries_free();
+    layouts_free();
 }
 
   //////////
  // main //
 //////////
 
+#ifndef SHABBY_LIBRARY
 int main(int argc, char *argv[]) {
     assert(argc == 2);
+    trace_level = TRACE_STEPS;
 
     char gen_buffer[256] = { 0 };
     sprintf(gen_buffer, "../bin/compilation/%s.gen", "out");
@@ -135,3 +632,4 @@ int main(int argc, char *argv[]) {
     // make pedantic compilers happy
     argv[0] = argv[0];
 }
+#endif
@@ -4,23 +4,31 @@
 #include <assert.h>
 #include "symbols.h"
 #include "file.h"
+#include "stages.h"
 #include "nodes.h"
+#include "intern.h"
+#include "tokens.h"
+#include "trace.h"
 
   ///////////////////
  // file pointers //
 ///////////////////
 
-static FILE *src_ptr = NULL; // source code
-static FILE *tok_ptr = NULL; // token offsets
-static FILE *ast_ptr = NULL; // output
+static thread_local token_array_s *tokens = NULL; // tokens from the tokenizer
+static thread_local ast_arena_s *ast_ptr = NULL; // output
 
   ///////////////////////
  // token information //
 ///////////////////////
 
-static char cur_token[MAX_TOKEN_LEN+1] = { 0 }; // the current token being evaluated
-static uint16_t next_token_index = 0; // the next token index to evaluate
-static uint16_t token_count = 0; // the total number of tokens
+static thread_local const char* cur_token = ""; // the current token being evaluated
+static thread_local uint32_t cur_id = INTERN_NONE; // interned id of the current token
+static thread_local uint8_t cur_kind = TOKEN_SYMBOL; // kind of the current token
+static thread_local uint32_t next_token_index = 0; // the next token index to evaluate
+
+// keywords, interned once so tokens compare by id
+static thread_local uint32_t id_class = INTERN_NONE;
+static thread_local uint32_t id_test = INTERN_NONE;
 
   ////////////////////////////
  // scheduled future nodes //
@@ -31,15 +39,15 @@ static uint16_t token_count = 0; // the total number of tokens
 
 typedef struct {
     node_t node;
-    uint16_t parent_offset;
+    addr_t parent_offset;
     uint8_t child_index;
     uint8_t flags;
 } future_node_s;
 
-static future_node_s future_stack[FUTURE_STACK_SIZE] = { 0 };
-static uint16_t future_stack_count = 0;
+static thread_local future_node_s future_stack[FUTURE_STACK_SIZE] = { 0 };
+static thread_local uint16_t future_stack_count = 0;
 
-static void future_push(node_t node, uint16_t parent_offset,
+static void future_push(node_t node, addr_t parent_offset,
                         uint8_t child_index, uint8_t flags) {
     future_stack[future_stack_count].node = node;
     future_stack[future_stack_count].parent_offset = parent_offset;
@@ -60,13 +68,15 @@ static future_node_s* future_pop(void) {
 /////////////////////////////
 
 #ifdef DEBUG
-    static void peek_token(char* buffer, uint16_t index);
-    int* stack_start;
-    static int _indent = 0;
+    static const char* peek_token(uint32_t index);
+    static thread_local int* stack_start;
+    static thread_local int _indent = 0;
     #define INDENT(x) _indent += x
     #define DPRINT(x, y) _dprint(x, y)
 
-    static void _dprint(char* string, uint8_t tokens) {
+    static void _dprint(const char* string, uint8_t token_count) {
+        if (!TRACING(TRACE_STEPS)) { return; }
+
         // print stack depth
         int stack_mem = 10;
         printf("%05lX  ", stack_start - (&stack_mem));
@@ -78,10 +88,8 @@ static future_node_s* future_pop(void) {
         printf("%s: ", string);
 
         // print tokens
-        char peeked_token[MAX_TOKEN_LEN+1];
-        for (int i = 0; i < tokens; i++) {
-            peek_token(peeked_token, next_token_index + i - 1);
-            printf("%s ", peeked_token);
+        for (int i = 0; i < token_count; i++) {
+            printf("%s ", peek_token(next_token_index + i - 1));
         }
 
         printf("\n");
@@ -97,46 +105,27 @@ static future_node_s* future_pop(void) {
 
 static void next_token() {
     // bounds checking
-    if (next_token_index >= token_count) {
-        cur_token[0] = NULL;
+    if (next_token_index >= tokens->count) {
+        cur_token = "";
+        cur_id = INTERN_NONE;
+        cur_kind = TOKEN_SYMBOL;
         next_token_index++;
         return;
     }
 
-    // obtain token offsets
-    fseek(tok_ptr, 2 + next_token_index * 3, 0);
-    uint16_t start_index = fget16(tok_ptr);
-    uint8_t length = fgetc(tok_ptr);
-    assert(length <= MAX_TOKEN_LEN);
-
-    // obtain token string
-    fseek(src_ptr, start_index, 0);
-    fgets(cur_token, length+1, src_ptr);
-    cur_token[length] = NULL;
-
+    cur_id = tokens->data[next_token_index].id;
+    cur_kind = tokens->data[next_token_index].kind;
+    cur_token = interned(cur_id);
     next_token_index++;
 }
 
-static void peek_token(char* buffer, uint16_t index) {
+static const char* peek_token(uint32_t index) {
     // bounds checking
-    if (index >= token_count) {
-        buffer[0] = NULL;
-        return;
-    }
-
-    // obtain token offsets
-    fseek(tok_ptr, 2 + index * 3, 0);
-    uint16_t start_index = fget16(tok_ptr);
-    uint8_t length = fgetc(tok_ptr);
-    assert(length <= MAX_TOKEN_LEN);
-
-    // obtain token string
-    fseek(src_ptr, start_index, 0);
-    fgets(buffer, length+1, src_ptr);
-    buffer[length] = NULL;
+    if (index >= tokens->count) { return ""; }
+    return interned(tokens->data[index].id);
 }
 
-static uint16_t output(node_t node_type, uint16_t parent_offset, uint8_t child_index) {
+static addr_t output(node_t node_type, addr_t parent_offset, uint8_t child_index) {
     DPRINT(node_constants[node_type].name, node_constants[node_type].output_token_count);
     return ast_new_node(ast_ptr, node_type, parent_offset, child_index);
 }
@@ -145,7 +134,7 @@ static uint16_t output(node_t node_type, uint16_t parent_offset, uint8_t child_i
  // parsing functionality //
 ///////////////////////////
 
-static void parse_test(uint16_t parent_offset, uint8_t child_index) {
+static void parse_test(addr_t parent_offset, uint8_t child_index) {
     // <TEST> ::= $TEST <constant ...>
     // output: [base node] <constant tokens>
 
@@ -161,30 +150,26 @@ static void parse_test(uint16_t parent_offset, uint8_t child_index) {
         }
 
         // output token
-        fputs(cur_token, ast_ptr);
-        if (cur_token[0] != '-') { fputc(' ', ast_ptr); }
+        ast_puts(cur_token, ast_ptr);
+        if (cur_token[0] != '-') { ast_putc(' ', ast_ptr); }
         next_token();
     }
-    fputc(NULL, ast_ptr);
+    ast_putc(NULL, ast_ptr);
 }
 
-static void parse_cast(uint16_t parent_offset, uint8_t child_index) {
+static void parse_cast(addr_t parent_offset, uint8_t child_index) {
     // <cast> ::= '<' <type> '>' <factor>
     // output: [base node] <factor*> <token>
 
     // validate identifier
-    assert(is_alpha(cur_token[0]) || cur_token[0] == '_');
-    for (uint8_t i = 0; i < MAX_TOKEN_LEN; i++) {
-        if (cur_token[i] == NULL) { break; }
-        assert(is_alphanumeric(cur_token[i]) || cur_token[i] == '_');
-    }
+    assert(cur_kind == TOKEN_IDENTIFIER);
 
     // write base node
-    uint16_t my_offset = output(NT_CAST, parent_offset, child_index);
+    addr_t my_offset = output(NT_CAST, parent_offset, child_index);
 
     // output token
-    fputs(cur_token, ast_ptr);
-    fputc(NULL, ast_ptr);
+    ast_puts(cur_token, ast_ptr);
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // schedule factor
@@ -192,7 +177,7 @@ static void parse_cast(uint16_t parent_offset, uint8_t child_index) {
     future_push(NT_CONSUME, NULL, NULL, '>');
 }
 
-static void parse_constant(uint16_t parent_offset, uint8_t child_index) {
+static void parse_constant(addr_t parent_offset, uint8_t child_index) {
     // <constant> ::= ( '0-9'+ )
     // output: [base node] <token>
 
@@ -206,28 +191,24 @@ static void parse_constant(uint16_t parent_offset, uint8_t child_index) {
     output(NT_CONSTANT, parent_offset, child_index);
 
     // output token
-    fputs(cur_token, ast_ptr);
-    fputc(NULL, ast_ptr);
+    ast_puts(cur_token, ast_ptr);
+    ast_putc(NULL, ast_ptr);
     next_token();
 }
 
-static void parse_member(uint16_t parent_offset, uint8_t child_index) {
+static void parse_member(addr_t parent_offset, uint8_t child_index) {
     // <member> ::= ( '[a-zA-Z_][a-zA-Z0-9_]*' )
     // output: [base node] <*next_member> <token>
 
     // validate identifier
-    assert(is_alpha(cur_token[0]) || cur_token[0] == '_');
-    for (uint8_t i = 0; i < MAX_TOKEN_LEN; i++) {
-        if (cur_token[i] == NULL) { break; }
-        assert(is_alphanumeric(cur_token[i]) || cur_token[i] == '_');
-    }
+    assert(cur_kind == TOKEN_IDENTIFIER);
 
     // write base node
-    uint16_t my_offset = output(NT_MEMBER, parent_offset, child_index);
+    addr_t my_offset = output(NT_MEMBER, parent_offset, child_index);
 
     // output token
-    fputs(cur_token, ast_ptr);
-    fputc(NULL, ast_ptr);
+    ast_puts(cur_token, ast_ptr);
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // schedule member
@@ -237,23 +218,19 @@ static void parse_member(uint16_t parent_offset, uint8_t child_index) {
     }
 }
 
-static void parse_variable(uint16_t parent_offset, uint8_t child_index) {
+static void parse_variable(addr_t parent_offset, uint8_t child_index) {
     // <variable> ::= ( '[a-zA-Z_][a-zA-Z0-9_]*' )
     // output: [base node] <*member> <token>
 
     // validate identifier
-    assert(is_alpha(cur_token[0]) || cur_token[0] == '_');
-    for (uint8_t i = 0; i < MAX_TOKEN_LEN; i++) {
-        if (cur_token[i] == NULL) { break; }
-        assert(is_alphanumeric(cur_token[i]) || cur_token[i] == '_');
-    }
+    assert(cur_kind == TOKEN_IDENTIFIER);
 
     // write base node
-    uint16_t my_offset = output(NT_VARIABLE, parent_offset, child_index);
+    addr_t my_offset = output(NT_VARIABLE, parent_offset, child_index);
 
     // output token
-    fputs(cur_token, ast_ptr);
-    fputc(NULL, ast_ptr);
+    ast_puts(cur_token, ast_ptr);
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // schedule member
@@ -263,7 +240,7 @@ static void parse_variable(uint16_t parent_offset, uint8_t child_index) {
     }
 }
 
-static void parse_unary_op(uint16_t parent_offset, uint8_t child_index) {
+static void parse_unary_op(addr_t parent_offset, uint8_t child_index) {
     // <unary_op> ::= ( '-' )
     // output: [base node] <token>
 
@@ -275,17 +252,17 @@ static void parse_unary_op(uint16_t parent_offset, uint8_t child_index) {
     output(NT_UNARY_OP, parent_offset, child_index);
 
     // output token
-    fputs(cur_token, ast_ptr);
-    fputc(NULL, ast_ptr);
+    ast_puts(cur_token, ast_ptr);
+    ast_putc(NULL, ast_ptr);
     next_token();
 }
 
-static void parse_factor(uint16_t parent_offset, uint8_t child_index) {
+static void parse_factor(addr_t parent_offset, uint8_t child_index) {
     // <factor> ::= [ <unary_op> ] ( <constant> | '(' <expression> ')' | <variable> | <cast> )
     // output: [base node] <*unary_op> <*constant | *expression | *variable>
 
     // write base node
-    uint16_t my_offset = output(NT_FACTOR, parent_offset, child_index);
+    addr_t my_offset = output(NT_FACTOR, parent_offset, child_index);
 
     // indentation
     #ifdef DEBUG
@@ -294,11 +271,9 @@ static void parse_factor(uint16_t parent_offset, uint8_t child_index) {
     #endif
 
     // peek ahead if current token is a unary operator
-    char peeked_token[MAX_TOKEN_LEN+1];
-    char* value_str = cur_token;
+    const char* value_str = cur_token;
     if (is_unary_op(cur_token[0])) {
-        peek_token(peeked_token, next_token_index);
-        value_str = peeked_token;
+        value_str = peek_token(next_token_index);
     }
 
     if (is_numeric(value_str[0])) {
@@ -324,7 +299,7 @@ static void parse_factor(uint16_t parent_offset, uint8_t child_index) {
     future_push(NT_UNARY_OP, my_offset, 0, NULL);
 }
 
-static void parse_term_op(uint16_t parent_offset, uint8_t child_index, uint8_t flags) {
+static void parse_term_op(addr_t parent_offset, uint8_t child_index, uint8_t flags) {
     // <term_op> ::= ( '*' | '/' )
     // output: [base node] <token>
 
@@ -349,8 +324,8 @@ static void parse_term_op(uint16_t parent_offset, uint8_t child_index, uint8_t f
     output(NT_TERM_OP, parent_offset, child_index);
 
     // output token
-    fputs(cur_token, ast_ptr);
-    fputc(NULL, ast_ptr);
+    ast_puts(cur_token, ast_ptr);
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // schedule nested term
@@ -360,12 +335,12 @@ static void parse_term_op(uint16_t parent_offset, uint8_t child_index, uint8_t f
     future_push(NT_FACTOR, parent_offset, 0, NULL);
 }
 
-static void parse_term(uint16_t parent_offset, uint8_t child_index) {
+static void parse_term(addr_t parent_offset, uint8_t child_index) {
     // <term> ::= <factor> [ <term_op> <factor> ... ]
     // output: [base node] <*right_factor> <*term_op> <*left_factor>
 
     // write base node
-    uint16_t my_offset = output(NT_TERM, parent_offset, child_index);
+    addr_t my_offset = output(NT_TERM, parent_offset, child_index);
 
     // indentation
     #ifdef DEBUG
@@ -380,7 +355,7 @@ static void parse_term(uint16_t parent_offset, uint8_t child_index) {
     future_push(NT_FACTOR, my_offset, 2, NULL);
 }
 
-static void parse_expression_op(uint16_t parent_offset, uint8_t child_index, uint8_t flags) {
+static void parse_expression_op(addr_t parent_offset, uint8_t child_index, uint8_t flags) {
     // <expression_op> ::= ( '+' | '-' )
     // output: [base node] <token>
 
@@ -405,8 +380,8 @@ static void parse_expression_op(uint16_t parent_offset, uint8_t child_index, uin
     output(NT_EXPRESSION_OP, parent_offset, child_index);
 
     // output token
-    fputs(cur_token, ast_ptr);
-    fputc(NULL, ast_ptr);
+    ast_puts(cur_token, ast_ptr);
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // schedule nested expression
@@ -416,12 +391,12 @@ static void parse_expression_op(uint16_t parent_offset, uint8_t child_index, uin
     future_push(NT_TERM, parent_offset, 0, NULL);
 }
 
-static void parse_expression(uint16_t parent_offset, uint8_t child_index) {
+static void parse_expression(addr_t parent_offset, uint8_t child_index) {
     // <expression> ::= <term> [ <expression_op> <term> ... ]
     // output: [base node] <*right_term> <*expression_op> <*left_term>
 
     // write base node
-    uint16_t my_offset = output(NT_EXPRESSION, parent_offset, child_index);
+    addr_t my_offset = output(NT_EXPRESSION, parent_offset, child_index);
 
     // indentation
     #ifdef DEBUG
@@ -436,12 +411,12 @@ static void parse_expression(uint16_t parent_offset, uint8_t child_index) {
     future_push(NT_TERM, my_offset, 2, NULL);
 }
 
-static void parse_assignment(uint16_t parent_offset, uint8_t child_index) {
+static void parse_assignment(addr_t parent_offset, uint8_t child_index) {
     // <assignment> ::= <identifier> '=' <expression>
     // output: [base node] <*expression> <*member> <var_identifier>
 
     // write base node
-    uint16_t my_offset = output(NT_ASSIGNMENT, parent_offset, child_index);
+    addr_t my_offset = output(NT_ASSIGNMENT, parent_offset, child_index);
 
     // indentation
     #ifdef DEBUG
@@ -450,9 +425,9 @@ static void parse_assignment(uint16_t parent_offset, uint8_t child_index) {
     #endif
 
     // output var identifier
-    assert(is_identifier(cur_token));
-    fputs(cur_token, ast_ptr); // var identifier
-    fputc(NULL, ast_ptr);
+    assert(cur_kind == TOKEN_IDENTIFIER);
+    ast_puts(cur_token, ast_ptr); // var identifier
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // schedule expression
@@ -468,12 +443,12 @@ static void parse_assignment(uint16_t parent_offset, uint8_t child_index) {
     }
 }
 
-static void parse_declaration(uint16_t parent_offset, uint8_t child_index) {
+static void parse_declaration(addr_t parent_offset, uint8_t child_index) {
     // <declaration> ::= <var_type> <identifier> [ '=' <expression> ]
     // output: [base node] <*expression> <var_type_token> <var_identifier>
 
     // write base node
-    uint16_t my_offset = output(NT_DECLARATION, parent_offset, child_index);
+    addr_t my_offset = output(NT_DECLARATION, parent_offset, child_index);
 
     // indentation
     #ifdef DEBUG
@@ -481,15 +456,15 @@ static void parse_declaration(uint16_t parent_offset, uint8_t child_index) {
     #endif
 
     // output var type token
-    assert(is_identifier(cur_token));
-    fputs(cur_token, ast_ptr); // var token
-    fputc(NULL, ast_ptr);
+    assert(cur_kind == TOKEN_IDENTIFIER);
+    ast_puts(cur_token, ast_ptr); // var token
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // output var identifier
-    assert(is_identifier(cur_token));
-    fputs(cur_token, ast_ptr); // var identifier
-    fputc(NULL, ast_ptr);
+    assert(cur_kind == TOKEN_IDENTIFIER);
+    ast_puts(cur_token, ast_ptr); // var identifier
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // setting variable
@@ -499,14 +474,14 @@ static void parse_declaration(uint16_t parent_offset, uint8_t child_index) {
     }
 }
 
-static void parse_statement(uint16_t parent_offset, uint8_t child_index, uint8_t flags) {
+static void parse_statement(addr_t parent_offset, uint8_t child_index, uint8_t flags) {
     // <statement> ::= <declaration | assignment> ';'
     // output: [base node] <*next_statement> <*assignment | *declaration | *test>
 
-    if (!is_identifier(cur_token) && cur_token[0] != '$') { return; }
+    if (cur_kind != TOKEN_IDENTIFIER && cur_token[0] != '$') { return; }
 
     // write base node
-    uint16_t my_offset = output(NT_STATEMENT, parent_offset, child_index);
+    addr_t my_offset = output(NT_STATEMENT, parent_offset, child_index);
 
     // schedule next statement
     if (flags & FUTURE_FLAG_STATEMENTS) {
@@ -520,7 +495,7 @@ static void parse_statement(uint16_t parent_offset, uint8_t child_index, uint8_t
     #endif
 
     // schedule class
-    if (!strcmp(cur_token, "class")) {
+    if (cur_id == id_class) {
         future_push(NT_CLASS, my_offset, 1, NULL);
         return;
     }
@@ -531,14 +506,13 @@ static void parse_statement(uint16_t parent_offset, uint8_t child_index, uint8_t
     // schedule test
     if (cur_token[0] == '$' && cur_token[1] == NULL) {
         next_token();
-        assert(!strcmp(cur_token, "TEST"));
+        assert(cur_id == id_test);
         future_push(NT_TEST, my_offset, 1, NULL);
         return;
     }
 
     // decide which type of statement it is
-    char peeked_token[MAX_TOKEN_LEN+1];
-    peek_token(peeked_token, next_token_index);
+    const char* peeked_token = peek_token(next_token_index);
     if (peeked_token[1] == NULL && (peeked_token[0] == '=' || peeked_token[0] == '.')) {
         // schedule assignment
         future_push(NT_ASSIGNMENT, my_offset, 1, NULL);
@@ -548,7 +522,7 @@ static void parse_statement(uint16_t parent_offset, uint8_t child_index, uint8_t
     }
 }
 
-static void parse_statement_list(uint16_t parent_offset, uint8_t child_index) {
+static void parse_statement_list(addr_t parent_offset, uint8_t child_index) {
     // <statement_list> ::= <statement> [<statement> ...]
     // output:
 
@@ -564,12 +538,12 @@ static void parse_statement_list(uint16_t parent_offset, uint8_t child_index) {
     future_push(NT_STATEMENT, parent_offset, child_index, FUTURE_FLAG_STATEMENTS);
 }
 
-static void parse_class(uint16_t parent_offset, uint8_t child_index) {
+static void parse_class(addr_t parent_offset, uint8_t child_index) {
     // <class> ::= class <identifier> '{' <statement_list> '}'
     // output: [base node] <*statement_list> <class_identifier>
 
     // write base node
-    uint16_t my_offset = output(NT_CLASS, parent_offset, child_index);
+    addr_t my_offset = output(NT_CLASS, parent_offset, child_index);
 
     // indentation
     #ifdef DEBUG
@@ -577,13 +551,13 @@ static void parse_class(uint16_t parent_offset, uint8_t child_index) {
     #endif
 
     // verify class token
-    assert(!strcmp(cur_token, "class"));
+    assert(cur_id == id_class);
     next_token();
 
     // output class identifier
-    assert(is_identifier(cur_token));
-    fputs(cur_token, ast_ptr); // class identifier
-    fputc(NULL, ast_ptr);
+    assert(cur_kind == TOKEN_IDENTIFIER);
+    ast_puts(cur_token, ast_ptr); // class identifier
+    ast_putc(NULL, ast_ptr);
     next_token();
 
     // read class
@@ -600,7 +574,7 @@ static void parse_consume(char c) {
     // output:
 
     if (cur_token[0] != c) {
-        printf("Syntax error!\n Expected '%c' but got '%c'.\n", c, cur_token[0]);
+        fprintf(stderr, "Syntax error!\n Expected '%c' but got '%c'.\n", c, cur_token[0]);
     }
 
     assert(cur_token[0] == c);
@@ -609,28 +583,31 @@ static void parse_consume(char c) {
     next_token();
 }
 
-void parse(FILE* src_ptr_arg, FILE* tok_ptr_arg, FILE* out_ptr_arg) {
+void parse(token_array_s* tokens_arg, ast_arena_s* out_ptr_arg) {
     #ifdef DEBUG
         // track stack depth in bytes
         int stack_mem = 10;
         stack_start = &stack_mem;
 
         // print debug header
-        printf("\n");
-        printf("stack  node\n");
-        printf("-----  -------------------\n");
+        TRACE(TRACE_STAGES, "\n");
+        TRACE(TRACE_STAGES, "stack  node\n");
+        TRACE(TRACE_STAGES, "-----  -------------------\n");
     #endif
 
-    src_ptr = src_ptr_arg;
-    tok_ptr = tok_ptr_arg;
+    tokens = tokens_arg;
     ast_ptr = out_ptr_arg;
 
-    // read token info
-    token_count = fget16(tok_ptr);
+    // intern keywords
+    id_class = intern("class");
+    id_test = intern("TEST");
+
+    // read first token
+    next_token_index = 0;
     next_token();
 
     // allocate space for root pointer
-    fput16(NULL, ast_ptr);
+    ast_put_addr(NULL, ast_ptr);
 
     // schedule root node
     future_push(NT_STATEMENT_LIST, NULL, NULL, NULL);
@@ -668,29 +645,36 @@ void parse(FILE* src_ptr_arg, FILE* tok_ptr_arg, FILE* out_ptr_arg) {
  // main //
 //////////
 
+#ifndef SHABBY_LIBRARY
 int main(int argc, char *argv[]) {
     assert(argc == 2);
+    trace_level = TRACE_STEPS;
 
     char src_buffer[256] = { 0 };
     sprintf(src_buffer, "%s", argv[1]);
-    src_ptr = fopen(src_buffer, "rb");
+    FILE* src_ptr = fopen(src_buffer, "rb");
 
     char tok_buffer[256] = { 0 };
     sprintf(tok_buffer, "../bin/compilation/%s.tok", "out");
-    tok_ptr = fopen(tok_buffer, "rb");
+    FILE* tok_ptr = fopen(tok_buffer, "rb");
+
+    token_array_s token_array = { 0 };
+    tokens_load(&token_array, tok_ptr, src_ptr);
 
     char ast_buffer[256] = { 0 };
     sprintf(ast_buffer, "../bin/compilation/%s.ast", "out");
-    ast_ptr = fopen(ast_buffer, "wb+");
+    FILE* ast_file_ptr = fopen(ast_buffer, "wb");
 
-    parse(src_ptr, tok_ptr, ast_ptr);
+    ast_arena_s ast = { 0 };
+    parse(&token_array, &ast);
+    ast_arena_save(&ast, ast_file_ptr);
+    ast_arena_free(&ast);
+    tokens_free(&token_array);
 
     fclose(src_ptr);
     fclose(tok_ptr);
-    fclose(ast_ptr);
+    fclose(ast_file_ptr);
 
     return 0;
-
-    // make pedantic compilers happy
-    node_constants[0] = node_constants[0];
 }
+#endif
@@ -0,0 +1,428 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "file.h"
+#include "nodes.h"
+#include "stages.h"
+#include "trace.h"
+#include "intern.h"
+
+#define MAX_SOURCES 1024
+#define MAX_JOBS 256
+
+  ///////////////////
+ // intermediates //
+///////////////////
+
+typedef enum {
+    STAGE_TOK,
+    STAGE_AST,
+    STAGE_GEN,
+    STAGE_BIN,
+    STAGE_C, // translated from the bin on every compile, so never cached
+    STAGE_S, // thumb assembly, the same
+    STAGE_COUNT,
+} stage_t;
+#define STAGE_CACHED STAGE_C
+
+static char* stage_extensions[] = {
+    [STAGE_TOK] = "tok",
+    [STAGE_AST] = "ast",
+    [STAGE_GEN] = "gen",
+    [STAGE_BIN] = "bin",
+    [STAGE_C] = "c",
+    [STAGE_S] = "s",
+};
+
+// everything one source compiles into, the stages keep the rest in thread local state
+typedef struct {
+    char* src_path;
+    char name[256]; // outputs are named after the source
+    buffer_s buffers[STAGE_COUNT];
+    bool failed;
+} compile_s;
+
+static compile_s compiles[MAX_SOURCES];
+static uint32_t compile_count = 0;
+static bool emit[STAGE_COUNT] = { 0 };
+static bool run = FALSE;
+static char* out_dir = "."; // where emitted stages are written
+
+static FILE* stage_begin(compile_s* compile, stage_t stage) {
+    return buffer_open(&compile->buffers[stage]);
+}
+
+// intermediates only touch the disk when asked for, FALSE if they couldn't be written
+static bool stage_emit(compile_s* compile, stage_t stage) {
+    char path_buffer[512] = { 0 };
+    int length = snprintf(path_buffer, sizeof(path_buffer), "%s/%s.%s", out_dir, compile->name, stage_extensions[stage]);
+    FILE* out_ptr = (length < (int)sizeof(path_buffer)) ? fopen(path_buffer, "wb") : NULL;
+    if (out_ptr == NULL) {
+        fprintf(stderr, "Could not write '%s'!\n", path_buffer);
+        return FALSE;
+    }
+    size_t size = compile->buffers[stage].size;
+    bool written = fwrite(compile->buffers[stage].data, 1, size, out_ptr) == size;
+    written = (fclose(out_ptr) == 0) && written;
+    if (!written) { fprintf(stderr, "Could not write '%s'!\n", path_buffer); }
+    return written;
+}
+
+// a.src and dir/a.src both become "a"
+static void output_name(char* name, const char* src_path) {
+    const char* base = strrchr(src_path, '/');
+    base = (base != NULL) ? base + 1 : src_path;
+    size_t length = strlen(base);
+    const char* extension = strrchr(base, '.');
+    if (extension != NULL && extension != base) { length = extension - base; }
+    assert(length < 256);
+    memcpy(name, base, length);
+    name[length] = '\0';
+}
+
+  ///////////
+ // cache //
+///////////
+
+// anything that changes the bytes a compile produces has to change the key, the compiler binary itself is
+// hashed into it so any rebuild that changes a stage starts over, the builds are named too
+static const char compiler_id[] = "shabbyc"
+#ifdef SHABBY_WIDE
+    " wide"
+#endif
+#ifdef SHABBY_RELEASE
+    " release"
+#endif
+    ;
+
+static char* cache_dir = NULL;
+static uint64_t compiler_hash = 0;
+
+static uint64_t fnv1a(uint64_t hash, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// the whole source, entries keep a copy to check a key hit against
+static void source_read(FILE* src_ptr, buffer_s* source) {
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), src_ptr)) > 0) {
+        if (source->size + read > source->capacity) {
+            source->capacity = (source->size + read) * 2;
+            source->data = realloc(source->data, source->capacity);
+            assert(source->data != NULL);
+        }
+        memcpy(&source->data[source->size], chunk, read);
+        source->size += read;
+    }
+    rewind(src_ptr);
+}
+
+// the compiler that's running, a compiler that can't read itself can't tell its entries apart from another's
+static bool compiler_hash_init(void) {
+    FILE* exe_ptr = fopen("/proc/self/exe", "rb");
+    if (exe_ptr == NULL) { return FALSE; }
+    uint64_t hash = fnv1a(0xcbf29ce484222325ull, (const uint8_t*)compiler_id, sizeof(compiler_id));
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), exe_ptr)) > 0) {
+        hash = fnv1a(hash, chunk, read);
+    }
+    fclose(exe_ptr);
+    compiler_hash = hash;
+    return TRUE;
+}
+
+static uint64_t cache_key(const buffer_s* source) {
+    uint64_t hash = compiler_hash;
+    uint8_t backend = gen_backend;
+    hash = fnv1a(hash, &backend, 1);
+    uint8_t compact = resolve_compact;
+    hash = fnv1a(hash, &compact, 1);
+    return fnv1a(hash, source->data, source->size);
+}
+
+static void cache_path(char* path, uint64_t key, const char* suffix) {
+    sprintf(path, "%s/%016llx%s", cache_dir, (unsigned long long)key, suffix);
+}
+
+// an entry is the source then every stage, each as its size and bytes back to back,
+// a key that collides with another source's is a miss
+static bool cache_load(compile_s* compile, uint64_t key, const buffer_s* source) {
+    char path[512] = { 0 };
+    cache_path(path, key, ".cache");
+    FILE* entry_ptr = fopen(path, "rb");
+    if (entry_ptr == NULL) { return FALSE; }
+
+    bool complete = fget32(entry_ptr) == source->size && !feof(entry_ptr);
+    for (size_t i = 0; i < source->size && complete; i++) {
+        complete = fgetc(entry_ptr) == source->data[i];
+    }
+    for (int i = 0; i < STAGE_CACHED && complete; i++) {
+        buffer_s* buffer = &compile->buffers[i];
+        buffer->size = fget32(entry_ptr);
+        buffer->capacity = buffer->size;
+        buffer->data = malloc(buffer->size + 1);
+        assert(buffer->data != NULL);
+        complete = !feof(entry_ptr) && fread(buffer->data, 1, buffer->size, entry_ptr) == buffer->size;
+    }
+    fclose(entry_ptr);
+
+    if (!complete) {
+        for (int i = 0; i < STAGE_CACHED; i++) { buffer_free(&compile->buffers[i]); }
+    }
+    return complete;
+}
+
+// written aside and renamed into place, so other compiles never see half an entry
+static void cache_store(compile_s* compile, uint64_t key, const buffer_s* source) {
+    char path[512] = { 0 };
+    char temp_path[512] = { 0 };
+    char temp_suffix[64] = { 0 };
+    sprintf(temp_suffix, ".%ld.%ld.tmp", (long)getpid(), (long)(compile - compiles));
+    cache_path(path, key, ".cache");
+    cache_path(temp_path, key, temp_suffix);
+
+    FILE* entry_ptr = fopen(temp_path, "wb");
+    if (entry_ptr == NULL) { return; }
+    fput32(source->size, entry_ptr);
+    fwrite(source->data, 1, source->size, entry_ptr);
+    for (int i = 0; i < STAGE_CACHED; i++) {
+        fput32(compile->buffers[i].size, entry_ptr);
+        fwrite(compile->buffers[i].data, 1, compile->buffers[i].size, entry_ptr);
+    }
+    fclose(entry_ptr);
+    rename(temp_path, path);
+}
+
+  /////////////
+ // compile //
+/////////////
+
+static void compile_stages(compile_s* compile, FILE* src_ptr) {
+    token_array_s tokens = { 0 };
+    ast_arena_s ast = { 0 };
+
+    // ids from an earlier compile on this thread mean nothing here
+    intern_clear();
+
+    // tokenizer
+    tokenize(src_ptr, &tokens);
+
+    // parser
+    parse(&tokens, &ast);
+
+    // symgen
+    symgen(&ast);
+
+    // typechecker
+    typecheck(&ast);
+
+    // codegen
+    FILE* gen_ptr = stage_begin(compile, STAGE_GEN);
+    gen(src_ptr, &ast, gen_ptr);
+
+    // jump resolver
+    rewind(gen_ptr);
+    FILE* bin_ptr = stage_begin(compile, STAGE_BIN);
+    jump_resolution(gen_ptr, bin_ptr);
+    fclose(gen_ptr);
+    fclose(bin_ptr);
+
+    // the front end's outputs are only serialized when something keeps them
+    if (cache_dir != NULL || emit[STAGE_TOK]) {
+        FILE* tok_ptr = stage_begin(compile, STAGE_TOK);
+        tokens_save(&tokens, tok_ptr);
+        fclose(tok_ptr);
+    }
+    if (cache_dir != NULL || emit[STAGE_AST]) {
+        FILE* ast_ptr = stage_begin(compile, STAGE_AST);
+        ast_arena_save(&ast, ast_ptr);
+        fclose(ast_ptr);
+    }
+    tokens_free(&tokens);
+    ast_arena_free(&ast);
+}
+
+static void compile(compile_s* compile) {
+    FILE* src_ptr = fopen(compile->src_path, "rb");
+    if (src_ptr == NULL) {
+        fprintf(stderr, "Could not open '%s'!\n", compile->src_path);
+        compile->failed = TRUE;
+        return;
+    }
+
+    // unchanged sources skip every stage
+    if (cache_dir != NULL) {
+        buffer_s source = { 0 };
+        source_read(src_ptr, &source);
+        uint64_t key = cache_key(&source);
+        if (cache_load(compile, key, &source)) {
+            TRACE(TRACE_STAGES, "%s: cached\n", compile->src_path);
+        } else {
+            compile_stages(compile, src_ptr);
+            cache_store(compile, key, &source);
+        }
+        buffer_free(&source);
+    } else {
+        compile_stages(compile, src_ptr);
+    }
+    fclose(src_ptr);
+
+    // c
+    if (emit[STAGE_C]) {
+        FILE* bin_ptr = stage_begin(compile, STAGE_BIN);
+        FILE* c_ptr = stage_begin(compile, STAGE_C);
+        compile->failed = !emit_c(bin_ptr, c_ptr, compile->name);
+        fclose(bin_ptr);
+        fclose(c_ptr);
+    }
+
+    // thumb
+    if (emit[STAGE_S] && !compile->failed) {
+        FILE* bin_ptr = stage_begin(compile, STAGE_BIN);
+        FILE* s_ptr = stage_begin(compile, STAGE_S);
+        compile->failed = !emit_thumb(bin_ptr, s_ptr, compile->name);
+        fclose(bin_ptr);
+        fclose(s_ptr);
+    }
+
+    // vm
+    if (run && !compile->failed) {
+        FILE* bin_ptr = stage_begin(compile, STAGE_BIN);
+        compile->failed = !vm(bin_ptr);
+        fclose(bin_ptr);
+    }
+
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        if (emit[i] && !stage_emit(compile, i)) { compile->failed = TRUE; }
+        buffer_free(&compile->buffers[i]);
+    }
+}
+
+  ////////////
+ // worker //
+////////////
+
+static uint32_t next_compile = 0;
+static pthread_mutex_t next_compile_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// every worker pulls the next source until none are left
+static void* worker_main(void* arg) {
+    (void)arg;
+    while (TRUE) {
+        pthread_mutex_lock(&next_compile_lock);
+        uint32_t index = next_compile++;
+        pthread_mutex_unlock(&next_compile_lock);
+        if (index >= compile_count) { break; }
+        compile(&compiles[index]);
+    }
+    intern_clear();
+    return NULL;
+}
+
+  ///////////////
+ // arguments //
+///////////////
+
+static void usage(void) {
+    fprintf(stderr, "usage: shabbyc [--emit=tok|ast|gen|bin|c|s|all]... [--run] [-v|-vv] [-j N] [--out=<dir>] [--cache=<dir>] [--backend=stack|slots] [--compact] [--jit] <source>...\n");
+    exit(1);
+}
+
+static void parse_emit(char* stage_name) {
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        // c and thumb only translate code that verifies, so all leaves them out
+        if ((!strcmp(stage_name, "all") && i < STAGE_CACHED) || !strcmp(stage_name, stage_extensions[i])) {
+            emit[i] = TRUE;
+        }
+    }
+}
+
+  //////////
+ // main //
+//////////
+
+int main(int argc, char *argv[]) {
+    long jobs = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--emit=", 7)) {
+            parse_emit(&argv[i][7]);
+        } else if (!strcmp(argv[i], "--run")) {
+            run = TRUE;
+        } else if (!strcmp(argv[i], "-v") || !strcmp(argv[i], "-vv")) {
+            // -v prints each stage's tables, -vv every step, release builds print nothing
+            trace_level = (!strcmp(argv[i], "-v")) ? TRACE_STAGES : TRACE_STEPS;
+        } else if (!strncmp(argv[i], "--out=", 6) && argv[i][6] != '\0') {
+            out_dir = &argv[i][6];
+        } else if (!strncmp(argv[i], "--cache=", 8) && argv[i][8] != '\0') {
+            cache_dir = &argv[i][8];
+        } else if (!strcmp(argv[i], "--backend=stack")) {
+            gen_backend = BACKEND_STACK;
+        } else if (!strcmp(argv[i], "--backend=slots")) {
+            gen_backend = BACKEND_SLOTS;
+        } else if (!strcmp(argv[i], "--compact")) {
+            resolve_compact = TRUE;
+        } else if (!strcmp(argv[i], "--jit")) {
+            vm_use_jit = TRUE;
+        } else if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            jobs = atol(argv[++i]);
+        } else if (argv[i][0] != '-' && compile_count < MAX_SOURCES) {
+            compiles[compile_count].src_path = argv[i];
+            output_name(compiles[compile_count].name, argv[i]);
+            compile_count++;
+        } else {
+            usage();
+        }
+    }
+    if (compile_count == 0 || jobs < 1 || jobs > MAX_JOBS) { usage(); }
+
+    // two sources with the same name would write over each other's outputs
+    for (uint32_t i = 0; i < compile_count; i++) {
+        for (uint32_t j = 0; j < i; j++) {
+            if (!strcmp(compiles[i].name, compiles[j].name)) {
+                fprintf(stderr, "'%s' and '%s' both compile to '%s'!\n",
+                        compiles[j].src_path, compiles[i].src_path, compiles[i].name);
+                return 1;
+            }
+        }
+    }
+
+    // an existing directory is fine, anything else shows up as misses that never store
+    if (cache_dir != NULL) {
+        if (!compiler_hash_init()) {
+            fprintf(stderr, "Can't read the compiler to key the cache with, compiling without it!\n");
+            cache_dir = NULL;
+        } else {
+            mkdir(cache_dir, 0755);
+        }
+    }
+
+    // the calling thread is one of the workers
+    uint32_t thread_count = (compile_count < jobs) ? compile_count : (uint32_t)jobs;
+    pthread_t threads[MAX_JOBS];
+    for (uint32_t i = 1; i < thread_count; i++) {
+        int error = pthread_create(&threads[i], NULL, worker_main, NULL);
+        assert(error == 0);
+        (void)error;
+    }
+    worker_main(NULL);
+    for (uint32_t i = 1; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    int failures = 0;
+    for (uint32_t i = 0; i < compile_count; i++) {
+        if (compiles[i].failed) { failures++; }
+    }
+    return (failures == 0) ? 0 : 1;
+}
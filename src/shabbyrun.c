@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "file.h"
+#include "vm.h"
+
+// runs one compiled image many times over a pool of worker threads, every worker owns a vm
+// and the image is loaded once and shared read only between them
+
+#define MAX_JOBS 256
+#define RUN_BATCH 64 // runs an owner takes from its own queue at a time
+
+  ///////////
+ // input //
+///////////
+
+static image_s image; // mapped read only
+
+static uint8_t* frames = NULL; // input frames laid out back to back
+static uint16_t frame_size = 0;
+
+static uint32_t fuel = VM_FUEL_MAX; // backward jumps and calls per slice
+static bool checked = FALSE; // guard every instruction even if the image verified
+static bool jit = FALSE; // verified images run as native code
+static bool diff = FALSE; // every run also goes through the interpreter and has to end the same
+
+static uint8_t* read_file(const char* path, size_t* size) {
+    FILE* file_ptr = fopen(path, "rb");
+    if (file_ptr == NULL) {
+        fprintf(stderr, "Could not open '%s'!\n", path);
+        exit(1);
+    }
+    fseek(file_ptr, 0, SEEK_END);
+    long length = ftell(file_ptr);
+    assert(length >= 0);
+    fseek(file_ptr, 0, 0);
+
+    uint8_t* data = malloc(length);
+    assert(data != NULL);
+    size_t read = fread(data, 1, length, file_ptr);
+    assert(read == (size_t)length);
+    (void)read;
+    fclose(file_ptr);
+
+    *size = (size_t)length;
+    return data;
+}
+
+  /////////////////////////
+ // work stealing queue //
+/////////////////////////
+
+// each worker owns a range of run indices, it takes batches from the front
+// and idle workers steal the back half of someone else's range
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t begin;
+    uint32_t end;
+} run_queue_s;
+
+typedef struct {
+    pthread_t thread;
+    uint32_t index;
+    shabby_vm_t* vm;
+    shabby_vm_t* reference; // interpreter only, with diff
+    uint32_t runs;
+    uint32_t steals;
+    uint32_t yields;
+    uint32_t faults;
+    uint32_t checked; // runs that needed the guard
+    uint32_t mismatches; // runs the jit and the interpreter disagree on
+} worker_s;
+
+static run_queue_s queues[MAX_JOBS];
+static worker_s workers[MAX_JOBS];
+static uint32_t job_count = 0;
+
+static bool queue_take(run_queue_s* queue, uint32_t* begin, uint32_t* end) {
+    pthread_mutex_lock(&queue->lock);
+    bool found = (queue->begin < queue->end);
+    if (found) {
+        *begin = queue->begin;
+        *end = (queue->end - queue->begin > RUN_BATCH) ? queue->begin + RUN_BATCH : queue->end;
+        queue->begin = *end;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+// only one lock is held at a time, the thief's own queue is empty so nobody can take from it meanwhile
+static bool queue_steal(run_queue_s* victim, run_queue_s* own) {
+    pthread_mutex_lock(&victim->lock);
+    uint32_t remaining = victim->end - victim->begin;
+    uint32_t end = victim->end;
+    uint32_t split = end - (remaining + 1) / 2;
+    victim->end = split;
+    pthread_mutex_unlock(&victim->lock);
+    if (remaining == 0) { return FALSE; }
+
+    pthread_mutex_lock(&own->lock);
+    own->begin = split;
+    own->end = end;
+    pthread_mutex_unlock(&own->lock);
+    return TRUE;
+}
+
+// no work is ever added, so once every queue is empty the worker is done
+static bool worker_steal(worker_s* worker) {
+    for (uint32_t i = 1; i < job_count; i++) {
+        uint32_t victim = (worker->index + i) % job_count;
+        if (queue_steal(&queues[victim], &queues[worker->index])) {
+            worker->steals++;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static vm_status_t worker_run(shabby_vm_t* vm, uint32_t run, uint32_t* yields) {
+    vm_reset(vm);
+    if (frames != NULL) { vm_load_frame(vm, &frames[(size_t)run * frame_size], frame_size); }
+
+    // a real host would interleave other scripts between slices
+    vm_status_t status;
+    while ((status = vm_run(vm, fuel)) == VM_YIELDED) { (*yields)++; }
+    return status;
+}
+
+// both engines share the exec stack layout, so whatever they leave on it has to match byte for byte
+static bool worker_agree(worker_s* worker, uint32_t run, vm_status_t status) {
+    uint32_t yields = 0;
+    vm_status_t reference_status = worker_run(worker->reference, run, &yields);
+    uint32_t count, reference_count;
+    const uint8_t* stack = vm_stack(worker->vm, &count);
+    const uint8_t* reference_stack = vm_stack(worker->reference, &reference_count);
+    if (status == reference_status && count == reference_count && !memcmp(stack, reference_stack, count)) { return TRUE; }
+    fprintf(stderr, "Run %u differs between the jit and the interpreter!\n", run);
+    return FALSE;
+}
+
+static void* worker_main(void* arg) {
+    worker_s* worker = arg;
+    while (TRUE) {
+        uint32_t begin, end;
+        if (!queue_take(&queues[worker->index], &begin, &end)) {
+            if (!worker_steal(worker)) { break; }
+            continue;
+        }
+        for (uint32_t run = begin; run < end; run++) {
+            vm_status_t status = worker_run(worker->vm, run, &worker->yields);
+            if (status == VM_FAULTED) { worker->faults++; }
+            if (worker->reference != NULL && !worker_agree(worker, run, status)) { worker->mismatches++; }
+            if (vm_checked(worker->vm)) { worker->checked++; }
+            worker->runs++;
+        }
+    }
+    return NULL;
+}
+
+  ///////////////
+ // arguments //
+///////////////
+
+static void usage(void) {
+    fprintf(stderr, "usage: shabby-run [--jobs N] [--runs N] [--fuel N] [--checked] [--jit] [--diff] [--frames <file> --frame-size N] <bin>\n");
+    exit(1);
+}
+
+static long parse_count(int argc, char *argv[], int* i) {
+    if (*i + 1 >= argc) { usage(); }
+    (*i)++;
+    char* end = NULL;
+    long value = strtol(argv[*i], &end, 10);
+    if (*end != '\0' || value < 0) { usage(); }
+    return value;
+}
+
+  //////////
+ // main //
+//////////
+
+int main(int argc, char *argv[]) {
+    char* bin_path = NULL;
+    char* frames_path = NULL;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+    long runs = -1;
+    long frame_size_arg = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--jobs")) {
+            jobs = parse_count(argc, argv, &i);
+        } else if (!strcmp(argv[i], "--runs")) {
+            runs = parse_count(argc, argv, &i);
+        } else if (!strcmp(argv[i], "--fuel")) {
+            long fuel_arg = parse_count(argc, argv, &i);
+            if (fuel_arg < 1 || fuel_arg > (uint32_t)-1) { usage(); }
+            fuel = (uint32_t)fuel_arg;
+        } else if (!strcmp(argv[i], "--checked")) {
+            checked = TRUE;
+        } else if (!strcmp(argv[i], "--jit")) {
+            jit = TRUE;
+        } else if (!strcmp(argv[i], "--diff")) {
+            jit = TRUE;
+            diff = TRUE;
+        } else if (!strcmp(argv[i], "--frame-size")) {
+            frame_size_arg = parse_count(argc, argv, &i);
+        } else if (!strcmp(argv[i], "--frames") && i + 1 < argc) {
+            frames_path = argv[++i];
+        } else if (argv[i][0] != '-' && bin_path == NULL) {
+            bin_path = argv[i];
+        } else {
+            usage();
+        }
+    }
+    if (bin_path == NULL || jobs < 1 || jobs > MAX_JOBS) { usage(); }
+    if ((frames_path != NULL) != (frame_size_arg > 0) || frame_size_arg > (uint16_t)-1) { usage(); }
+
+    // one copy of the image for everyone
+    if (!image_map(&image, bin_path)) { return 1; }
+
+    // every frame is one run unless told otherwise
+    if (frames_path != NULL) {
+        size_t frames_size = 0;
+        frames = read_file(frames_path, &frames_size);
+        frame_size = (uint16_t)frame_size_arg;
+        long frame_count = frames_size / frame_size;
+        if (runs < 0) { runs = frame_count; }
+        if (runs > frame_count) {
+            fprintf(stderr, "Only %ld frames for %ld runs!\n", frame_count, runs);
+            return 1;
+        }
+    }
+    if (runs < 0) { runs = 1; }
+    assert(runs <= (uint32_t)-1);
+
+    // split the runs evenly, stealing evens out whatever is left
+    job_count = (uint32_t)jobs;
+    for (uint32_t i = 0; i < job_count; i++) {
+        pthread_mutex_init(&queues[i].lock, NULL);
+        queues[i].begin = (uint32_t)(runs * i / job_count);
+        queues[i].end = (uint32_t)(runs * (i + 1) / job_count);
+        workers[i] = (worker_s){ .index = i, .vm = vm_create_image(&image) };
+        if (workers[i].vm == NULL) { return 1; }
+        if (checked) { vm_check(workers[i].vm); }
+        if (jit) { vm_jit(workers[i].vm); }
+        if (diff) {
+            workers[i].reference = vm_create_image(&image);
+            if (checked) { vm_check(workers[i].reference); }
+        }
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0; i < job_count; i++) {
+        int error = pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]);
+        assert(error == 0);
+        (void)error;
+    }
+    uint32_t total_runs = 0;
+    uint32_t total_steals = 0;
+    uint32_t total_yields = 0;
+    uint32_t total_faults = 0;
+    uint32_t total_checked = 0;
+    uint32_t total_mismatches = 0;
+    for (uint32_t i = 0; i < job_count; i++) {
+        pthread_join(workers[i].thread, NULL);
+        total_runs += workers[i].runs;
+        total_steals += workers[i].steals;
+        total_yields += workers[i].yields;
+        total_faults += workers[i].faults;
+        total_checked += workers[i].checked;
+        total_mismatches += workers[i].mismatches;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    assert(total_runs == runs);
+
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%u runs on %u jobs in %.3fs, %u steals, %u yields, %u faults, %u checked\n",
+           total_runs, job_count, seconds, total_steals, total_yields, total_faults, total_checked);
+    if (diff) { printf("%u runs differ between the jit and the interpreter\n", total_mismatches); }
+
+    for (uint32_t i = 0; i < job_count; i++) {
+        vm_destroy(workers[i].vm);
+        if (workers[i].reference != NULL) { vm_destroy(workers[i].reference); }
+        pthread_mutex_destroy(&queues[i].lock);
+    }
+    free(frames);
+    image_unmap(&image);
+    return (total_faults == 0 && total_mismatches == 0) ? 0 : 1;
+}
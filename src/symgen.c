@@ -4,50 +4,47 @@
 #include <assert.h>
 #include "symbols.h"
 #include "file.h"
+#include "stages.h"
 #include "nodes.h"
 #include "types.h"
 #include "variables.h"
+#include "trace.h"
 
   ///////////////////
  // file pointers //
 ///////////////////
 
-static FILE *ast_ptr = NULL; // ast input/output
+static thread_local ast_arena_s *ast_ptr = NULL; // ast input/output
 
   /////////////////////
  // token utilities //
 /////////////////////
 
-static char token[MAX_TOKEN_LEN+1];
-// TODO: consolidate
+static thread_local char token[MAX_TOKEN_LEN+1];
 static void read_token(void) {
-    int last_position = ftell(ast_ptr);
-    memset(token, NULL, MAX_TOKEN_LEN);
-    fgets(token, MAX_TOKEN_LEN, ast_ptr);
-    assert(strlen(token) < MAX_TOKEN_LEN);
-    fseek(ast_ptr, last_position + strlen(token) + 1, 0);
+    ast_peek_token(ast_ptr, token);
 }
 
   //////////
  // misc //
 //////////
 
-static ast_s cur_node = { 0 };
-static ast_s peeked_node = { 0 };
+static thread_local ast_s cur_node = { 0 };
+static thread_local ast_s peeked_node = { 0 };
 
   ////////////////////////////
  // scheduled future nodes //
 ////////////////////////////
 
 typedef struct {
-    uint16_t offset;
+    addr_t offset;
     uint8_t attempts;
 } future_info_s;
 
-static future_info_s future_stack[FUTURE_STACK_SIZE] = { 0 };
-static uint16_t future_stack_count = 0;
+static thread_local future_info_s future_stack[FUTURE_STACK_SIZE] = { 0 };
+static thread_local uint16_t future_stack_count = 0;
 
-static void future_prepend(uint16_t offset, uint8_t attempts) {
+static void future_prepend(addr_t offset, uint8_t attempts) {
     for (int i = future_stack_count; i > 0; i--) {
         future_stack[i] = future_stack[i - 1];
     }
@@ -56,7 +53,7 @@ static void future_prepend(uint16_t offset, uint8_t attempts) {
     future_stack_count++;
 }
 
-static void future_push(uint16_t offset, uint8_t attempts) {
+static void future_push(addr_t offset, uint8_t attempts) {
     if (offset == NULL) { return; }
     future_stack[future_stack_count].offset = offset;
     future_stack[future_stack_count].attempts = attempts;
@@ -83,7 +80,7 @@ static void sg_declaration(uint8_t attempts) {
     read_token();
 
     bool is_type_ready = FALSE;
-    uint16_t type_offset = NULL;
+    addr_t type_offset = NULL;
     uint16_t pending = 0;
 
     // find type size
@@ -112,7 +109,7 @@ static void sg_declaration(uint8_t attempts) {
 
     if (!is_type_ready) {
         // reschedule node
-        printf("RESCHEDULE!\n");
+        TRACE(TRACE_STEPS, "RESCHEDULE!\n");
         future_prepend(cur_node.offset, attempts + 1);
     } else {
         // set this declaration's size
@@ -120,7 +117,7 @@ static void sg_declaration(uint8_t attempts) {
     }
 
     // search for class to add this declaration's size to
-    uint16_t parent_offset = cur_node.parent_offset;
+    addr_t parent_offset = cur_node.parent_offset;
     while (parent_offset != NULL) {
         ast_read_node(ast_ptr, parent_offset, &peeked_node);
         switch (peeked_node.node_type) {
@@ -144,7 +141,7 @@ static void sg_declaration(uint8_t attempts) {
 
 static void sg_statement(void) {
 
-    printf("%02X %02X\n", cur_node.children[0], cur_node.children[1]);
+    TRACE(TRACE_STEPS, "%02X %02X\n", cur_node.children[0], cur_node.children[1]);
 
     // push next statement
     future_push(cur_node.children[0], 0);
@@ -161,15 +158,15 @@ static void sg_class(void) {
 
 static void sg_evaluate(void) {
     // move to root node
-    fseek(ast_ptr, 0, 0);
-    future_push(fget16(ast_ptr), 0);
+    ast_ptr->position = 0;
+    future_push(ast_get_addr(ast_ptr), 0);
 
-    int bail = 0;
-    while(future_stack_count > 0 && ++bail < 1000) {
+    size_t bail = 0;
+    while(future_stack_count > 0 && ++bail < BAIL_LIMIT(ast_ptr->size)) {
         future_info_s info = future_pop();
         // navigate to offset and parse node
         ast_read_node(ast_ptr, info.offset, &cur_node);
-        printf("%s\n", node_constants[cur_node.node_type].name);
+        TRACE(TRACE_STEPS, "%s\n", node_constants[cur_node.node_type].name);
 
         switch (cur_node.node_type) {
             case NT_CLASS: sg_class(); break;
@@ -178,10 +175,10 @@ static void sg_evaluate(void) {
             default: break;
         }
     }
-    assert(bail < 1000);
+    assert(bail < BAIL_LIMIT(ast_ptr->size));
 }
 
-void symgen(FILE *ast_ptr_arg) {
+void symgen(ast_arena_s *ast_ptr_arg) {
     ast_ptr = ast_ptr_arg;
 
     sg_evaluate();
@@ -191,20 +188,26 @@ void symgen(FILE *ast_ptr_arg) {
  // main //
 //////////
 
+#ifndef SHABBY_LIBRARY
 int main(int argc, char *argv[]) {
     assert(argc == 2);
+    trace_level = TRACE_STEPS;
 
     char ast_buffer[256] = { 0 };
     sprintf(ast_buffer, "../bin/compilation/%s.ast", "out");
-    ast_ptr = fopen(ast_buffer, "r+b");
+    FILE* ast_file_ptr = fopen(ast_buffer, "r+b");
 
-    symgen(ast_ptr);
+    ast_arena_s ast = { 0 };
+    ast_arena_load(&ast, ast_file_ptr);
+    symgen(&ast);
+    rewind(ast_file_ptr);
+    ast_arena_save(&ast, ast_file_ptr);
+    ast_arena_free(&ast);
 
-    fclose(ast_ptr);
+    fclose(ast_file_ptr);
     return 0;
 
     // make pedantic compilers happy
-    node_constants[0] = node_constants[0];
-    types[0] = types[0];
     argv[0] = argv[0];
 }
+#endif
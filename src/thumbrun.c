@@ -0,0 +1,403 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "constants.h"
+
+// runs the function shabbyc --emit=s assembles to, straight from the object llvm-mc writes, a convenience
+// for a quick look on hosts without an arm linker or qemu. it's only as right as its own decoder, the
+// emitted thumb is checked under qemu-arm. only the armv6-m instructions the emitter uses are decoded and
+// anything else stops the run
+//
+//   0x00000000  flash, the object's .text
+//   0x20000000  ram, the exec stack then the count, the hardware stack grows down from the top
+
+#define FLASH_BASE 0x00000000u
+#define RAM_BASE 0x20000000u
+#define RAM_SIZE 0x20000u
+#define COUNT_ADDRESS (RAM_BASE + 0x10000u)
+#define RETURN_ADDRESS 0xFFFFFFFEu // what lr holds on entry, reaching it ends the run
+#define STEP_LIMIT 100000000u
+
+#define SP 13
+#define LR 14
+#define PC 15
+
+// exit statuses past the function's own 0 and 1
+#define STATUS_FAULT 2
+#define STATUS_TRAP 3
+
+  /////////
+ // cpu //
+/////////
+
+typedef struct {
+    uint32_t r[16];
+    bool n, z, c, v;
+    const uint8_t* flash;
+    uint32_t flash_size;
+    uint8_t ram[RAM_SIZE];
+} cpu_s;
+
+static cpu_s cpu;
+
+static void fault(const char* reason, uint32_t value) {
+    fprintf(stderr, "Thumb fault at %08X, %s %08X!\n", cpu.r[PC], reason, value);
+    exit(STATUS_FAULT);
+}
+
+// flash is read only and accesses have to be aligned like on a cortex-m0
+static uint8_t* memory(uint32_t address, uint32_t size, bool write) {
+    if (address % size != 0) { fault("unaligned access", address); }
+    if (!write && address - FLASH_BASE < cpu.flash_size && size <= cpu.flash_size - (address - FLASH_BASE)) {
+        return (uint8_t*)&cpu.flash[address - FLASH_BASE];
+    }
+    if (address >= RAM_BASE && address - RAM_BASE + size <= RAM_SIZE) { return &cpu.ram[address - RAM_BASE]; }
+    fault("bad access", address);
+    return NULL;
+}
+
+static uint32_t load(uint32_t address, uint32_t size) {
+    const uint8_t* at = memory(address, size, FALSE);
+    uint32_t value = 0;
+    for (uint32_t i = size; i-- > 0;) { value = (value << 8) | at[i]; }
+    return value;
+}
+
+static void store(uint32_t address, uint32_t size, uint32_t value) {
+    uint8_t* at = memory(address, size, TRUE);
+    for (uint32_t i = 0; i < size; i++) { at[i] = (uint8_t)(value >> (i * 8)); }
+}
+
+  ///////////
+ // flags //
+///////////
+
+static uint32_t set_nz(uint32_t result) {
+    cpu.n = result >> 31;
+    cpu.z = result == 0;
+    return result;
+}
+
+// subtraction is addition of the complement with the carry set
+static uint32_t add_with_carry(uint32_t a, uint32_t b, uint32_t carry) {
+    uint64_t unsigned_sum = (uint64_t)a + b + carry;
+    int64_t signed_sum = (int64_t)(int32_t)a + (int32_t)b + carry;
+    uint32_t result = (uint32_t)unsigned_sum;
+    cpu.c = unsigned_sum >> 32;
+    cpu.v = signed_sum != (int32_t)result;
+    return set_nz(result);
+}
+
+static bool condition(uint8_t cond) {
+    switch (cond) {
+        case 0x0: return cpu.z;
+        case 0x1: return !cpu.z;
+        case 0x2: return cpu.c;
+        case 0x3: return !cpu.c;
+        case 0x4: return cpu.n;
+        case 0x5: return !cpu.n;
+        case 0x6: return cpu.v;
+        case 0x7: return !cpu.v;
+        case 0x8: return cpu.c && !cpu.z;
+        case 0x9: return !cpu.c || cpu.z;
+        case 0xA: return cpu.n == cpu.v;
+        case 0xB: return cpu.n != cpu.v;
+        case 0xC: return !cpu.z && cpu.n == cpu.v;
+        case 0xD: return cpu.z || cpu.n != cpu.v;
+        default: return TRUE;
+    }
+}
+
+// shifts by an immediate or a register, an amount of 32 or more shifts everything out
+static uint32_t shift(uint8_t type, uint32_t value, uint32_t amount) {
+    if (amount == 0) { return value; }
+    switch (type) {
+        case 0: // lsl
+            cpu.c = (amount <= 32) ? (value >> (32 - amount)) & 1 : 0;
+            return (amount < 32) ? value << amount : 0;
+        case 1: // lsr
+            cpu.c = (amount <= 32) ? (value >> (amount - 1)) & 1 : 0;
+            return (amount < 32) ? value >> amount : 0;
+        default: // asr
+            if (amount >= 32) {
+                cpu.c = value >> 31;
+                return (value >> 31) ? 0xFFFFFFFFu : 0;
+            }
+            cpu.c = (value >> (amount - 1)) & 1;
+            return (uint32_t)((int32_t)value >> amount);
+    }
+}
+
+  //////////////
+ // decoding //
+//////////////
+
+static int32_t sign_extend(uint32_t value, uint8_t bits) {
+    uint32_t sign = 1u << (bits - 1);
+    return (int32_t)((value ^ sign) - sign);
+}
+
+// registers read as pc are 4 bytes ahead
+static uint32_t reg(uint8_t index) {
+    return (index == PC) ? cpu.r[PC] + 4 : cpu.r[index];
+}
+
+// only thumb state exists on armv6-m
+static uint32_t branch_target(uint32_t address) {
+    if (!(address & 1)) { fault("arm state branch to", address); }
+    return address & ~1u;
+}
+
+// one instruction, returns the next pc
+static uint32_t step(void) {
+    uint32_t pc = cpu.r[PC];
+    uint16_t h = (uint16_t)load(pc, 2);
+    uint32_t next = pc + 2;
+    uint8_t rd = h & 7;
+    uint8_t rn = (h >> 3) & 7;
+
+    // shift by immediate, add and subtract
+    if ((h >> 11) < 3) {
+        uint32_t amount = (h >> 6) & 31;
+        if (amount == 0 && (h >> 11) != 0) { amount = 32; }
+        cpu.r[rd] = set_nz(shift(h >> 11, cpu.r[rn], amount));
+    } else if ((h >> 11) == 3) {
+        uint32_t operand = ((h >> 10) & 1) ? (uint32_t)((h >> 6) & 7) : cpu.r[(h >> 6) & 7];
+        bool subtract = (h >> 9) & 1;
+        cpu.r[rd] = subtract ? add_with_carry(cpu.r[rn], ~operand, 1) : add_with_carry(cpu.r[rn], operand, 0);
+
+    // movs, cmp, adds and subs with an 8 bit immediate
+    } else if ((h >> 13) == 1) {
+        uint8_t rdn = (h >> 8) & 7;
+        uint32_t imm = h & 0xFF;
+        switch ((h >> 11) & 3) {
+            case 0: cpu.r[rdn] = set_nz(imm); break;
+            case 1: add_with_carry(cpu.r[rdn], ~imm, 1); break;
+            case 2: cpu.r[rdn] = add_with_carry(cpu.r[rdn], imm, 0); break;
+            default: cpu.r[rdn] = add_with_carry(cpu.r[rdn], ~imm, 1); break;
+        }
+
+    // data processing on low registers
+    } else if ((h >> 10) == 0x10) {
+        uint32_t a = cpu.r[rd];
+        uint32_t b = cpu.r[rn];
+        switch ((h >> 6) & 15) {
+            case 0x0: cpu.r[rd] = set_nz(a & b); break;
+            case 0x1: cpu.r[rd] = set_nz(a ^ b); break;
+            case 0x2: cpu.r[rd] = set_nz(shift(0, a, b & 0xFF)); break;
+            case 0x3: cpu.r[rd] = set_nz(shift(1, a, b & 0xFF)); break;
+            case 0x4: cpu.r[rd] = set_nz(shift(2, a, b & 0xFF)); break;
+            case 0x5: cpu.r[rd] = add_with_carry(a, b, cpu.c); break;
+            case 0x6: cpu.r[rd] = add_with_carry(a, ~b, cpu.c); break;
+            case 0x8: set_nz(a & b); break;
+            case 0x9: cpu.r[rd] = add_with_carry(~b, 0, 1); break;
+            case 0xA: add_with_carry(a, ~b, 1); break;
+            case 0xB: add_with_carry(a, b, 0); break;
+            case 0xC: cpu.r[rd] = set_nz(a | b); break;
+            case 0xD: cpu.r[rd] = set_nz(a * b); break;
+            case 0xE: cpu.r[rd] = set_nz(a & ~b); break;
+            case 0xF: cpu.r[rd] = set_nz(~b); break;
+            default: fault("unsupported instruction", h);
+        }
+
+    // add, cmp, mov and bx on any register
+    } else if ((h >> 10) == 0x11) {
+        uint8_t rm = (h >> 3) & 15;
+        uint8_t rdn = ((h >> 4) & 8) | rd;
+        switch ((h >> 8) & 3) {
+            case 0:
+                if (rdn == PC) { next = (reg(PC) + reg(rm)) & ~1u; } else { cpu.r[rdn] += reg(rm); }
+                break;
+            case 1: add_with_carry(reg(rdn), ~reg(rm), 1); break;
+            case 2:
+                if (rdn == PC) { next = reg(rm) & ~1u; } else { cpu.r[rdn] = reg(rm); }
+                break;
+            default:
+                if ((h >> 7) & 1) { cpu.r[LR] = next | 1; }
+                next = branch_target(reg(rm));
+                break;
+        }
+
+    // loads and stores
+    } else if ((h >> 11) == 9) {
+        cpu.r[(h >> 8) & 7] = load(((pc + 4) & ~3u) + (h & 0xFF) * 4, 4);
+    } else if ((h >> 12) == 5) {
+        uint32_t address = cpu.r[rn] + cpu.r[(h >> 6) & 7];
+        switch ((h >> 9) & 7) {
+            case 0: store(address, 4, cpu.r[rd]); break;
+            case 1: store(address, 2, cpu.r[rd]); break;
+            case 2: store(address, 1, cpu.r[rd]); break;
+            case 3: cpu.r[rd] = (uint32_t)(int8_t)load(address, 1); break;
+            case 4: cpu.r[rd] = load(address, 4); break;
+            case 5: cpu.r[rd] = load(address, 2); break;
+            case 6: cpu.r[rd] = load(address, 1); break;
+            default: cpu.r[rd] = (uint32_t)(int16_t)load(address, 2); break;
+        }
+    } else if ((h >> 13) == 3 || (h >> 12) == 8) {
+        uint32_t size = ((h >> 12) == 8) ? 2 : (((h >> 12) & 1) ? 1 : 4);
+        uint32_t address = cpu.r[rn] + ((h >> 6) & 31) * size;
+        if ((h >> 11) & 1) { cpu.r[rd] = load(address, size); } else { store(address, size, cpu.r[rd]); }
+    } else if ((h >> 12) == 9) {
+        uint32_t address = cpu.r[SP] + (h & 0xFF) * 4;
+        if ((h >> 11) & 1) { cpu.r[(h >> 8) & 7] = load(address, 4); } else { store(address, 4, cpu.r[(h >> 8) & 7]); }
+
+    // adr and add to sp
+    } else if ((h >> 12) == 0xA) {
+        uint32_t base = ((h >> 11) & 1) ? cpu.r[SP] : (pc + 4) & ~3u;
+        cpu.r[(h >> 8) & 7] = base + (h & 0xFF) * 4;
+    } else if ((h >> 8) == 0xB0) {
+        uint32_t imm = (h & 0x7F) * 4;
+        cpu.r[SP] = ((h >> 7) & 1) ? cpu.r[SP] - imm : cpu.r[SP] + imm;
+
+    // extends
+    } else if ((h >> 8) == 0xB2) {
+        uint32_t value = cpu.r[rn];
+        switch ((h >> 6) & 3) {
+            case 0: cpu.r[rd] = (uint32_t)(int16_t)value; break;
+            case 1: cpu.r[rd] = (uint32_t)(int8_t)value; break;
+            case 2: cpu.r[rd] = value & 0xFFFF; break;
+            default: cpu.r[rd] = value & 0xFF; break;
+        }
+
+    // push and pop, the lowest register at the lowest address
+    } else if ((h >> 9) == 0x5A) {
+        uint16_t list = (h & 0xFF) | (((h >> 8) & 1) << LR);
+        for (uint8_t i = 16; i-- > 0;) {
+            if (list & (1 << i)) {
+                cpu.r[SP] -= 4;
+                store(cpu.r[SP], 4, cpu.r[i]);
+            }
+        }
+    } else if ((h >> 9) == 0x5E) {
+        uint16_t list = (h & 0xFF) | (((h >> 8) & 1) << PC);
+        for (uint8_t i = 0; i < 16; i++) {
+            if (!(list & (1 << i))) { continue; }
+            uint32_t value = load(cpu.r[SP], 4);
+            cpu.r[SP] += 4;
+            if (i == PC) { next = branch_target(value); } else { cpu.r[i] = value; }
+        }
+    } else if (h == 0xBF00) {
+        // nop
+
+    // branches, udf traps like a cortex-m0 would with a hard fault
+    } else if ((h >> 8) == 0xDE) {
+        fprintf(stderr, "Thumb trap at %08X!\n", pc);
+        exit(STATUS_TRAP);
+    } else if ((h >> 12) == 0xD && ((h >> 8) & 15) != 0xF) {
+        if (condition((h >> 8) & 15)) { next = pc + 4 + sign_extend(h & 0xFF, 8) * 2; }
+    } else if ((h >> 11) == 0x1C) {
+        next = pc + 4 + sign_extend(h & 0x7FF, 11) * 2;
+    } else if ((h >> 11) == 0x1E) {
+        uint16_t h2 = (uint16_t)load(pc + 2, 2);
+        if ((h2 >> 14) != 3 || !((h2 >> 12) & 1)) { fault("unsupported instruction", ((uint32_t)h << 16) | h2); }
+        uint32_t s = (h >> 10) & 1;
+        uint32_t i1 = !(((h2 >> 13) & 1) ^ s);
+        uint32_t i2 = !(((h2 >> 11) & 1) ^ s);
+        uint32_t offset = (s << 24) | (i1 << 23) | (i2 << 22) | ((uint32_t)(h & 0x3FF) << 12) | ((uint32_t)(h2 & 0x7FF) << 1);
+        cpu.r[LR] = (pc + 4) | 1;
+        next = pc + 4 + sign_extend(offset, 25);
+    } else {
+        fault("unsupported instruction", h);
+    }
+    return next;
+}
+
+  /////////
+ // elf //
+/////////
+
+static uint32_t read32(const uint8_t* at) {
+    return at[0] | (at[1] << 8) | (at[2] << 16) | ((uint32_t)at[3] << 24);
+}
+
+static uint16_t read16(const uint8_t* at) {
+    return at[0] | (at[1] << 8);
+}
+
+static void invalid(const char* reason) {
+    fprintf(stderr, "Invalid object, %s!\n", reason);
+    exit(1);
+}
+
+// the section headers of a little endian elf32 object, bounds checked against the file
+static const uint8_t* section(const uint8_t* object, size_t size, uint32_t index) {
+    uint32_t offset = read32(&object[0x20]) + index * read16(&object[0x2E]);
+    if (index >= read16(&object[0x30]) || offset + 40 > size) { invalid("section out of bounds"); }
+    const uint8_t* header = &object[offset];
+    if (read32(&header[4]) != 8 && read32(&header[16]) + read32(&header[20]) > size) { invalid("section data out of bounds"); }
+    return header;
+}
+
+// loads .text as flash and returns where the shabby_ function starts, an object that still needs
+// relocating isn't something the emitter writes
+static uint32_t load_object(const uint8_t* object, size_t size) {
+    if (size < 0x34 || memcmp(object, "\x7F" "ELF\x01\x01", 6) || read16(&object[0x12]) != 40) { invalid("not a little endian arm elf32 object"); }
+    const uint8_t* names = section(object, size, read16(&object[0x32]));
+    uint32_t text_index = 0;
+    const uint8_t* symbols = NULL;
+    for (uint32_t i = 1; i < read16(&object[0x30]); i++) {
+        const uint8_t* header = section(object, size, i);
+        const char* name = (const char*)&object[read32(&names[16]) + read32(&header[0])];
+        uint32_t type = read32(&header[4]);
+        if (!strcmp(name, ".text")) {
+            text_index = i;
+            cpu.flash = &object[read32(&header[16])];
+            cpu.flash_size = read32(&header[20]);
+        }
+        if (type == 2) { symbols = header; }
+        if ((type == 4 || type == 9) && read32(&header[20]) > 0) { invalid("relocations are unsupported"); }
+    }
+    if (text_index == 0 || symbols == NULL) { invalid("no .text or symbols"); }
+
+    const uint8_t* strings = section(object, size, read32(&symbols[24]));
+    for (uint32_t at = 0; at + 16 <= read32(&symbols[20]); at += 16) {
+        const uint8_t* symbol = &object[read32(&symbols[16]) + at];
+        const char* name = (const char*)&object[read32(&strings[16]) + read32(&symbol[0])];
+        if (read16(&symbol[14]) == text_index && !strncmp(name, "shabby_", 7)) { return read32(&symbol[4]) & ~1u; }
+    }
+    invalid("no shabby_ function");
+    return 0;
+}
+
+  //////////
+ // main //
+//////////
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: thumb-run <object>\n");
+        return 1;
+    }
+    FILE* object_ptr = fopen(argv[1], "rb");
+    if (object_ptr == NULL) {
+        fprintf(stderr, "Could not open '%s'!\n", argv[1]);
+        return 1;
+    }
+    fseek(object_ptr, 0, SEEK_END);
+    long size = ftell(object_ptr);
+    assert(size >= 0);
+    fseek(object_ptr, 0, 0);
+    uint8_t* object = malloc(size);
+    assert(size == 0 || object != NULL);
+    size_t read = fread(object, 1, size, object_ptr);
+    assert(read == (size_t)size);
+    (void)read;
+    fclose(object_ptr);
+
+    // int shabby_name(uint8_t* stack, uint32_t* count) with an empty stack
+    cpu.r[PC] = FLASH_BASE + load_object(object, size);
+    cpu.r[0] = RAM_BASE;
+    cpu.r[1] = COUNT_ADDRESS;
+    cpu.r[SP] = RAM_BASE + RAM_SIZE;
+    cpu.r[LR] = RETURN_ADDRESS | 1;
+
+    uint32_t steps = 0;
+    while (cpu.r[PC] != RETURN_ADDRESS) {
+        if (++steps > STEP_LIMIT) { fault("gave up after steps", steps); }
+        cpu.r[PC] = step();
+    }
+
+    free(object);
+    return (int)cpu.r[0];
+}
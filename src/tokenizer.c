@@ -1,139 +1,131 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include "symbols.h"
 #include "file.h"
-
-  ///////////////////
- // file pointers //
-///////////////////
-
-static FILE *src_ptr = NULL; // source code
-static FILE *tok_ptr = NULL; // output
+#include "stages.h"
+#include "intern.h"
+#include "tokens.h"
+#include "trace.h"
 
   /////////////////
  // input state //
 /////////////////
 
-static uint8_t c = 0; // current character
-static uint16_t c_index = -1; // index of the current character
+static thread_local const uint8_t *src = NULL; // source code
+static thread_local size_t src_size = 0;
+static thread_local token_array_s *tokens = NULL; // output
 
-// read the next character, output why we've advanced in debug mode
-#ifdef DEBUG
-    static void read(char* reason) {
-        printf("%s  %c\n", reason, c);
-        c = fgetc(src_ptr);
-        c_index++;
-    }
-#else
-    static void read(void) {
-        c = fgetc(src_ptr);
-        c_index++;
-    }
-#endif
+  //////////////////
+ // run scanning //
+//////////////////
+
+static size_t skip_whitespace(size_t i) {
+    while (i < src_size && (char_classes[src[i]] & CHAR_WHITESPACE)) { i++; }
+    return i;
+}
 
-static void consume_whitespace(void) {
-    while (is_whitespace(c)) { read(DBG_STR("ws")); }
+static size_t skip_identifier(size_t i) {
+    while (i < src_size && (char_classes[src[i]] & CHAR_IDENTIFIER)) { i++; }
+    return i;
 }
 
-static void next_token(void) {
-    // EOF
-    if (c == (uint8_t)EOF) { return; }
+  ////////////////
+ // tokenizing //
+////////////////
+
+// end of the token starting at i
+static size_t next_token(size_t i) {
+    uint8_t c = src[i];
 
     // identifiers [a-zA-Z_][0-9a-zA-Z_]+
-    if (is_alphanumeric(c) || (c == '_')) {
-        while (is_alphanumeric(c) || (c == '_')) {
-            read(DBG_STR("an"));
-        }
-        return;
+    if (char_classes[c] & CHAR_IDENTIFIER) {
+        return skip_identifier(i + 1);
     }
 
     // symbols
-    uint8_t last = c;
-    read(DBG_STR("sy"));
-    if (c == '=' && (is_math_op(last) || last == '=')) {
-        read(DBG_STR("sy"));
+    if (i + 1 < src_size && src[i + 1] == '=' && ((char_classes[c] & CHAR_MATH_OP) || c == '=')) {
+        return i + 2;
     }
+    return i + 1;
 }
 
-static void output(uint16_t start_index, uint8_t length) {
-    fput16(start_index, tok_ptr);
-    fputc(length, tok_ptr);
-    assert(length <= MAX_TOKEN_LEN);
+// tokenize size bytes of source
+void tokenize_buffer(const uint8_t* src_arg, size_t size, token_array_s* tokens_arg) {
+    src = src_arg;
+    src_size = size;
+    tokens = tokens_arg;
+
+    size_t i = skip_whitespace(0);
+    while (i < src_size) {
+        size_t end = next_token(i);
+        assert(end - i <= MAX_TOKEN_LEN);
+        tokens_add(tokens, token_kind(src[i]), i, (const char*)&src[i], end - i);
+        i = skip_whitespace(end);
+    }
 }
 
-void tokenize(FILE* ptr) {
-    src_ptr = ptr;
-
-    // print header for why we consumed certain chars
-    #ifdef DEBUG
-        printf("\n");
-        printf("rsn c\n");
-        printf("--- -\n");
-    #endif
-
-    // consume first character
-    read(DBG_STR("st"));
-
-    // allocate space for token count
-    fput16(0, tok_ptr);
-
-    uint16_t token_count = 0;
-    while (c != (uint8_t)EOF) {
-        // ignore all whitespace
-        consume_whitespace();
-
-        // read token and remember start/length
-        uint16_t token_start = c_index;
-        next_token();
-        uint16_t length = (c_index - token_start);
-
-        // output if token has length
-        if (length > 0) {
-            token_count++;
-            output(token_start, length);
+void tokenize(FILE* src_ptr, token_array_s* tokens_arg) {
+    // read the whole source in large blocks
+    size_t capacity = 64 * 1024;
+    size_t size = 0;
+    uint8_t* buffer = malloc(capacity);
+    assert(buffer != NULL);
+    size_t read;
+    while ((read = fread(&buffer[size], 1, capacity - size, src_ptr)) > 0) {
+        size += read;
+        if (size == capacity) {
+            capacity *= 2;
+            buffer = realloc(buffer, capacity);
+            assert(buffer != NULL);
         }
     }
 
-    // write token count
-    fseek(tok_ptr, 0, 0);
-    fput16(token_count, tok_ptr);
+    tokenize_buffer(buffer, size, tokens_arg);
 
     // print out entire file
     #ifdef DEBUG
+    if (TRACING(TRACE_STAGES)) {
         printf("\n");
         printf("raw       token\n");
         printf("--------  ----------------\n");
-        for (uint16_t i = 0; i < token_count; i++) {
+        for (uint32_t i = 0; i < tokens->count; i++) {
             // print raw token offsets
-            uint16_t start_index = fget16(tok_ptr);
-            uint8_t length = fgetc(tok_ptr);
-            printf("%02X %02X %02X", (start_index % 256), (start_index >> 8), length);
-
-            // print src token string
-            char buffer[length + 1];
-            fseek(src_ptr, start_index, 0);
-            fgets(buffer, length + 1, src_ptr);
-            buffer[length] = NULL;
-            printf("  %s\n", buffer);
+            token_s* token = &tokens->data[i];
+            printf("%02X %02X %02X", (token->start % 256), ((token->start >> 8) % 256), token->length);
+
+            // print token string
+            printf("  %s\n", interned(token->id));
         }
+    }
     #endif
+
+    free(buffer);
+    src = NULL;
+    src_size = 0;
 }
 
+#ifndef SHABBY_LIBRARY
 int main(int argc, char *argv[]) {
     assert(argc == 2);
+    trace_level = TRACE_STEPS;
 
     char src_buffer[256] = { 0 };
     sprintf(src_buffer, "%s", argv[1]);
-    src_ptr = fopen(src_buffer, "rb");
+    FILE* src_ptr = fopen(src_buffer, "rb");
 
     char tok_buffer[256] = { 0 };
     sprintf(tok_buffer, "../bin/compilation/%s.tok", "out");
-    tok_ptr = fopen(tok_buffer, "wb+");
+    FILE* tok_ptr = fopen(tok_buffer, "wb");
 
-    tokenize(src_ptr);
+    token_array_s token_array = { 0 };
+    tokenize(src_ptr, &token_array);
+    tokens_save(&token_array, tok_ptr);
+    tokens_free(&token_array);
 
     fclose(tok_ptr);
     fclose(src_ptr);
     return 0;
 }
+#endif
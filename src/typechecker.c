@@ -1,52 +1,85 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
 #include <assert.h>
 #include "symbols.h"
 #include "file.h"
+#include "stages.h"
 #include "nodes.h"
 #include "types.h"
 #include "variables.h"
+#include "trace.h"
 
   ///////////////////
  // file pointers //
 ///////////////////
 
-static FILE *ast_ptr = NULL; // ast input/output
+static thread_local ast_arena_s *ast_ptr = NULL; // ast input/output
 
   //////////
  // misc //
 //////////
 
-static ast_s cur_node = { 0 };
-static ast_s peeked_node = { 0 };
+static thread_local ast_s cur_node = { 0 };
+static thread_local ast_s peeked_node = { 0 };
 
 typedef struct {
     uint8_t constant_count;
     int32_t constant_value;
+    type_t pushed_type; // widest constant pushed straight into it
+    bool inexact; // the runtime wouldn't get constant_value, see ce_propagate
 } const_expr_t;
 
-#define MAX_SCRATCH 64
-static const_expr_t scratch[MAX_SCRATCH] = { 0 };
-static uint8_t on_scratch_index = 0;
+// one per term/expression reached by a constant, index zero is left unused
+static thread_local const_expr_t* scratch = NULL;
+static thread_local addr_t scratch_count = 0;
+static thread_local addr_t scratch_capacity = 0;
+
+static addr_t scratch_new(void) {
+    if (scratch_count >= scratch_capacity) {
+        scratch_capacity = (scratch_capacity == 0) ? 64 : scratch_capacity * 2;
+        scratch = realloc(scratch, scratch_capacity * sizeof(const_expr_t));
+        assert(scratch != NULL);
+    }
+    memset(&scratch[scratch_count], 0, sizeof(const_expr_t));
+    return scratch_count++;
+}
+
+static void scratch_free(void) {
+    free(scratch);
+    scratch = NULL;
+    scratch_count = 0;
+    scratch_capacity = 0;
+}
+
+// every operand of the term/expression was constant
+static bool is_folded(ast_s* node) {
+    return node->scratch != 0 && scratch[node->scratch].constant_count == 2;
+}
+
+// folded, and the value is what the runtime would have computed
+static bool is_exact(ast_s* node) {
+    return is_folded(node) && !scratch[node->scratch].inexact;
+}
 
   ////////////////////////////
  // scheduled future nodes //
 ////////////////////////////
 
-#define FUTURE_SCOPE_DECREMENT ((uint16_t)-1)
+#define FUTURE_SCOPE_DECREMENT ((addr_t)-1)
 
-static uint16_t future_stack[FUTURE_STACK_SIZE] = { 0 };
-static uint16_t future_stack_count = 0;
+static thread_local addr_t future_stack[FUTURE_STACK_SIZE] = { 0 };
+static thread_local uint16_t future_stack_count = 0;
 
-static void future_push(uint16_t offset) {
+static void future_push(addr_t offset) {
     if (offset == NULL) { return; }
     future_stack[future_stack_count] = offset;
     future_stack_count++;
     assert(future_stack_count < FUTURE_STACK_SIZE);
 }
 
-static uint16_t future_pop(void) {
+static addr_t future_pop(void) {
     assert(future_stack_count > 0);
     future_stack_count--;
     return future_stack[future_stack_count];
@@ -56,34 +89,44 @@ static uint16_t future_pop(void) {
  // token utilities //
 /////////////////////
 
-static char token[MAX_TOKEN_LEN+1];
+static thread_local char token[MAX_TOKEN_LEN+1];
 static void read_token(void) {
-    int last_position = ftell(ast_ptr);
-    memset(token, NULL, MAX_TOKEN_LEN);
-    fgets(token, MAX_TOKEN_LEN, ast_ptr);
-    assert(strlen(token) < MAX_TOKEN_LEN);
-    fseek(ast_ptr, last_position + strlen(token) + 1, 0);
+    ast_peek_token(ast_ptr, token);
+}
+
+  ////////////
+ // errors //
+////////////
+
+// a program that doesn't typecheck stops the compile, release builds included
+static void type_error(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "Type error!\n");
+    vfprintf(stderr, format, args);
+    va_end(args);
+    exit(1);
 }
 
   /////////////////////
  // write utilities //
 /////////////////////
 
-static void ast_write_type(type_t type, uint16_t offset) {
-    fseek(ast_ptr, offset + 1, 0);
-    fputc(type, ast_ptr);
+static void ast_write_type(type_t type, addr_t offset) {
+    ast_ptr->data[AST_ADDR_VALUE_TYPE(offset)] = type;
 }
 
-static uint16_t insert_cast(type_t type, uint16_t parent_offset, uint16_t child_offset) {
+static addr_t insert_cast(type_t type, addr_t parent_offset, addr_t child_offset) {
     assert(type != TYPE_USER_DEFINED && type != TYPE_NONE);
     ast_s node = { 0 };
     node.node_type = NT_CAST;
     node.parent_offset = parent_offset;
     node.children[0] = child_offset;
     node.value_type = type;
-    printf("<inserted cast>\n");
+    TRACE(TRACE_STEPS, "<inserted cast>\n");
     ast_insert_new_node(ast_ptr, &node);
-    fprintf(ast_ptr, "%s", types[type].name);
+    ast_puts(types[type].name, ast_ptr);
+    ast_putc(NULL, ast_ptr);
     return node.offset;
 }
 
@@ -91,8 +134,18 @@ static uint16_t insert_cast(type_t type, uint16_t parent_offset, uint16_t child_
  // constant expression phase //
 ///////////////////////////////
 
+static type_t ce_type(int32_t value) {
+    if (value >= -128 && value <= 127) { return TYPE_BYTE; }
+    if (value >= -32768 && value <= 32767) { return TYPE_SHORT; }
+    return TYPE_NONE;
+}
+
 static void ce_propagate(int32_t value) {
     ast_s node = cur_node;
+    bool inexact = FALSE;
+    // the constant as it's pushed, casts come after it, only until the first term/expression
+    bool direct = TRUE;
+    int32_t pushed = value;
     while (TRUE) {
         // search for parent that is type <term> or <expression> and has a <term_op> or a <expression_op>
         bool searching = TRUE;
@@ -119,7 +172,12 @@ static void ce_propagate(int32_t value) {
                     ast_read_node(ast_ptr, node.children[0], &peeked_node);
                     read_token();
                     switch (token[0]) {
-                        case '-': value = -value; break;
+                        case '-':
+                            // negating the smallest value of the type below doesn't fit back into it
+                            if (!direct && value != -value && ce_type(value) != ce_type(-value)) { inexact = TRUE; }
+                            value = -value;
+                            pushed = -pushed;
+                            break;
                         default: assert(FALSE);
                     }
                     break;
@@ -129,34 +187,39 @@ static void ce_propagate(int32_t value) {
 
         // create scratch structure
         if (node.scratch == 0) {
-            on_scratch_index++;
-            assert(on_scratch_index < MAX_SCRATCH);
-            node.scratch = on_scratch_index;
-            ast_overwrite_scratch(ast_ptr, node.offset, on_scratch_index);
+            node.scratch = scratch_new();
+            ast_overwrite_scratch(ast_ptr, node.offset, node.scratch);
         }
 
         const_expr_t* ce = &scratch[node.scratch];
 
-        // increment
+        // increment, terms and expressions only ever have two operands
         ce->constant_count++;
         assert(ce->constant_count <= 2);
 
         // this term/expression hasn't been seen by another constant yet, store the value
+        if (direct && ce_type(pushed) > ce->pushed_type) { ce->pushed_type = ce_type(pushed); }
         if (ce->constant_count == 1) {
             ce->constant_value = value;
+            ce->inexact = inexact;
             return;
         }
+        ce->inexact |= inexact;
 
         // retrieve term/expression operator
         ast_read_node(ast_ptr, node.children[1], &peeked_node);
         read_token();
 
         // evaluate term/expression
+        int32_t left = ce->constant_value;
         switch(token[0]) {
             case '+': ce->constant_value += value; break;
             case '-': ce->constant_value -= value; break;
             case '*': ce->constant_value *= value; break;
-            case '/': ce->constant_value /= value; break;
+            case '/':
+                if (value == 0) { type_error("Constant expression divides by zero.\n"); }
+                ce->constant_value /= value;
+                break;
             default: assert(FALSE);
         }
 
@@ -167,28 +230,32 @@ static void ce_propagate(int32_t value) {
         } else if (ce->constant_value >= -32768 && ce->constant_value <= 32767) {
             type = TYPE_SHORT;
         } else {
-            printf("Type error!\n"
-                   "Constant expression exceeds the largest datatype bounds.\n"
-                   "Evaluated to: %d\n", ce->constant_value);
-            assert(FALSE);
+            type_error("Constant expression exceeds the largest datatype bounds.\n"
+                       "Evaluated to: %d\n", ce->constant_value);
         }
 
         // write type
         ast_write_type(type, node.offset);
 
+        // the runtime pushes the constants straight under it at this type, and divides unsigned, either
+        // can give a different answer than the value here
+        if (ce->pushed_type > type || (token[0] == '/' && (left < 0 || value < 0))) { ce->inexact = TRUE; }
+
         // pass this value up to the next term/expression
         value = ce->constant_value;
+        inexact = ce->inexact;
+        direct = FALSE;
     }
 }
 
 static void ce_evaluate(void) {
     // move to root node
-    fseek(ast_ptr, 0, 0);
-    future_push(fget16(ast_ptr));
+    ast_ptr->position = 0;
+    future_push(ast_get_addr(ast_ptr));
 
-    int bail = 0;
-    while(future_stack_count > 0 && ++bail < 1000) {
-        uint16_t offset = future_pop();
+    size_t bail = 0;
+    while(future_stack_count > 0 && ++bail < BAIL_LIMIT(ast_ptr->size)) {
+        addr_t offset = future_pop();
         // navigate to offset and parse node
         ast_read_node(ast_ptr, offset, &cur_node);
 
@@ -200,13 +267,253 @@ static void ce_evaluate(void) {
 
         // extract constant value
         if (cur_node.node_type == NT_CONSTANT) {
-            int32_t value = 0;
-            assert(fscanf(ast_ptr, "%d", &value) == 1);
-            ce_propagate(value);
+            read_token();
+            ce_propagate(atoi(token));
+        }
+
+    }
+    assert(bail < BAIL_LIMIT(ast_ptr->size));
+}
+
+  ///////////////////
+ // folding phase //
+///////////////////
+
+// the value of a subtree built only out of constants
+static bool fold_value(addr_t offset, int32_t* value) {
+    ast_s node = { 0 };
+    ast_read_node(ast_ptr, offset, &node);
+    switch (node.node_type) {
+        case NT_CONSTANT:
+            read_token();
+            *value = atoi(token);
+            return TRUE;
+        case NT_TERM:
+        case NT_EXPRESSION:
+            if (node.children[1] == NULL) { return fold_value(node.children[2], value); }
+            if (!is_exact(&node)) { return FALSE; }
+            *value = scratch[node.scratch].constant_value;
+            return TRUE;
+        case NT_FACTOR:
+            if (!fold_value(node.children[1], value)) { return FALSE; }
+            if (node.children[0] == NULL) { return TRUE; }
+            ast_read_node(ast_ptr, node.children[0], &node);
+            read_token();
+            switch (token[0]) {
+                case '-': *value = -*value; break;
+                default: assert(FALSE);
+            }
+            return TRUE;
+        case NT_CAST:
+            if (!fold_value(node.children[0], value)) { return FALSE; }
+            ast_read_node(ast_ptr, offset, &node);
+            read_token();
+            switch (get_type(token)) {
+                case TYPE_BYTE: *value = (int8_t)*value; break;
+                case TYPE_SHORT: *value = (int16_t)*value; break;
+                default: assert(FALSE);
+            }
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+// a cast under a node that isn't folded as a whole decides its width, so it has to stay
+static bool fold_has_cast(addr_t offset) {
+    ast_s node = { 0 };
+    while (offset != NULL) {
+        ast_read_node(ast_ptr, offset, &node);
+        switch (node.node_type) {
+            case NT_CAST: return TRUE;
+            case NT_TERM:
+            case NT_EXPRESSION:
+                if (node.children[1] != NULL) { return FALSE; }
+                offset = node.children[2];
+                break;
+            case NT_FACTOR: offset = node.children[1]; break;
+            default: return FALSE;
+        }
+    }
+    return FALSE;
+}
+
+static uint8_t fold_child_index(ast_s* node) {
+    ast_read_node(ast_ptr, node->parent_offset, &peeked_node);
+    for (uint8_t i = 0; i < node_constants[peeked_node.node_type].child_count; i++) {
+        if (peeked_node.children[i] == node->offset) { return i; }
+    }
+    assert(FALSE);
+    return 0;
+}
+
+// hang a single constant where the node was
+static void fold_constant(ast_s* node, int32_t value) {
+    uint8_t child_index = fold_child_index(node);
+    addr_t factor_offset = ast_new_node(ast_ptr, NT_FACTOR, node->parent_offset, child_index);
+    ast_new_node(ast_ptr, NT_CONSTANT, factor_offset, 1);
+
+    char buffer[MAX_TOKEN_LEN+1];
+    snprintf(buffer, sizeof(buffer), "%d", value);
+    ast_puts(buffer, ast_ptr);
+    ast_putc(NULL, ast_ptr);
+    TRACE(TRACE_STEPS, "<folded %s into %d>\n", node_constants[node->node_type].name, value);
+}
+
+// hang one of the node's operands where the node was
+static void fold_bypass(ast_s* node, addr_t operand_offset) {
+    uint8_t child_index = fold_child_index(node);
+    ast_ptr->position = AST_ADDR_CHILD(node->parent_offset, child_index);
+    ast_put_addr(operand_offset, ast_ptr);
+    ast_ptr->position = AST_ADDR_PARENT(operand_offset);
+    ast_put_addr(node->parent_offset, ast_ptr);
+    TRACE(TRACE_STEPS, "<dropped %s>\n", node_constants[node->node_type].name);
+}
+
+// x + 0, x - 0, x * 1, x / 1, 0 + x and 1 * x are all just x
+static addr_t fold_identity(void) {
+    ast_read_node(ast_ptr, cur_node.children[1], &peeked_node);
+    read_token();
+    char op = token[0];
+    addr_t right = cur_node.children[0];
+    addr_t left = cur_node.children[2];
+
+    int32_t value = 0;
+    if (fold_value(right, &value)) {
+        if ((op == '+' || op == '-') && value == 0) { return left; }
+        if ((op == '*' || op == '/') && value == 1) { return left; }
+    }
+    if (fold_value(left, &value)) {
+        if (op == '+' && value == 0) { return right; }
+        if (op == '*' && value == 1) { return right; }
+    }
+    return NULL;
+}
+
+static void fold_evaluate(void) {
+    // move to root node
+    ast_ptr->position = 0;
+    future_push(ast_get_addr(ast_ptr));
+
+    size_t bail = 0;
+    while(future_stack_count > 0 && ++bail < BAIL_LIMIT(ast_ptr->size)) {
+        addr_t offset = future_pop();
+        // navigate to offset and parse node
+        ast_read_node(ast_ptr, offset, &cur_node);
+
+        int32_t value = 0;
+        switch (cur_node.node_type) {
+            case NT_TERM:
+            case NT_EXPRESSION: {
+                if (cur_node.children[1] == NULL) { break; }
+                // the topmost constant term/expression takes everything under it along, an inexact one
+                // is left to the runtime whole since the constants under it are typed by it
+                if (is_folded(&cur_node)) {
+                    if (is_exact(&cur_node)) { fold_constant(&cur_node, scratch[cur_node.scratch].constant_value); }
+                    continue;
+                }
+                addr_t operand_offset = fold_identity();
+                if (operand_offset != NULL) {
+                    fold_bypass(&cur_node, operand_offset);
+                    future_push(operand_offset);
+                    continue;
+                }
+                break;
+            }
+            case NT_FACTOR:
+                // negated constants, casts are left alone since they pick the type
+                if (cur_node.children[0] == NULL || !fold_value(cur_node.offset, &value)) { break; }
+                if (value < -32768 || value > 32767) { break; }
+                if (fold_has_cast(cur_node.children[1])) { break; }
+                fold_constant(&cur_node, value);
+                continue;
+            default: break;
+        }
+
+        // search children
+        uint8_t child_count = node_constants[cur_node.node_type].child_count;
+        for (int i = 0; i < child_count; i++) {
+            future_push(cur_node.children[i]);
+        }
+    }
+    assert(bail < BAIL_LIMIT(ast_ptr->size));
+}
+
+// the variable an expression is and nothing more, NULL if there's math, a unary op or a cast to it
+static addr_t fold_plain_variable(addr_t offset) {
+    ast_s node = { 0 };
+    while (offset != NULL) {
+        ast_read_node(ast_ptr, offset, &node);
+        switch (node.node_type) {
+            case NT_TERM:
+            case NT_EXPRESSION:
+                if (node.children[1] != NULL) { return NULL; }
+                offset = node.children[2];
+                break;
+            case NT_FACTOR:
+                if (node.children[0] != NULL) { return NULL; }
+                offset = node.children[1];
+                break;
+            case NT_VARIABLE: return offset;
+            default: return NULL;
         }
+    }
+    return NULL;
+}
+
+// the same name and the same members, both sides are in one statement so they are the same variable
+static bool fold_same_target(addr_t target_offset, addr_t target_member, addr_t variable_offset, addr_t variable_member) {
+    char target[MAX_TOKEN_LEN+1];
+    ast_read_node(ast_ptr, target_offset, &peeked_node);
+    ast_peek_token(ast_ptr, target);
+    ast_read_node(ast_ptr, variable_offset, &peeked_node);
+    read_token();
+    if (strcmp(target, token)) { return FALSE; }
+    if (target_member == NULL || variable_member == NULL) { return target_member == variable_member; }
+    ast_read_node(ast_ptr, target_member, &peeked_node);
+    addr_t target_next = peeked_node.children[0];
+    ast_read_node(ast_ptr, variable_member, &peeked_node);
+    return fold_same_target(target_member, target_next, variable_member, peeked_node.children[0]);
+}
+
+static bool fold_is_self_assignment(addr_t offset) {
+    ast_s assignment = { 0 };
+    ast_read_node(ast_ptr, offset, &assignment);
+    if (assignment.node_type != NT_ASSIGNMENT) { return FALSE; }
+    addr_t variable_offset = fold_plain_variable(assignment.children[0]);
+    if (variable_offset == NULL) { return FALSE; }
+    ast_s variable = { 0 };
+    ast_read_node(ast_ptr, variable_offset, &variable);
+    return fold_same_target(assignment.offset, assignment.children[1], variable_offset, variable.children[0]);
+}
+
+// folding can leave x = x behind, which sets a variable to what it already holds
+static void fold_self_assignments(void) {
+    // move to root node
+    ast_ptr->position = 0;
+    future_push(ast_get_addr(ast_ptr));
+
+    size_t bail = 0;
+    while(future_stack_count > 0 && ++bail < BAIL_LIMIT(ast_ptr->size)) {
+        addr_t offset = future_pop();
+        // navigate to offset and parse node
+        ast_read_node(ast_ptr, offset, &cur_node);
 
+        if (cur_node.node_type == NT_STATEMENT && cur_node.children[1] != NULL && fold_is_self_assignment(cur_node.children[1])) {
+            ast_ptr->position = AST_ADDR_CHILD(cur_node.offset, 1);
+            ast_put_addr(NULL, ast_ptr);
+            TRACE(TRACE_STEPS, "<dropped self assignment>\n");
+            future_push(cur_node.children[0]);
+            continue;
+        }
+
+        // search children
+        uint8_t child_count = node_constants[cur_node.node_type].child_count;
+        for (int i = 0; i < child_count; i++) {
+            future_push(cur_node.children[i]);
+        }
     }
-    assert(bail < 1000);
+    assert(bail < BAIL_LIMIT(ast_ptr->size));
 }
 
   ////////////////////////
@@ -218,7 +525,7 @@ static void tc_propagate(type_t type) {
     ast_write_type(type, node.offset);
     uint8_t depth = 0;
     while (TRUE) {
-        printf("      %s\n", node_constants[node.node_type].name);
+        TRACE(TRACE_STEPS, "      %s\n", node_constants[node.node_type].name);
 
         // check for exit conditions
         if (type == node.value_type && depth > 0) { return; }
@@ -230,11 +537,9 @@ static void tc_propagate(type_t type) {
             case NT_ASSIGNMENT:
                 // check for a type error
                 if (type > node.value_type) {
-                    printf("\nType error: \n"
-                        "'%s' provided, when '%s' was expected.\n\n",
+                    type_error("'%s' provided, when '%s' was expected.\n",
                         types[type].name,
                         types[node.value_type].name);
-                    assert(FALSE);
                 }
                 return;
             default: break;
@@ -266,11 +571,11 @@ static void tc_propagate(type_t type) {
     }
 }
 
-static type_t tc_member_address_and_type(var_s* var, uint16_t assign_member_offset) {
+static type_t tc_member_address_and_type(var_s* var, addr_t assign_member_offset) {
     assert(cur_node.node_type == NT_ASSIGNMENT || cur_node.node_type == NT_VARIABLE);
 
     type_t type = var->type;
-    uint16_t search_type_from_offset = cur_node.offset;
+    addr_t search_type_from_offset = cur_node.offset;
 
     if (assign_member_offset != NULL) {
         uint16_t member_address = 0;
@@ -279,22 +584,22 @@ static type_t tc_member_address_and_type(var_s* var, uint16_t assign_member_offs
         ast_read_node(ast_ptr, var->offset, &peeked_node);
 next_member_resolve:
         ast_peek_token(ast_ptr, peeked_token);
-        printf("user type token: %s\n", peeked_token);
+        TRACE(TRACE_STEPS, "user type token: %s\n", peeked_token);
 
         // get user type offset
-        uint16_t user_type_offset = get_user_type(ast_ptr, peeked_token, search_type_from_offset);
+        addr_t user_type_offset = get_user_type(ast_ptr, peeked_token, search_type_from_offset);
         assert(user_type_offset != NULL);
 
         // find type member name
         ast_read_node(ast_ptr, assign_member_offset, &peeked_node);
         ast_peek_token(ast_ptr, peeked_token);
-        uint16_t next_member_offset = peeked_node.children[0];
-        printf("member type name: %s\n", peeked_token);
+        addr_t next_member_offset = peeked_node.children[0];
+        TRACE(TRACE_STEPS, "member type name: %s\n", peeked_token);
 
         // find member offset
-        uint16_t type_member_offset = ast_get_member(ast_ptr, user_type_offset, peeked_token);
+        addr_t type_member_offset = ast_get_member(ast_ptr, user_type_offset, peeked_token);
         assert(type_member_offset != NULL);
-        printf("type member offset: %04X\n", type_member_offset);
+        TRACE(TRACE_STEPS, "type member offset: %04X\n", type_member_offset);
 
         // read the type's member
         ast_read_node(ast_ptr, type_member_offset, &peeked_node);
@@ -303,7 +608,7 @@ next_member_resolve:
         // continue resolving if this is a user defined type
         if (type == TYPE_USER_DEFINED) {
             assert(next_member_offset != NULL);
-            uint16_t return_offset = ftell(ast_ptr);
+            addr_t return_offset = ast_ptr->position;
 
             // remember address offset
             member_address += ast_get_member_address(ast_ptr, type_member_offset);
@@ -315,7 +620,7 @@ next_member_resolve:
             assign_member_offset = next_member_offset;
             search_type_from_offset = type_member_offset;
 
-            fseek(ast_ptr, return_offset, 0);
+            ast_ptr->position = return_offset;
             goto next_member_resolve;
         }
         assert(type != TYPE_NONE);
@@ -355,7 +660,7 @@ static void tc_variable(void) {
         assert(var->user_type_offset != NULL);
 
         bool found = FALSE;
-        uint16_t next_offset = cur_node.parent_offset;
+        addr_t next_offset = cur_node.parent_offset;
         while (next_offset != NULL) {
             ast_read_node(ast_ptr, next_offset, &peeked_node);
             next_offset = peeked_node.parent_offset;
@@ -378,8 +683,8 @@ static void tc_variable(void) {
 }
 
 static void tc_constant(void) {
-    int32_t value = 0;
-    assert(fscanf(ast_ptr, "%d", &value) == 1);
+    read_token();
+    int32_t value = atoi(token);
 
     // apply unary op of factor
     ast_read_node(ast_ptr, cur_node.parent_offset, &peeked_node);
@@ -403,8 +708,8 @@ static void tc_constant(void) {
                 goto failed_search;
             default: break;
         }
-        printf("%d\n", peeked_node.scratch);
-        if (scratch[peeked_node.scratch].constant_count == 2 && peeked_node.value_type != NULL) {
+        TRACE(TRACE_STEPS, "%d\n", peeked_node.scratch);
+        if (is_folded(&peeked_node) && peeked_node.value_type != NULL) {
             tc_propagate(peeked_node.value_type);
             return;
         }
@@ -425,7 +730,7 @@ failed_search:
 static void tc_term_or_expression(void) {
     // some operators can cause an overflow
     // when one is used, we must use the bit width of a larger parent
-    bool is_constant_expression = (cur_node.scratch != 0) && (scratch[cur_node.scratch].constant_count == 2);
+    bool is_constant_expression = is_folded(&cur_node);
     bool overflowable_operator = FALSE;
     if (cur_node.children[1] != NULL) {
         ast_read_node(ast_ptr, cur_node.children[1], &peeked_node);
@@ -442,7 +747,7 @@ static void tc_term_or_expression(void) {
     }
 
     if (overflowable_operator && !is_constant_expression) {
-        uint16_t next_offset = cur_node.parent_offset;
+        addr_t next_offset = cur_node.parent_offset;
         while (next_offset != NULL) {
             ast_read_node(ast_ptr, next_offset, &peeked_node);
             next_offset = peeked_node.parent_offset;
@@ -472,12 +777,12 @@ static void tc_assignment(void) {
 static void tc_declaration(void) {
     read_token();
     type_t type = get_type(token);
-    uint16_t user_type_offset = 0;
+    addr_t user_type_offset = 0;
     if (type == TYPE_NONE) {
         type = TYPE_USER_DEFINED;
-        uint16_t return_to = ftell(ast_ptr);
+        addr_t return_to = ast_ptr->position;
         user_type_offset = get_user_type(ast_ptr, token, cur_node.offset);
-        fseek(ast_ptr, return_to, 0);
+        ast_ptr->position = return_to;
     }
 
     read_token();
@@ -493,20 +798,20 @@ static void tc_class(void) {
 
 static void tc_evaluate(void) {
     // move to root node
-    fseek(ast_ptr, 0, 0);
-    future_push(fget16(ast_ptr));
+    ast_ptr->position = 0;
+    future_push(ast_get_addr(ast_ptr));
 
-    int bail = 0;
-    while(future_stack_count > 0 && ++bail < 1000) {
-        uint16_t offset = future_pop();
+    size_t bail = 0;
+    while(future_stack_count > 0 && ++bail < BAIL_LIMIT(ast_ptr->size)) {
+        addr_t offset = future_pop();
         if (offset == FUTURE_SCOPE_DECREMENT) {
             scope_decrement();
             continue;
         }
         // navigate to offset and parse node
         ast_read_node(ast_ptr, offset, &cur_node);
-        printf("\n");
-        printf("%04X: %s\n", offset, node_constants[cur_node.node_type].name);
+        TRACE(TRACE_STEPS, "\n");
+        TRACE(TRACE_STEPS, "%04X: %s\n", offset, node_constants[cur_node.node_type].name);
         switch (cur_node.node_type) {
             case NT_CLASS: tc_class(); break;
             case NT_DECLARATION: tc_declaration(); break;
@@ -523,7 +828,7 @@ static void tc_evaluate(void) {
             future_push(cur_node.children[i]);
         }
     }
-    assert(bail < 1000);
+    assert(bail < BAIL_LIMIT(ast_ptr->size));
 }
 
   ///////////////////
@@ -532,12 +837,12 @@ static void tc_evaluate(void) {
 
 static void cast_evaluate(void) {
     // move to root node
-    fseek(ast_ptr, 0, 0);
-    future_push(fget16(ast_ptr));
+    ast_ptr->position = 0;
+    future_push(ast_get_addr(ast_ptr));
 
-    int bail = 0;
-    while(future_stack_count > 0 && ++bail < 1000) {
-        uint16_t offset = future_pop();
+    size_t bail = 0;
+    while(future_stack_count > 0 && ++bail < BAIL_LIMIT(ast_ptr->size)) {
+        addr_t offset = future_pop();
         // navigate to offset and parse node
         ast_read_node(ast_ptr, offset, &cur_node);
 
@@ -569,47 +874,62 @@ static void cast_evaluate(void) {
             if (peeked_node.value_type == cur_node.value_type) { continue; }
             assert(peeked_node.value_type < cur_node.value_type);
             insert_cast(cur_node.value_type, cur_node.offset, peeked_node.offset);
-            printf("INSERTED %s %s!\n", types[cur_node.value_type].name, types[peeked_node.value_type].name);
+            TRACE(TRACE_STEPS, "INSERTED %s %s!\n", types[cur_node.value_type].name, types[peeked_node.value_type].name);
         }
 
     }
-    assert(bail < 1000);
+    assert(bail < BAIL_LIMIT(ast_ptr->size));
 }
 
-void typecheck(FILE *ast_ptr_arg) {
+void typecheck(ast_arena_s *ast_ptr_arg) {
     ast_ptr = ast_ptr_arg;
+    variables_clear();
+    scratch_new();
 
     // evaluate constant expressions
-    printf("Constant expression phase...\n");
+    TRACE(TRACE_STAGES, "Constant expression phase...\n");
     ce_evaluate();
 
+    // replace them with constants and drop operations that do nothing
+    TRACE(TRACE_STAGES, "Folding phase...\n");
+    fold_evaluate();
+    fold_self_assignments();
+
     // evaluate and propagate types
-    printf("Typechecking phase...\n");
+    TRACE(TRACE_STAGES, "Typechecking phase...\n");
     tc_evaluate();
 
     // insert casts where required
-    printf("Casting phase...\n");
+    TRACE(TRACE_STAGES, "Casting phase...\n");
     cast_evaluate();
+
+    scratch_free();
 }
 
   //////////
  // main //
 //////////
 
+#ifndef SHABBY_LIBRARY
 int main(int argc, char *argv[]) {
     assert(argc == 2);
+    trace_level = TRACE_STEPS;
 
     char ast_buffer[256] = { 0 };
     sprintf(ast_buffer, "../bin/compilation/%s.ast", "out");
-    ast_ptr = fopen(ast_buffer, "r+b");
+    FILE* ast_file_ptr = fopen(ast_buffer, "r+b");
 
-    typecheck(ast_ptr);
+    ast_arena_s ast = { 0 };
+    ast_arena_load(&ast, ast_file_ptr);
+    typecheck(&ast);
+    rewind(ast_file_ptr);
+    ast_arena_save(&ast, ast_file_ptr);
+    ast_arena_free(&ast);
 
-    fclose(ast_ptr);
+    fclose(ast_file_ptr);
     return 0;
 
     // make pedantic compilers happy
-    node_constants[0] = node_constants[0];
-    types[0] = types[0];
     argv[0] = argv[0];
 }
+#endif
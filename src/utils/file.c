@@ -1,5 +1,10 @@
+#define _GNU_SOURCE
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
 #include "symbols.h"
+#include "file.h"
 
 void fput16(uint16_t value, FILE* fp) {
     fputc((value >> 8) % 256, fp);
@@ -9,3 +14,99 @@ void fput16(uint16_t value, FILE* fp) {
 uint16_t fget16(FILE* fp) {
     return (fgetc(fp) << 8) | fgetc(fp);
 }
+
+void fput32(uint32_t value, FILE* fp) {
+    fput16(value >> 16, fp);
+    fput16(value % 65536, fp);
+}
+
+uint32_t fget32(FILE* fp) {
+    uint32_t high = fget16(fp);
+    return (high << 16) | fget16(fp);
+}
+
+  /////////////////////
+ // in-memory files //
+/////////////////////
+
+typedef struct {
+    buffer_s* buffer;
+    size_t position;
+} buffer_cookie_s;
+
+static ssize_t buffer_read(void* cookie, char* data, size_t size) {
+    buffer_cookie_s* c = cookie;
+    if (c->position >= c->buffer->size) { return 0; }
+    if (size > c->buffer->size - c->position) { size = c->buffer->size - c->position; }
+    memcpy(data, &c->buffer->data[c->position], size);
+    c->position += size;
+    return size;
+}
+
+static ssize_t buffer_write(void* cookie, const char* data, size_t size) {
+    buffer_cookie_s* c = cookie;
+
+    // grow to fit
+    size_t end = c->position + size;
+    if (end > c->buffer->capacity) {
+        size_t capacity = (c->buffer->capacity > 0) ? c->buffer->capacity : 256;
+        while (capacity < end) { capacity *= 2; }
+        c->buffer->data = realloc(c->buffer->data, capacity);
+        assert(c->buffer->data != NULL);
+        c->buffer->capacity = capacity;
+    }
+
+    // zero any gap left by seeking past the end
+    if (c->position > c->buffer->size) {
+        memset(&c->buffer->data[c->buffer->size], 0, c->position - c->buffer->size);
+    }
+
+    memcpy(&c->buffer->data[c->position], data, size);
+    c->position = end;
+    if (end > c->buffer->size) { c->buffer->size = end; }
+    return size;
+}
+
+static int buffer_seek(void* cookie, off64_t* offset, int whence) {
+    buffer_cookie_s* c = cookie;
+    off64_t base = 0;
+    switch (whence) {
+        case SEEK_SET: base = 0; break;
+        case SEEK_CUR: base = c->position; break;
+        case SEEK_END: base = c->buffer->size; break;
+        default: return -1;
+    }
+    if (base + *offset < 0) { return -1; }
+    c->position = base + *offset;
+    *offset = c->position;
+    return 0;
+}
+
+static int buffer_close(void* cookie) {
+    free(cookie);
+    return 0;
+}
+
+FILE* buffer_open(buffer_s* buffer) {
+    buffer_cookie_s* cookie = malloc(sizeof(buffer_cookie_s));
+    assert(cookie != NULL);
+    cookie->buffer = buffer;
+    cookie->position = 0;
+
+    cookie_io_functions_t functions = {
+        .read = buffer_read,
+        .write = buffer_write,
+        .seek = buffer_seek,
+        .close = buffer_close,
+    };
+    FILE* fp = fopencookie(cookie, "r+", functions);
+    assert(fp != NULL);
+    return fp;
+}
+
+void buffer_free(buffer_s* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "bytecode.h"
+#include "image.h"
+#include "rom.h"
+#include "verify.h"
+
+  /////////////
+ // helpers //
+/////////////
+
+static void write16(uint8_t* at, uint16_t value) {
+    at[0] = value >> 8;
+    at[1] = value & 0xFF;
+}
+
+static void write32(uint8_t* at, uint32_t value) {
+    write16(at, value >> 16);
+    write16(&at[2], value & 0xFFFF);
+}
+
+// loaded images are read through the rom accessors, written ones are plain memory
+static uint32_t checksum(const uint8_t* data, size_t length) {
+    // fnv-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= rom_read8(&data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool magic_matches(const uint8_t* bytes) {
+    for (uint8_t i = 0; i < 4; i++) {
+        if (rom_read8(&bytes[i]) != (uint8_t)IMAGE_MAGIC[i]) { return FALSE; }
+    }
+    return TRUE;
+}
+
+static bool invalid(const char* reason) {
+    fprintf(stderr, "Invalid image, %s!\n", reason);
+    return FALSE;
+}
+
+  /////////////
+ // writing //
+/////////////
+
+// lays the whole image out in memory so the checksum can go in the header
+void image_write(FILE* out_ptr, const uint8_t* code, size_t code_size, const image_entry_s* entries, uint32_t entry_count, const image_layout_s* layouts, uint32_t layout_count, uint16_t stack_size) {
+    uint32_t sizes[SECTION_COUNT] = {
+        [SECTION_CODE] = code_size + 1,
+        [SECTION_RODATA] = 4 + layout_count * IMAGE_LAYOUT_SIZE,
+        [SECTION_ENTRIES] = entry_count * IMAGE_ENTRY_SIZE,
+    };
+    size_t size = IMAGE_HEADER_SIZE + SECTION_COUNT * IMAGE_SECTION_SIZE;
+    for (int i = 0; i < SECTION_COUNT; i++) { size += sizes[i]; }
+
+    uint8_t* image = calloc(size, 1);
+    assert(image != NULL);
+
+    // header
+    memcpy(image, IMAGE_MAGIC, 4);
+    write16(&image[4], IMAGE_VERSION);
+    image[6] = ADDR_SIZE;
+    image[7] = SECTION_COUNT;
+    write16(&image[8], stack_size);
+
+    // section table
+    uint32_t offset = IMAGE_HEADER_SIZE + SECTION_COUNT * IMAGE_SECTION_SIZE;
+    uint32_t offsets[SECTION_COUNT];
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        uint8_t* section = &image[IMAGE_HEADER_SIZE + i * IMAGE_SECTION_SIZE];
+        write32(section, i);
+        write32(&section[4], offset);
+        write32(&section[8], sizes[i]);
+        offsets[i] = offset;
+        offset += sizes[i];
+    }
+
+    // sections
+    memcpy(&image[offsets[SECTION_CODE]], code, code_size);
+    image[offsets[SECTION_CODE] + code_size] = (uint8_t)BC_EOF;
+    write32(&image[offsets[SECTION_RODATA]], layout_count);
+    for (uint32_t i = 0; i < layout_count; i++) {
+        uint8_t* layout = &image[offsets[SECTION_RODATA] + 4 + i * IMAGE_LAYOUT_SIZE];
+        write32(layout, layouts[i].id);
+        write32(&layout[4], layouts[i].bytes);
+    }
+    for (uint32_t i = 0; i < entry_count; i++) {
+        uint8_t* entry = &image[offsets[SECTION_ENTRIES] + i * IMAGE_ENTRY_SIZE];
+        write32(entry, entries[i].type);
+        write32(&entry[4], entries[i].id);
+        write32(&entry[8], entries[i].offset);
+    }
+
+    write32(&image[12], checksum(&image[IMAGE_HEADER_SIZE], size - IMAGE_HEADER_SIZE));
+    fwrite(image, 1, size, out_ptr);
+    free(image);
+}
+
+  /////////////
+ // loading //
+/////////////
+
+// every check happens here once, the vm trusts a loaded image from then on
+bool image_load(image_s* image, const uint8_t* bytes, size_t size) {
+    memset(image, 0, sizeof(image_s));
+    image->bytes = bytes;
+    image->size = size;
+
+    // header
+    if (size < IMAGE_HEADER_SIZE || !magic_matches(bytes)) { return invalid("not a shabby image"); }
+    if (rom_read16(&bytes[4]) != IMAGE_VERSION) { return invalid("unsupported version"); }
+    if (rom_read8(&bytes[6]) != ADDR_SIZE) { return invalid("compiled for another address size"); }
+    if (rom_read16(&bytes[10]) != 0) { return invalid("reserved bits set"); }
+    uint8_t section_count = rom_read8(&bytes[7]);
+    if (size < IMAGE_HEADER_SIZE + (size_t)section_count * IMAGE_SECTION_SIZE) { return invalid("truncated section table"); }
+    if (rom_read32(&bytes[12]) != checksum(&bytes[IMAGE_HEADER_SIZE], size - IMAGE_HEADER_SIZE)) { return invalid("checksum mismatch"); }
+    image->stack_size = rom_read16(&bytes[8]);
+
+    // sections
+    bool found[SECTION_COUNT] = { 0 };
+    for (uint8_t i = 0; i < section_count; i++) {
+        const uint8_t* section = &bytes[IMAGE_HEADER_SIZE + i * IMAGE_SECTION_SIZE];
+        uint32_t type = rom_read32(section);
+        uint32_t offset = rom_read32(&section[4]);
+        uint32_t section_size = rom_read32(&section[8]);
+        if (offset > size || section_size > size - offset) { return invalid("section out of bounds"); }
+
+        // unknown sections are skipped so newer compilers can add them
+        if (type >= SECTION_COUNT) { continue; }
+        if (found[type]) { return invalid("duplicate section"); }
+        found[type] = TRUE;
+
+        switch (type) {
+            case SECTION_CODE:
+                if (section_size == 0 || rom_read8(&bytes[offset + section_size - 1]) != (uint8_t)BC_EOF) { return invalid("code is not terminated"); }
+                if (section_size - 1 >= ADDR_MAX) { return invalid("code too large"); }
+                image->code = &bytes[offset];
+                image->code_size = (addr_t)(section_size - 1);
+                break;
+            case SECTION_RODATA:
+                image->rodata = &bytes[offset];
+                image->rodata_size = section_size;
+                // images from before there were layouts have an empty rodata
+                if (section_size == 0) { break; }
+                if (section_size < 4) { return invalid("truncated rodata"); }
+                image->layouts = &bytes[offset + 4];
+                image->layout_count = rom_read32(&bytes[offset]);
+                if (image->layout_count > (section_size - 4) / IMAGE_LAYOUT_SIZE) { return invalid("layouts out of bounds"); }
+                break;
+            case SECTION_ENTRIES:
+                if (section_size % IMAGE_ENTRY_SIZE != 0) { return invalid("partial entry"); }
+                image->entries = &bytes[offset];
+                image->entry_count = section_size / IMAGE_ENTRY_SIZE;
+                break;
+        }
+    }
+    if (image->code == NULL) { return invalid("no code"); }
+
+    // entries
+    for (uint32_t i = 0; i < image->entry_count; i++) {
+        image_entry_s entry = image_entry(image, i);
+        if (entry.type > ENTRY_CLASS || entry.offset >= image->code_size) { return invalid("bad entry"); }
+    }
+
+    // code that doesn't verify still loads, it just runs checked
+    image->verified = verify(image->code, image->code_size, &image->stack_needed);
+    return TRUE;
+}
+
+// maps the file read only, pages are shared between every process running the same image
+bool image_map(image_s* image, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Could not open '%s'!\n", path);
+        return FALSE;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < IMAGE_HEADER_SIZE) {
+        close(fd);
+        return invalid("not a shabby image");
+    }
+    void* bytes = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (bytes == MAP_FAILED) {
+        fprintf(stderr, "Could not map '%s'!\n", path);
+        return FALSE;
+    }
+
+    if (!image_load(image, bytes, info.st_size)) {
+        munmap(bytes, info.st_size);
+        return FALSE;
+    }
+    image->mapped = TRUE;
+    return TRUE;
+}
+
+void image_unmap(image_s* image) {
+    if (image->mapped) { munmap((void*)image->bytes, image->size); }
+    memset(image, 0, sizeof(image_s));
+}
+
+image_entry_s image_entry(const image_s* image, uint32_t index) {
+    assert(index < image->entry_count);
+    const uint8_t* entry = &image->entries[index * IMAGE_ENTRY_SIZE];
+    return (image_entry_s){
+        .type = rom_read32(entry),
+        .id = rom_read32(&entry[4]),
+        .offset = rom_read32(&entry[8]),
+    };
+}
+
+image_layout_s image_layout(const image_s* image, uint32_t index) {
+    assert(index < image->layout_count);
+    const uint8_t* layout = &image->layouts[index * IMAGE_LAYOUT_SIZE];
+    return (image_layout_s){
+        .id = rom_read32(layout),
+        .bytes = rom_read32(&layout[4]),
+    };
+}
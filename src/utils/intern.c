@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "constants.h"
+#include "intern.h"
+
+  /////////////
+ // storage //
+/////////////
+
+// strings live back to back in one pool, ids index their start
+static thread_local char* pool = NULL;
+static thread_local uint32_t pool_size = 0;
+static thread_local uint32_t pool_capacity = 0;
+
+static thread_local uint32_t* starts = NULL;
+static thread_local uint32_t count = 0;
+static thread_local uint32_t starts_capacity = 0;
+
+// open addressed table of ids, kept at most half full
+static thread_local uint32_t* table = NULL;
+static thread_local uint32_t table_capacity = 0;
+
+static uint32_t hash(const char* s, uint32_t length) {
+    // fnv-1a
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < length; i++) {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static bool same(uint32_t id, const char* s, uint32_t length) {
+    const char* other = interned(id);
+    return !strncmp(other, s, length) && other[length] == '\0';
+}
+
+static uint32_t* slot(const char* s, uint32_t length) {
+    uint32_t i = hash(s, length) & (table_capacity - 1);
+    while (table[i] != INTERN_NONE && !same(table[i], s, length)) {
+        i = (i + 1) & (table_capacity - 1);
+    }
+    return &table[i];
+}
+
+static void grow_table(void) {
+    table_capacity = (table_capacity == 0) ? 64 : table_capacity * 2;
+    free(table);
+    table = malloc(table_capacity * sizeof(uint32_t));
+    assert(table != NULL);
+    memset(table, 0xFF, table_capacity * sizeof(uint32_t));
+    for (uint32_t id = 0; id < count; id++) {
+        *slot(interned(id), strlen(interned(id))) = id;
+    }
+}
+
+  ////////////
+ // lookup //
+////////////
+
+uint32_t intern_find_span(const char* s, uint32_t length) {
+    if (table_capacity == 0) { return INTERN_NONE; }
+    return *slot(s, length);
+}
+
+uint32_t intern_find(const char* s) {
+    return intern_find_span(s, strlen(s));
+}
+
+uint32_t intern_span(const char* s, uint32_t length) {
+    uint32_t id = intern_find_span(s, length);
+    if (id != INTERN_NONE) { return id; }
+
+    if ((count + 1) * 2 > table_capacity) { grow_table(); }
+
+    // copy the string into the pool
+    while (pool_size + length + 1 > pool_capacity) {
+        pool_capacity = (pool_capacity == 0) ? 1024 : pool_capacity * 2;
+        pool = realloc(pool, pool_capacity);
+        assert(pool != NULL);
+    }
+    memcpy(&pool[pool_size], s, length);
+    pool[pool_size + length] = '\0';
+
+    // remember where it starts
+    if (count >= starts_capacity) {
+        starts_capacity = (starts_capacity == 0) ? 64 : starts_capacity * 2;
+        starts = realloc(starts, starts_capacity * sizeof(uint32_t));
+        assert(starts != NULL);
+    }
+    starts[count] = pool_size;
+    pool_size += length + 1;
+
+    *slot(s, length) = count;
+    return count++;
+}
+
+uint32_t intern(const char* s) {
+    return intern_span(s, strlen(s));
+}
+
+const char* interned(uint32_t id) {
+    assert(id < count);
+    return &pool[starts[id]];
+}
+
+uint32_t intern_count(void) {
+    return count;
+}
+
+void intern_clear(void) {
+    free(pool);
+    free(starts);
+    free(table);
+    pool = NULL;
+    starts = NULL;
+    table = NULL;
+    pool_size = pool_capacity = 0;
+    count = starts_capacity = 0;
+    table_capacity = 0;
+}
@@ -1,51 +1,166 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include "nodes.h"
-#include "file.h"
 
-void ast_read_node(FILE* ast_ptr, uint16_t offset, ast_s* result) {
-    fseek(ast_ptr, offset, 0);
+  ///////////////////
+ // node metadata //
+///////////////////
+
+const node_s node_constants[] = {
+    // Parser Only
+    [NT_NONE] = { 0, 0, 0, DBG_STR("none") },
+    [NT_ROOT] = { 0, 0, 0, DBG_STR("root") },
+    [NT_CONSUME] = { 0, 0, 0, DBG_STR("consume") },
+    [NT_STATEMENT_LIST] = { 0, 0, 0, DBG_STR("statement_list") },
+
+    // Shared
+    [NT_CLASS] = { 1, 2, 1, DBG_STR("class") },
+    [NT_STATEMENT] = { 2, 0, 0, DBG_STR("statement") },
+    [NT_DECLARATION] = { 1, 1, 2, DBG_STR("declaration") },
+    [NT_ASSIGNMENT] = { 2, 1, 1, DBG_STR("assignment") },
+    [NT_EXPRESSION] = { 3, 0, 0, DBG_STR("expression") },
+    [NT_EXPRESSION_OP] = { 0, 0, 1, DBG_STR("expression_op") },
+    [NT_TERM] = { 3, 0, 0, DBG_STR("term") },
+    [NT_TERM_OP] = { 0, 0, 1, DBG_STR("term_op") },
+    [NT_FACTOR] = { 2, 0, 0, DBG_STR("factor") },
+    [NT_UNARY_OP] = { 0, 0, 1, DBG_STR("unary_op") },
+    [NT_VARIABLE] = { 1, 1, 1, DBG_STR("variable") },
+    [NT_MEMBER] = { 1, 0, 1, DBG_STR("member") },
+    [NT_CONSTANT] = { 0, 0, 1, DBG_STR("constant") },
+    [NT_CAST] = { 1, 0, 1, DBG_STR("cast") },
+
+    // Testing
+    [NT_TEST] = { 0, 0, 1, DBG_STR("$TEST") },
+
+    // debug
+    #ifdef DEBUG
+    [NT_DEBUG_UNINDENT_NODE] = { 0, 0, 0, DBG_STR("debug_unindent_node") },
+    #endif
+};
+
+  ///////////
+ // arena //
+///////////
+
+// programs past what an address holds are rejected outright, only a wide build can compile them
+static void ast_reserve(ast_arena_s* ast_ptr, size_t size) {
+    if (size > ADDR_MAX) {
+        fprintf(stderr, "Program too large for %d bit addresses!\n", ADDR_SIZE * 8);
+        exit(1);
+    }
+    if (size <= ast_ptr->capacity) { return; }
+    size_t capacity = (ast_ptr->capacity > 0) ? ast_ptr->capacity : 256;
+    while (capacity < size) { capacity *= 2; }
+    ast_ptr->data = realloc(ast_ptr->data, capacity);
+    assert(ast_ptr->data != NULL);
+    ast_ptr->capacity = capacity;
+}
+
+void ast_arena_load(ast_arena_s* ast_ptr, FILE* fp) {
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    assert(size >= 0);
+    fseek(fp, 0, 0);
+
+    ast_reserve(ast_ptr, size);
+    size_t read = fread(ast_ptr->data, 1, size, fp);
+    assert(read == (size_t)size);
+    (void)read;
+    ast_ptr->size = size;
+    ast_ptr->position = 0;
+}
+
+void ast_arena_save(ast_arena_s* ast_ptr, FILE* fp) {
+    fwrite(ast_ptr->data, 1, ast_ptr->size, fp);
+}
+
+void ast_arena_free(ast_arena_s* ast_ptr) {
+    free(ast_ptr->data);
+    memset(ast_ptr, NULL, sizeof(ast_arena_s));
+}
+
+int ast_getc(ast_arena_s* ast_ptr) {
+    if (ast_ptr->position >= ast_ptr->size) { return EOF; }
+    return ast_ptr->data[ast_ptr->position++];
+}
+
+void ast_putc(uint8_t c, ast_arena_s* ast_ptr) {
+    ast_reserve(ast_ptr, ast_ptr->position + 1);
+    // zero any gap left by seeking past the end
+    if (ast_ptr->position > ast_ptr->size) {
+        memset(&ast_ptr->data[ast_ptr->size], NULL, ast_ptr->position - ast_ptr->size);
+    }
+    ast_ptr->data[ast_ptr->position++] = c;
+    if (ast_ptr->position > ast_ptr->size) { ast_ptr->size = ast_ptr->position; }
+}
+
+void ast_puts(const char* s, ast_arena_s* ast_ptr) {
+    while (*s != NULL) { ast_putc(*s++, ast_ptr); }
+}
+
+// offsets are stored big endian, ADDR_SIZE bytes wide
+addr_t ast_get_addr(ast_arena_s* ast_ptr) {
+    addr_t value = 0;
+    for (uint8_t i = 0; i < ADDR_SIZE; i++) {
+        value = (value << 8) | (uint8_t)ast_getc(ast_ptr);
+    }
+    return value;
+}
+
+void ast_put_addr(addr_t value, ast_arena_s* ast_ptr) {
+    for (uint8_t i = ADDR_SIZE; i-- > 0;) {
+        ast_putc((value >> (i * 8)) % 256, ast_ptr);
+    }
+}
+
+  ///////////
+ // nodes //
+///////////
+
+void ast_read_node(ast_arena_s* ast_ptr, addr_t offset, ast_s* result) {
+    ast_ptr->position = offset;
     result->offset = offset;
-    result->node_type = fgetc(ast_ptr);
-    result->value_type = fgetc(ast_ptr);
-    result->scratch = fget16(ast_ptr);
-    result->parent_offset = fget16(ast_ptr);
+    result->node_type = ast_getc(ast_ptr);
+    result->value_type = ast_getc(ast_ptr);
+    result->scratch = ast_get_addr(ast_ptr);
+    result->parent_offset = ast_get_addr(ast_ptr);
 
-    memset(result->children, NULL, MAX_AST_CHILDREN * sizeof(uint16_t));
+    memset(result->children, NULL, MAX_AST_CHILDREN * sizeof(addr_t));
     uint8_t child_count = node_constants[result->node_type].child_count;
     for (int i = 0; i < child_count; i++) {
-        result->children[i] = fget16(ast_ptr);
+        result->children[i] = ast_get_addr(ast_ptr);
     }
     uint8_t param_count = node_constants[result->node_type].param_count;
     if (param_count > 0) {
-        fseek(ast_ptr, param_count * sizeof(uint16_t), SEEK_CUR);
+        ast_ptr->position += param_count * ADDR_SIZE;
     }
 }
 
-static void ast_rewrite_node(FILE* ast_ptr, ast_s* node) {
+static void ast_rewrite_node(ast_arena_s* ast_ptr, ast_s* node) {
     // output: <node_type> <value_type><scratch> <*parent> <children*...>
-    fseek(ast_ptr, node->offset, 0);
+    ast_ptr->position = node->offset;
 
     // write node_type
-    fputc(node->node_type, ast_ptr);
+    ast_putc(node->node_type, ast_ptr);
     // write value_type
-    fputc(node->value_type, ast_ptr);
+    ast_putc(node->value_type, ast_ptr);
     // write scratch
-    fput16(node->scratch, ast_ptr);
+    ast_put_addr(node->scratch, ast_ptr);
     // write parent*
-    fput16(node->parent_offset, ast_ptr);
+    ast_put_addr(node->parent_offset, ast_ptr);
     // write <children*...>
     uint8_t child_count = node_constants[node->node_type].child_count;
     for (int i = 0; i < child_count; i++) {
-        fput16(node->children[i], ast_ptr);
+        ast_put_addr(node->children[i], ast_ptr);
     }
 }
 
-uint16_t ast_new_node(FILE* ast_ptr, node_t node_type, uint16_t parent_offset, uint8_t child_index) {
+addr_t ast_new_node(ast_arena_s* ast_ptr, node_t node_type, addr_t parent_offset, uint8_t child_index) {
     // insert new node on the end
-    fseek(ast_ptr, 0, SEEK_END);
-    uint16_t my_offset = ftell(ast_ptr);
+    ast_ptr->position = ast_ptr->size;
+    addr_t my_offset = ast_ptr->position;
 
     // set up new node
     ast_s node = { 0 };
@@ -55,36 +170,36 @@ uint16_t ast_new_node(FILE* ast_ptr, node_t node_type, uint16_t parent_offset, u
 
     // write new node
     ast_rewrite_node(ast_ptr, &node);
-    for (int i = 0; i < node_constants[node_type].param_count; i++) { fput16(0, ast_ptr); }
+    for (int i = 0; i < node_constants[node_type].param_count; i++) { ast_put_addr(0, ast_ptr); }
 
     // write to parent
-    fseek(ast_ptr, AST_ADDR_CHILD(parent_offset, child_index), 0);
-    fput16(node.offset, ast_ptr);
-    fseek(ast_ptr, 0, SEEK_END);
+    ast_ptr->position = AST_ADDR_CHILD(parent_offset, child_index);
+    ast_put_addr(node.offset, ast_ptr);
+    ast_ptr->position = ast_ptr->size;
 
     return my_offset;
 }
 
-uint16_t ast_insert_new_node(FILE* ast_ptr, ast_s* node) {
+addr_t ast_insert_new_node(ast_arena_s* ast_ptr, ast_s* node) {
 
     // get parent type
-    fseek(ast_ptr, AST_ADDR_NODE_TYPE(node->parent_offset), 0);
-    node_t parent_type = fgetc(ast_ptr);
+    ast_ptr->position = AST_ADDR_NODE_TYPE(node->parent_offset);
+    node_t parent_type = ast_getc(ast_ptr);
 
     // read parent's children
     uint8_t parent_child_count = node_constants[parent_type].child_count;
     assert(parent_child_count > 0);
-    uint16_t parents_children[MAX_AST_CHILDREN] = { 0 };
-    fseek(ast_ptr, AST_ADDR_CHILD(node->parent_offset, 0), 0);
+    addr_t parents_children[MAX_AST_CHILDREN] = { 0 };
+    ast_ptr->position = AST_ADDR_CHILD(node->parent_offset, 0);
     for (int i = 0; i < parent_child_count; i++) {
-        parents_children[i] = fget16(ast_ptr);
+        parents_children[i] = ast_get_addr(ast_ptr);
     }
 
     // compare parent's children to mine to find where to insert
     uint8_t parents_child_index = (uint8_t) -1;
     uint8_t child_count = node_constants[node->node_type].child_count;
     for (int i = 0; i < child_count; i++) {
-        uint16_t child = node->children[i];
+        addr_t child = node->children[i];
         if (child == NULL) { continue; }
 
         for (int j = 0; j < parent_child_count; j++) {
@@ -98,82 +213,84 @@ uint16_t ast_insert_new_node(FILE* ast_ptr, ast_s* node) {
 found:
 
     // insert new node on the end
-    fseek(ast_ptr, 0, SEEK_END);
-    uint16_t my_offset = ftell(ast_ptr);
+    ast_ptr->position = ast_ptr->size;
+    addr_t my_offset = ast_ptr->position;
 
     // write new node
     node->offset = my_offset;
     ast_rewrite_node(ast_ptr, node);
-    for (int i = 0; i < node_constants[node->node_type].param_count; i++) { fput16(0, ast_ptr); }
+    for (int i = 0; i < node_constants[node->node_type].param_count; i++) { ast_put_addr(0, ast_ptr); }
 
     // write to parent
-    fseek(ast_ptr, AST_ADDR_CHILD(node->parent_offset, parents_child_index), 0);
-    fput16(node->offset, ast_ptr);
+    ast_ptr->position = AST_ADDR_CHILD(node->parent_offset, parents_child_index);
+    ast_put_addr(node->offset, ast_ptr);
 
     // write to children
     for (int i = 0; i < child_count; i++) {
         if (node->children[i] == NULL) { continue; }
-        fseek(ast_ptr, AST_ADDR_PARENT(node->children[i]), 0);
-        fput16(my_offset, ast_ptr);
+        ast_ptr->position = AST_ADDR_PARENT(node->children[i]);
+        ast_put_addr(my_offset, ast_ptr);
     }
 
-    fseek(ast_ptr, 0, SEEK_END);
+    ast_ptr->position = ast_ptr->size;
     return my_offset;
 }
 
-void ast_overwrite_scratch(FILE* ast_ptr, uint16_t offset, uint16_t value) {
+void ast_overwrite_scratch(ast_arena_s* ast_ptr, addr_t offset, addr_t value) {
     // save the fp
-    uint16_t return_offset = ftell(ast_ptr);
+    addr_t return_offset = ast_ptr->position;
 
     // write scratch
-    fseek(ast_ptr, AST_ADDR_SCRATCH(offset), 0);
-    fput16(value, ast_ptr);
+    ast_ptr->position = AST_ADDR_SCRATCH(offset);
+    ast_put_addr(value, ast_ptr);
 
     // reset the fp
-    fseek(ast_ptr, return_offset, 0);
+    ast_ptr->position = return_offset;
 }
 
-uint16_t ast_get_param(FILE* ast_ptr, node_t node_type, uint16_t offset, uint8_t param_index) {
+addr_t ast_get_param(ast_arena_s* ast_ptr, node_t node_type, addr_t offset, uint8_t param_index) {
     // save the fp
-    uint16_t return_offset = ftell(ast_ptr);
+    addr_t return_offset = ast_ptr->position;
 
     // read byte_size
-    fseek(ast_ptr, AST_ADDR_PARAM(node_type, offset, param_index), 0);
-    uint16_t value = fget16(ast_ptr);
+    ast_ptr->position = AST_ADDR_PARAM(node_type, offset, param_index);
+    addr_t value = ast_get_addr(ast_ptr);
 
     // reset the fp
-    fseek(ast_ptr, return_offset, 0);
+    ast_ptr->position = return_offset;
 
     return value;
 }
 
-void ast_set_param(FILE* ast_ptr, node_t node_type, uint16_t offset, uint8_t param_index, uint16_t value) {
+void ast_set_param(ast_arena_s* ast_ptr, node_t node_type, addr_t offset, uint8_t param_index, addr_t value) {
     // save the fp
-    uint16_t return_offset = ftell(ast_ptr);
+    addr_t return_offset = ast_ptr->position;
 
     // read byte_size
-    fseek(ast_ptr, AST_ADDR_PARAM(node_type, offset, param_index), 0);
-    fput16(value, ast_ptr);
+    ast_ptr->position = AST_ADDR_PARAM(node_type, offset, param_index);
+    ast_put_addr(value, ast_ptr);
 
     // reset the fp
-    fseek(ast_ptr, return_offset, 0);
+    ast_ptr->position = return_offset;
 }
 
-void ast_peek_token(FILE* ast_ptr, char* buffer) {
-    int last_position = ftell(ast_ptr);
-    memset(buffer, NULL, MAX_TOKEN_LEN);
-    fgets(buffer, MAX_TOKEN_LEN, ast_ptr);
-    assert(strlen(buffer) < MAX_TOKEN_LEN);
-    fseek(ast_ptr, last_position + strlen(buffer) + 1, 0);
+void ast_peek_token(ast_arena_s* ast_ptr, char* buffer) {
+    memset(buffer, NULL, MAX_TOKEN_LEN + 1);
+    for (uint8_t i = 0; i <= MAX_TOKEN_LEN; i++) {
+        int c = ast_getc(ast_ptr);
+        if (c == NULL || c == EOF) { return; }
+        assert(i < MAX_TOKEN_LEN);
+        buffer[i] = c;
+    }
 }
 
-uint16_t ast_get_member(FILE* ast_ptr, uint16_t user_type_offset, char* member_token) {
+addr_t ast_get_member(ast_arena_s* ast_ptr, addr_t user_type_offset, char* member_token) {
     ast_s peeked_node = { 0 };
     // read user type
     ast_read_node(ast_ptr, user_type_offset, &peeked_node);
     assert(peeked_node.node_type == NT_CLASS);
 
-    uint16_t next_offset = peeked_node.children[0];
+    addr_t next_offset = peeked_node.children[0];
     while (next_offset != NULL) {
         // read statement, prepare next statement
         ast_read_node(ast_ptr, next_offset, &peeked_node);
@@ -198,7 +315,7 @@ uint16_t ast_get_member(FILE* ast_ptr, uint16_t user_type_offset, char* member_t
     assert(FALSE);
 }
 
-uint16_t ast_get_member_address(FILE* ast_ptr, uint16_t type_member_offset) {
+addr_t ast_get_member_address(ast_arena_s* ast_ptr, addr_t type_member_offset) {
     ast_s peeked_node = { 0 };
     // read user type
     ast_read_node(ast_ptr, type_member_offset, &peeked_node);
@@ -208,8 +325,8 @@ uint16_t ast_get_member_address(FILE* ast_ptr, uint16_t type_member_offset) {
     ast_read_node(ast_ptr, peeked_node.parent_offset, &peeked_node);
     assert(peeked_node.node_type == NT_STATEMENT);
 
-    uint16_t address = 0;
-    uint16_t next_offset = peeked_node.parent_offset;
+    addr_t address = 0;
+    addr_t next_offset = peeked_node.parent_offset;
     while (next_offset != NULL) {
         // read statement, prepare next statement
         ast_read_node(ast_ptr, next_offset, &peeked_node);
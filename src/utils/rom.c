@@ -0,0 +1,13 @@
+#include "rom.h"
+
+// what a port supplies for code in rom, on a host everything is ram so these stand in for flash reads,
+// volatile keeps every one of them a real load so the rom build runs the way it would on a device
+#ifdef SHABBY_CODE_IN_ROM
+uint8_t rom_read8(const uint8_t* at) {
+    return *(const volatile uint8_t*)at;
+}
+
+uint16_t rom_read16(const uint8_t* at) {
+    return (rom_read8(at) << 8) | rom_read8(&at[1]);
+}
+#endif
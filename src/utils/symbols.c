@@ -1,29 +1,64 @@
 #include <stdio.h>
 #include "constants.h"
+#include "symbols.h"
+
+  ///////////////////////
+ // character classes //
+///////////////////////
+
+#define W CHAR_WHITESPACE
+#define A CHAR_ALPHA
+#define D CHAR_NUMERIC
+#define U CHAR_UNDERSCORE
+#define M CHAR_MATH_OP
+
+const uint8_t char_classes[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, W, W, 0, 0, W, 0, 0, // 00
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 10
+    W, 0, 0, 0, 0, M, M, 0, 0, 0, M, M, 0, M, 0, M, // 20
+    D, D, D, D, D, D, D, D, D, D, 0, 0, 0, 0, 0, 0, // 30
+    0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A, // 40
+    A, A, A, A, A, A, A, A, A, A, A, 0, 0, 0, M, U, // 50
+    0, A, A, A, A, A, A, A, A, A, A, A, A, A, A, A, // 60
+    A, A, A, A, A, A, A, A, A, A, A, 0, M, 0, 0, 0, // 70
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 80
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 90
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // A0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // B0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // C0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // D0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // E0
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // F0
+};
+
+#undef W
+#undef A
+#undef D
+#undef U
+#undef M
+
+  ////////////////
+ // predicates //
+////////////////
 
 bool is_whitespace(uint8_t c) {
-    return (c == ' ' || c == '\t')
-        || (c == '\r' || c == '\n');
+    return (char_classes[c] & CHAR_WHITESPACE) != 0;
 }
 
 bool is_alpha(uint8_t c) {
-    return (c >= 'a' && c <= 'z')
-        || (c >= 'A' && c <= 'Z');
+    return (char_classes[c] & CHAR_ALPHA) != 0;
 }
 
 bool is_numeric(uint8_t c) {
-    return (c >= '0' && c <= '9');
+    return (char_classes[c] & CHAR_NUMERIC) != 0;
 }
 
 bool is_alphanumeric(uint8_t c) {
-    return (c >= 'a' && c <= 'z')
-        || (c >= 'A' && c <= 'Z')
-        || (c >= '0' && c <= '9');
+    return (char_classes[c] & (CHAR_ALPHA | CHAR_NUMERIC)) != 0;
 }
 
 bool is_math_op(uint8_t c) {
-    return (c == '+' || c == '-' || c == '*' || c == '/')
-        || (c == '|' || c == '&' || c == '^' || c == '%');
+    return (char_classes[c] & CHAR_MATH_OP) != 0;
 }
 
 bool is_term_op(uint8_t c) {
@@ -42,7 +77,7 @@ bool is_unary_op(uint8_t c) {
     return (c == '-');
 }
 
-bool is_identifier(char* str) {
+bool is_identifier(const char* str) {
     if (!is_alpha(*str) && *str != '_') { return FALSE; }
     while (is_alpha(*str) || *str == '_') { str++; }
     return (*str == NULL);
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "constants.h"
+#include "symbols.h"
+#include "file.h"
+#include "intern.h"
+#include "tokens.h"
+
+// the first character decides what kind of token it is
+token_kind_t token_kind(uint8_t first) {
+    if (char_classes[first] & CHAR_NUMERIC) { return TOKEN_NUMBER; }
+    if (char_classes[first] & (CHAR_ALPHA | CHAR_UNDERSCORE)) { return TOKEN_IDENTIFIER; }
+    return TOKEN_SYMBOL;
+}
+
+void tokens_add(token_array_s* tokens, token_kind_t kind, uint32_t start, const char* text, uint8_t length) {
+    if (tokens->count >= tokens->capacity) {
+        tokens->capacity = (tokens->capacity == 0) ? 256 : tokens->capacity * 2;
+        tokens->data = realloc(tokens->data, tokens->capacity * sizeof(token_s));
+        assert(tokens->data != NULL);
+    }
+    assert(length <= MAX_TOKEN_LEN);
+
+    token_s* token = &tokens->data[tokens->count++];
+    token->kind = kind;
+    token->length = length;
+    token->start = start;
+    token->id = intern_span(text, length);
+}
+
+  ///////////////////
+ // out.tok files //
+///////////////////
+
+// token count followed by (start, length) records
+void tokens_save(token_array_s* tokens, FILE* tok_ptr) {
+    assert(tokens->count <= ADDR_MAX);
+    fput_addr(tokens->count, tok_ptr);
+    for (uint32_t i = 0; i < tokens->count; i++) {
+        assert(tokens->data[i].start <= ADDR_MAX);
+        fput_addr(tokens->data[i].start, tok_ptr);
+        fputc(tokens->data[i].length, tok_ptr);
+    }
+}
+
+// rebuild tokens from an out.tok file and the source it points into
+void tokens_load(token_array_s* tokens, FILE* tok_ptr, FILE* src_ptr) {
+    addr_t count = fget_addr(tok_ptr);
+    char text[MAX_TOKEN_LEN];
+    for (addr_t i = 0; i < count; i++) {
+        addr_t start = fget_addr(tok_ptr);
+        uint8_t length = fgetc(tok_ptr);
+        assert(length <= MAX_TOKEN_LEN);
+
+        fseek(src_ptr, start, 0);
+        size_t read = fread(text, 1, length, src_ptr);
+        assert(read == length);
+        (void)read;
+
+        tokens_add(tokens, token_kind(text[0]), start, text, length);
+    }
+}
+
+void tokens_free(token_array_s* tokens) {
+    free(tokens->data);
+    tokens->data = NULL;
+    tokens->count = 0;
+    tokens->capacity = 0;
+}
@@ -0,0 +1,3 @@
+#include "trace.h"
+
+uint8_t trace_level = TRACE_NONE;
@@ -14,17 +14,17 @@ type_t get_type(char* s) {
     return TYPE_NONE;
 }
 
-uint16_t get_user_type(FILE* ast_ptr, char* token, uint16_t offset) {
+addr_t get_user_type(ast_arena_s* ast_ptr, char* token, addr_t offset) {
     ast_s peeked_node = { 0 };
     // read current
     ast_read_node(ast_ptr, offset, &peeked_node);
-    uint16_t highest_offset = peeked_node.parent_offset;
+    addr_t highest_offset = peeked_node.parent_offset;
 
     // search up
     while (offset != NULL) {
         // read current
         ast_read_node(ast_ptr, offset, &peeked_node);
-        uint16_t next_offset = highest_offset;
+        addr_t next_offset = highest_offset;
         if (peeked_node.offset == highest_offset) {
             highest_offset = peeked_node.parent_offset;
         }
@@ -52,6 +52,4 @@ next_up:
     }
 
     assert(FALSE);
-    // make pedantic compilers happy
-    node_constants[0] = node_constants[0];
 }
@@ -1,67 +1,115 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include "constants.h"
+#include "intern.h"
 #include "variables.h"
 
-static var_s vars[MAX_VARS_IN_SCOPE] = { 0 };
-static uint16_t vars_count = 0;
-static uint8_t current_scope = 0;
+  ///////////////
+ // variables //
+///////////////
+
+// every variable in scope, innermost last
+static thread_local var_s* vars = NULL;
+static thread_local uint32_t vars_count = 0;
+static thread_local uint32_t vars_capacity = 0;
+
+// innermost variable for each interned name, or -1
+static thread_local int32_t* visible = NULL;
+static thread_local uint32_t visible_capacity = 0;
+
+  ////////////
+ // scopes //
+////////////
+
+// vars_count at the start of every open scope
+static thread_local uint32_t* scope_starts = NULL;
+static thread_local uint16_t current_scope = 0;
+static thread_local uint16_t scope_capacity = 0;
 
 void scope_increment(void) {
-    assert(current_scope < 100);
+    if (current_scope >= scope_capacity) {
+        scope_capacity = (scope_capacity == 0) ? 16 : scope_capacity * 2;
+        scope_starts = realloc(scope_starts, scope_capacity * sizeof(uint32_t));
+        assert(scope_starts != NULL);
+    }
+    scope_starts[current_scope] = vars_count;
     current_scope++;
 }
 
 void scope_decrement(void) {
     assert(current_scope > 0);
     current_scope--;
-    while (vars_count > 0 && vars[vars_count - 1].scope > current_scope) {
+    while (vars_count > scope_starts[current_scope]) {
         vars_count--;
+        visible[vars[vars_count].name] = vars[vars_count].shadowed;
     }
 }
 
+void variables_clear(void) {
+    vars_count = 0;
+    current_scope = 0;
+    for (uint32_t i = 0; i < visible_capacity; i++) { visible[i] = -1; }
+}
+
+  ////////////
+ // lookup //
+////////////
+
 var_s* get_variable(char* name) {
-    for (int i = vars_count - 1; i >= 0; i--) {
-        if (!strcmp(name, vars[i].name)) { return &vars[i]; }
-    }
-    return NULL;
+    uint32_t id = intern_find(name);
+    if (id == INTERN_NONE || id >= visible_capacity || visible[id] < 0) { return NULL; }
+    return &vars[visible[id]];
 }
 
-uint16_t store_variable(type_t type, char* name, uint16_t size, uint16_t offset, uint16_t user_type_offset) {
-    assert(vars_count < MAX_VARS_IN_SCOPE);
+uint16_t store_variable(type_t type, char* name, uint16_t size, addr_t offset, addr_t user_type_offset) {
     var_s* same_name = get_variable(name);
     assert(same_name == NULL || same_name->scope < current_scope);
 
+    // make room
+    if (vars_count >= vars_capacity) {
+        vars_capacity = (vars_capacity == 0) ? 64 : vars_capacity * 2;
+        vars = realloc(vars, vars_capacity * sizeof(var_s));
+        assert(vars != NULL);
+    }
+    uint32_t id = intern(name);
+    if (id >= visible_capacity) {
+        uint32_t old_capacity = visible_capacity;
+        visible_capacity = intern_count() * 2;
+        visible = realloc(visible, visible_capacity * sizeof(int32_t));
+        assert(visible != NULL);
+        for (uint32_t i = old_capacity; i < visible_capacity; i++) { visible[i] = -1; }
+    }
+    var_s* var = &vars[vars_count];
+
     // store type
-    vars[vars_count].type = type;
+    var->type = type;
 
-    // store name
-    memset(vars[vars_count].name, NULL, MAX_TOKEN_LEN);
-    strcpy(vars[vars_count].name, name);
+    // store name, hiding any outer variable with the same name
+    var->name = id;
+    var->shadowed = visible[id];
+    visible[id] = vars_count;
 
     // store scope
-    vars[vars_count].scope = current_scope;
+    var->scope = current_scope;
 
     // store size
-    vars[vars_count].size = size;
+    var->size = size;
 
     // store offsets
-    vars[vars_count].offset = offset;
-    vars[vars_count].user_type_offset = user_type_offset;
+    var->offset = offset;
+    var->user_type_offset = user_type_offset;
 
     // calculate and store address
     uint16_t address = 0;
     if (vars_count > 0 && vars[vars_count - 1].scope == current_scope) {
         address = vars[vars_count - 1].address + vars[vars_count - 1].size;
     }
-    vars[vars_count].address = address;
+    var->address = address;
 
     // increment
     vars_count++;
 
     return address;
-
-    // make pedantic compilers happy
-    types[0] = types[0];
 }
@@ -0,0 +1,362 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "bytecode.h"
+#include "rom.h"
+#include "verify.h"
+
+  //////////////////
+ // instructions //
+//////////////////
+
+static uint16_t operand16(const uint8_t* at) {
+    return (at[0] << 8) | at[1];
+}
+
+static addr_t operand_addr(const uint8_t* at) {
+    #ifdef SHABBY_WIDE
+        return ((addr_t)operand16(at) << 16) | operand16(&at[2]);
+    #else
+        return operand16(at);
+    #endif
+}
+
+static void write_operand(uint8_t* at, uint32_t value, uint8_t size) {
+    for (uint8_t i = size; i-- > 0;) {
+        *at++ = (value >> (i * 8)) & 0xFF;
+    }
+}
+
+// bytes a varint takes, FALSE if it runs past remaining or past what an address holds
+static bool varint_length(const uint8_t* at, uint32_t remaining, uint32_t* length) {
+    for (uint32_t i = 0; i < remaining && i < BC_VARINT_MAX; i++) {
+        if (!(at[i] & 0x80)) {
+            *length = i + 1;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static uint32_t varint_value(const uint8_t* at, uint32_t* length) {
+    uint32_t value = 0;
+    uint32_t i = 0;
+    do {
+        value |= (uint32_t)(at[i] & 0x7F) << (i * 7);
+    } while (at[i++] & 0x80);
+    *length = i;
+    return value;
+}
+
+bool bytecode_length(const uint8_t* at, uint32_t remaining, uint32_t* length) {
+    uint8_t type = at[0];
+    if (type == (uint8_t)BC_EOF) {
+        *length = 1;
+    } else if (type == BC_TEST) {
+        if (remaining < 3) { return FALSE; }
+        *length = 3 + operand16(&at[1]);
+    } else if (type < BC_LAYOUT && type != BC_LABEL && bytecode[type].param_size == BC_VARINT) {
+        *length = 1;
+        for (uint8_t i = 0; i < bytecode[type].params; i++) {
+            uint32_t operand;
+            if (!varint_length(&at[*length], remaining - *length, &operand)) { return FALSE; }
+            *length += operand;
+        }
+    } else if (type < BC_LAYOUT && type != BC_LABEL) {
+        *length = 1 + bytecode[type].params * bytecode[type].param_size;
+    } else {
+        return FALSE;
+    }
+    return *length <= remaining;
+}
+
+const uint8_t* bytecode_expand(const uint8_t* at, uint8_t* buffer) {
+    uint8_t type = at[0];
+    if (type < BC_PUSH_SMALL8 || type >= BC_LAYOUT) { return at; }
+
+    if (type < BC_PUSH_SMALL16) {
+        buffer[0] = BC_PUSH8;
+        buffer[1] = type - BC_PUSH_SMALL8;
+        return buffer;
+    }
+    if (type < BC_PUSH_SMALL16 + BC_SMALL_COUNT) {
+        buffer[0] = BC_PUSH16;
+        write_operand(&buffer[1], type - BC_PUSH_SMALL16, 2);
+        return buffer;
+    }
+
+    // every operand widens to the long form's size
+    uint8_t long_type = bytecode_long_form[type];
+    uint8_t size = bytecode[long_type].param_size;
+    uint32_t from = 1;
+    buffer[0] = long_type;
+    for (uint8_t i = 0; i < bytecode[type].params; i++) {
+        uint32_t value = at[from];
+        uint32_t length = 1;
+        if (bytecode[type].param_size == BC_VARINT) { value = varint_value(&at[from], &length); }
+        write_operand(&buffer[1 + i * size], value, size);
+        from += length;
+    }
+    return buffer;
+}
+
+bool bytecode_effect(const uint8_t* at, uint16_t* pops, uint16_t* pushes) {
+    uint8_t expanded[BC_EXPANDED_SIZE];
+    at = bytecode_expand(at, expanded);
+    *pops = 0;
+    *pushes = 0;
+    switch (at[0]) {
+        case BC_NOOP: case BC_IJUMP: case BC_TEST: case (uint8_t)BC_EOF: break;
+        case BC_EXTEND: *pops = 1; *pushes = 2; break;
+
+        case BC_JUMP: case BC_POP_PC: *pops = ADDR_SIZE; break;
+        case BC_PUSH_PC: *pushes = ADDR_SIZE; break;
+        case BC_CALL: *pushes = ADDR_SIZE + 2; break;
+        case BC_RET: *pops = ADDR_SIZE + 2; break;
+
+        case BC_PUSH_FP: *pushes = 2; break;
+        case BC_POP_FP: *pops = 2; break;
+
+        case BC_PUSH_ZEROS: *pushes = operand16(&at[1]); break;
+        case BC_PUSH8: *pushes = 1; break;
+        case BC_PUSH16: *pushes = 2; break;
+        case BC_POP8: *pops = 1; break;
+        case BC_POP16: *pops = 2; break;
+
+        case BC_SET8: *pops = 3; break;
+        case BC_SET16: *pops = 4; break;
+        case BC_GET8: *pops = 2; *pushes = 1; break;
+        case BC_GET16: *pops = 2; *pushes = 2; break;
+        case BC_IGET8: *pushes = 1; break;
+        case BC_IGET16: *pushes = 2; break;
+        case BC_COPY: *pops = 6; break;
+
+        case BC_NEG8: *pops = 1; *pushes = 1; break;
+        case BC_NEG16: *pops = 2; *pushes = 2; break;
+        case BC_ADD8: case BC_SUB8: case BC_MUL8: case BC_DIV8: *pops = 2; *pushes = 1; break;
+        case BC_ADD16: case BC_SUB16: case BC_MUL16: case BC_DIV16: *pops = 4; *pushes = 2; break;
+
+        case BC_SETI8: *pops = 1; break;
+        case BC_SETI16: *pops = 2; break;
+        case BC_ADDI8: case BC_IGET_ADD8: case BC_IGET_MUL8: *pops = 1; *pushes = 1; break;
+        case BC_ADDI16: case BC_IGET_ADD16: case BC_IGET_MUL16: *pops = 2; *pushes = 2; break;
+
+        // slot ops only touch the frame
+        case BC_SLOT_MOV8: case BC_SLOT_ADD8: case BC_SLOT_SUB8: case BC_SLOT_MUL8: case BC_SLOT_DIV8: break;
+        case BC_SLOT_MOV16: case BC_SLOT_ADD16: case BC_SLOT_SUB16: case BC_SLOT_MUL16: case BC_SLOT_DIV16: break;
+
+        default: return FALSE;
+    }
+    return TRUE;
+}
+
+  ///////////////
+ // functions //
+///////////////
+
+// the program and every call target are checked on their own, then once per call site
+typedef enum {
+    FUNCTION_NEW = 0,
+    FUNCTION_WALKING,
+    FUNCTION_DONE,
+} function_state_t;
+
+typedef struct {
+    function_state_t state;
+    uint32_t frame; // bytes above the frame pointer it touches, callers must own them
+    uint32_t stack; // most bytes it pushes at once, callees included
+} function_s;
+
+typedef struct {
+    const uint8_t* code;
+    addr_t size;
+    bool* boundaries; // where instructions start
+    uint32_t* seen; // which function last walked each instruction
+    function_s* functions; // indexed by entry
+} verifier_s;
+
+// what the verifier knows about each byte of a function's stack, constants pushed as addresses
+typedef struct {
+    uint8_t values[EXEC_STACK_SIZE];
+    bool known[EXEC_STACK_SIZE];
+} shadow_s;
+
+static bool shadow_get16(shadow_s* shadow, uint32_t depth, uint32_t below, uint16_t* value) {
+    if (below > depth || !shadow->known[depth - below] || !shadow->known[depth - below + 1]) { return FALSE; }
+    memcpy(value, &shadow->values[depth - below], sizeof(uint16_t));
+    return TRUE;
+}
+
+static uint32_t max32(uint32_t a, uint32_t b) {
+    return (a > b) ? a : b;
+}
+
+// the program may touch whatever it has pushed, anything else records what its callers have to own
+static bool verify_access(function_s* function, bool program, uint32_t limit, uint32_t end) {
+    if (program) { return end <= limit; }
+    function->frame = max32(function->frame, end);
+    return TRUE;
+}
+
+static bool verify_function(verifier_s* v, addr_t entry, bool program) {
+    function_s* function = &v->functions[entry];
+    if (function->state == FUNCTION_DONE) { return TRUE; }
+    // recursion has no stack bound
+    if (function->state == FUNCTION_WALKING) { return FALSE; }
+    function->state = FUNCTION_WALKING;
+
+    shadow_s* shadow = malloc(sizeof(shadow_s));
+    assert(shadow != NULL);
+    uint32_t id = (uint32_t)entry + 1;
+    uint32_t depth = 0;
+    addr_t pc = entry;
+    bool verified = FALSE;
+
+    while (TRUE) {
+        // jumps land on instructions, and straight line code that comes back around never ends
+        if (pc > v->size || !v->boundaries[pc] || v->seen[pc] == id) { break; }
+        v->seen[pc] = id;
+
+        // the program finishes at the sentinel, wherever it is reached from
+        uint8_t window[ROM_WINDOW_SIZE];
+        const uint8_t* raw = rom_window(&v->code[pc], v->size - pc + 1, window);
+        if (pc == v->size || raw[0] == (uint8_t)BC_EOF) { verified = TRUE; break; }
+
+        // returns hand back exactly what the call pushed
+        if (raw[0] == BC_RET) { verified = !program && depth == 0; break; }
+
+        // compact forms are checked as the long forms they stand for
+        uint32_t length;
+        uint16_t pops, pushes;
+        uint8_t expanded[BC_EXPANDED_SIZE];
+        bytecode_length(raw, v->size - pc, &length);
+        const uint8_t* at = bytecode_expand(raw, expanded);
+        if (!bytecode_effect(at, &pops, &pushes) || pops > depth) { break; }
+        uint32_t limit = depth - pops;
+        uint16_t address, from, to, size;
+
+        bool ok = TRUE;
+        switch (at[0]) {
+            // control and frames that depend on runtime values can't be followed
+            case BC_JUMP: case BC_POP_PC: case BC_PUSH_PC: case BC_PUSH_FP: case BC_POP_FP:
+                ok = FALSE;
+                break;
+
+            case BC_IJUMP:
+                pc = operand_addr(&at[1]);
+                continue;
+
+            case BC_CALL: {
+                addr_t fp_change = operand_addr(&at[1]);
+                addr_t target = operand_addr(&at[1 + BC_ADDR]);
+                if (target >= v->size || !verify_function(v, target, FALSE)) { ok = FALSE; break; }
+                function_s* callee = &v->functions[target];
+                ok = verify_access(function, program, limit, (uint32_t)fp_change + callee->frame);
+                function->stack = max32(function->stack, depth + pushes + callee->stack);
+                // the callee's return pops what the call pushed
+                pushes = 0;
+                break;
+            }
+
+            // frame accesses through operands
+            case BC_IGET8: case BC_SETI8: case BC_IGET_ADD8: case BC_IGET_MUL8:
+                ok = verify_access(function, program, limit, operand16(&at[1]) + 1u);
+                break;
+            case BC_IGET16: case BC_SETI16: case BC_IGET_ADD16: case BC_IGET_MUL16:
+                ok = verify_access(function, program, limit, operand16(&at[1]) + 2u);
+                break;
+
+            // every operand of a slot op is a frame slot
+            case BC_SLOT_MOV8: case BC_SLOT_ADD8: case BC_SLOT_SUB8: case BC_SLOT_MUL8: case BC_SLOT_DIV8:
+            case BC_SLOT_MOV16: case BC_SLOT_ADD16: case BC_SLOT_SUB16: case BC_SLOT_MUL16: case BC_SLOT_DIV16:
+                for (uint8_t i = 0; i < bytecode[at[0]].params && ok; i++) {
+                    ok = verify_access(function, program, limit, operand16(&at[1 + i * 2]) + 1u + (at[0] - BC_SLOT_MOV8) % 2);
+                }
+                break;
+
+            // frame accesses through popped addresses, which have to be constants
+            case BC_GET8: case BC_GET16:
+                ok = shadow_get16(shadow, depth, 2, &address)
+                    && verify_access(function, program, limit, address + (at[0] == BC_GET8 ? 1u : 2u));
+                break;
+            case BC_SET8:
+                ok = shadow_get16(shadow, depth, 3, &address) && verify_access(function, program, limit, address + 1u);
+                break;
+            case BC_SET16:
+                ok = shadow_get16(shadow, depth, 4, &address) && verify_access(function, program, limit, address + 2u);
+                break;
+            case BC_COPY:
+                ok = shadow_get16(shadow, depth, 2, &from) && shadow_get16(shadow, depth, 4, &to) && shadow_get16(shadow, depth, 6, &size)
+                    && verify_access(function, program, limit, (uint32_t)from + size)
+                    && verify_access(function, program, limit, (uint32_t)to + size);
+                break;
+
+            case BC_TEST:
+                ok = operand16(&at[1]) <= depth;
+                break;
+
+            default:
+                break;
+        }
+        if (!ok || limit + pushes > EXEC_STACK_SIZE) { break; }
+
+        // only pushed constants are remembered, and only until something writes to the frame, the address
+        // a write lands on isn't always a constant and a callee can write to its caller's frame
+        if (at[0] == BC_CALL || at[0] == BC_SET8 || at[0] == BC_SET16 || at[0] == BC_SETI8 || at[0] == BC_SETI16
+            || at[0] == BC_COPY || (at[0] >= BC_SLOT_MOV8 && at[0] <= BC_SLOT_DIV16)) {
+            memset(shadow->known, FALSE, limit);
+        }
+        depth = limit;
+        for (uint16_t i = 0; i < pushes; i++) { shadow->known[depth + i] = FALSE; }
+        if (at[0] == BC_PUSH8) {
+            shadow->values[depth] = at[1];
+            shadow->known[depth] = TRUE;
+        } else if (at[0] == BC_PUSH16) {
+            uint16_t value = operand16(&at[1]);
+            memcpy(&shadow->values[depth], &value, sizeof(uint16_t));
+            shadow->known[depth] = TRUE;
+            shadow->known[depth + 1] = TRUE;
+        }
+        depth += pushes;
+        function->stack = max32(function->stack, depth);
+        pc += length;
+    }
+
+    free(shadow);
+    function->state = verified ? FUNCTION_DONE : FUNCTION_WALKING;
+    return verified;
+}
+
+  ////////////
+ // verify //
+////////////
+
+bool verify(const uint8_t* code, addr_t size, uint32_t* stack_needed) {
+    verifier_s v = {
+        .code = code,
+        .size = size,
+        .boundaries = calloc((size_t)size + 1, sizeof(bool)),
+        .seen = calloc((size_t)size + 1, sizeof(uint32_t)),
+        .functions = calloc((size_t)size + 1, sizeof(function_s)),
+    };
+    assert(v.boundaries != NULL && v.seen != NULL && v.functions != NULL);
+
+    // every instruction has to decode, the sentinel after the code ends the last one
+    bool verified = TRUE;
+    uint32_t length;
+    for (uint32_t pc = 0; pc < size && verified; pc += length) {
+        uint8_t window[ROM_WINDOW_SIZE];
+        verified = bytecode_length(rom_window(&code[pc], size - pc, window), size - pc, &length);
+        v.boundaries[pc] = TRUE;
+    }
+    v.boundaries[size] = TRUE;
+
+    verified = verified && verify_function(&v, 0, TRUE) && v.functions[0].stack <= EXEC_STACK_SIZE;
+    *stack_needed = verified ? v.functions[0].stack : EXEC_STACK_SIZE;
+
+    free(v.boundaries);
+    free(v.seen);
+    free(v.functions);
+    return verified;
+}
@@ -4,87 +4,179 @@
 #include <assert.h>
 #include "symbols.h"
 #include "file.h"
+#include "stages.h"
 #include "bytecode.h"
+#include "trace.h"
+#include "verify.h"
+#include "rom.h"
+#include "jit.h"
+#include "vm.h"
 
-  ///////////////////
- // file pointers //
-///////////////////
+// threaded dispatch relies on the labels-as-values extension
+#if defined(__GNUC__) && !defined(VM_SWITCH_DISPATCH)
+    #define VM_THREADED_DISPATCH
+#endif
 
-static FILE *bin_ptr = NULL; // binary bytecode
+// per instruction tracing at TRACE_STEPS, VM_NO_TRACE drops the check from debug builds
+#if defined(DEBUG) && !defined(VM_NO_TRACE)
+    #define VM_TRACE
+#endif
 
   /////////////////////
  // execution stack //
 /////////////////////
 
-#define EXEC_STACK_SIZE 255
-static uint8_t exec_stack[EXEC_STACK_SIZE];
-static uint8_t exec_stack_count = 0;
+// wide builds need a wider count for their larger stack
+#ifdef SHABBY_WIDE
+    typedef uint32_t exec_count_t;
+#else
+    typedef uint8_t exec_count_t;
+#endif
 
-  //////////////
- // pointers //
+
+  ///////////////
+ // registers //
 ///////////////
 
-uint16_t frame_ptr = 0;
+// lives in a local of the dispatch loop so the compiler can keep it in registers
+typedef struct {
+    const uint8_t* image; // bytecode, terminated by BC_EOF
+    uint8_t* stack;
+    addr_t pc; // program counter, index into image
+    uint16_t frame_ptr;
+    exec_count_t count; // bytes on the exec stack
+    uint32_t fuel; // preemption points left before yielding
+} vm_regs_s;
+
+  //////////////
+ // instance //
+//////////////
+
+// everything one script needs, so any number can run side by side
+struct shabby_vm_s {
+    const uint8_t* image; // bytecode terminated by BC_EOF, copied unless shared
+    addr_t image_size;
+    bool owns_image;
+    bool verified; // runs without checks while its stack fits
+    uint32_t stack_needed;
+    bool always_checked;
+    bool checked; // guard every instruction
+    vm_regs_s regs; // saved between runs
+    vm_status_t status;
+    jit_code_t* jit; // native code once vm_jit translated it
+    uint8_t exec_stack[EXEC_STACK_SIZE];
+};
+
+// all bytecode reads go through the rom accessors, plain loads unless the code is in flash
+static inline uint8_t fetch8(vm_regs_s* r) {
+    return rom_read8(&r->image[r->pc++]);
+}
+
+static inline uint16_t fetch16(vm_regs_s* r) {
+    uint16_t value = rom_read16(&r->image[r->pc]);
+    r->pc += 2;
+    return value;
+}
+
+// code addresses are ADDR_SIZE bytes
+static inline addr_t fetch_addr(vm_regs_s* r) {
+    #ifdef SHABBY_WIDE
+        addr_t value = (addr_t)fetch16(r) << 16;
+        return value | fetch16(r);
+    #else
+        return fetch16(r);
+    #endif
+}
+
+// leb128, verified and guarded code never has more bytes than an address holds
+static inline addr_t fetch_varint(vm_regs_s* r) {
+    addr_t value = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do {
+        byte = fetch8(r);
+        value |= (addr_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
 
   ///////////////
  // execution //
 ///////////////
 
+// 16 bit values are stored unaligned, memcpy keeps that well defined
+static inline uint16_t load16(uint8_t* ptr) {
+    uint16_t value;
+    memcpy(&value, ptr, sizeof(uint16_t));
+    return value;
+}
+
+static inline void store16(uint8_t* ptr, uint16_t value) {
+    memcpy(ptr, &value, sizeof(uint16_t));
+}
+
 // 8 bit
-static void exec_push8(uint8_t value) {
-    exec_stack[exec_stack_count] = value;
-    exec_stack_count++;
-    assert(exec_stack_count < EXEC_STACK_SIZE);
+static inline void exec_push8(vm_regs_s* r, uint8_t value) {
+    r->stack[r->count++] = value;
 }
 
-static uint8_t exec_pop8(void) {
-    assert(exec_stack_count > 0);
-    exec_stack_count--;
-    return exec_stack[exec_stack_count];
+static inline uint8_t exec_pop8(vm_regs_s* r) {
+    return r->stack[--r->count];
 }
 
-static uint8_t exec_get8(uint16_t index) {
-    uint16_t offset = (frame_ptr + index);
-    assert(offset < exec_stack_count);
-    return exec_stack[offset];
+static inline uint8_t exec_get8(vm_regs_s* r, uint16_t index) {
+    uint16_t offset = (r->frame_ptr + index);
+    return r->stack[offset];
 }
 
-static void exec_set8(uint16_t index, uint8_t value) {
-    uint16_t offset = (frame_ptr + index);
-    assert(offset < exec_stack_count);
-    exec_stack[offset] = value;
+static inline void exec_set8(vm_regs_s* r, uint16_t index, uint8_t value) {
+    uint16_t offset = (r->frame_ptr + index);
+    r->stack[offset] = value;
 }
 
 // 16 bit
-static void exec_push16(uint16_t value) {
-    *(uint16_t*)(&exec_stack[exec_stack_count]) = value;
-    exec_stack_count += 2;
-    assert(exec_stack_count < EXEC_STACK_SIZE);
+static inline void exec_push16(vm_regs_s* r, uint16_t value) {
+    store16(&r->stack[r->count], value);
+    r->count += 2;
 }
 
-static uint16_t exec_pop16(void) {
-    assert(exec_stack_count > 0);
-    exec_stack_count -= 2;
-    return *(uint16_t*)(&exec_stack[exec_stack_count]);
+static inline uint16_t exec_pop16(vm_regs_s* r) {
+    r->count -= 2;
+    return load16(&r->stack[r->count]);
 }
 
-static uint16_t exec_get16(uint16_t index) {
-    uint16_t offset = (frame_ptr + index);
-    assert(offset < exec_stack_count);
-    return *(uint16_t*)(&exec_stack[offset]);
+static inline uint16_t exec_get16(vm_regs_s* r, uint16_t index) {
+    uint16_t offset = (r->frame_ptr + index);
+    return load16(&r->stack[offset]);
 }
 
-static void exec_set16(uint16_t index, uint16_t value) {
-    uint16_t offset = (frame_ptr + index);
-    assert(offset < exec_stack_count);
-    *(uint16_t*)(&exec_stack[offset]) = value;
+static inline void exec_set16(vm_regs_s* r, uint16_t index, uint16_t value) {
+    uint16_t offset = (r->frame_ptr + index);
+    store16(&r->stack[offset], value);
 }
 
-#ifdef DEBUG
-    static void output_exec_stack(void) {
+// code addresses, low half pushed last
+static inline void exec_push_addr(vm_regs_s* r, addr_t value) {
+    #ifdef SHABBY_WIDE
+        exec_push16(r, (uint16_t)(value >> 16));
+    #endif
+    exec_push16(r, (uint16_t)value);
+}
+
+static inline addr_t exec_pop_addr(vm_regs_s* r) {
+    addr_t value = exec_pop16(r);
+    #ifdef SHABBY_WIDE
+        value |= (addr_t)exec_pop16(r) << 16;
+    #endif
+    return value;
+}
+
+#ifdef VM_TRACE
+    static void output_exec_stack(vm_regs_s* r) {
         printf("\t  >>  ");
-        for (int i = 0; i < exec_stack_count; i++) {
-            printf("%d ", (int8_t)exec_stack[i]);
+        for (exec_count_t i = 0; i < r->count; i++) {
+            printf("%d ", (int8_t)r->stack[i]);
         }
         printf("\n");
     }
@@ -95,203 +187,1004 @@ static void exec_set16(uint16_t index, uint16_t value) {
 //////////////////
 
 // misc
-static void vm_extend(void) {
-    assert(exec_stack_count > 0);
-    ((int8_t)exec_stack[exec_stack_count - 1]) >= 0
-        ? exec_push8(0)
-        : exec_push8((uint8_t)-1);
+static inline void vm_noop(vm_regs_s* r) { (void)r; }
+static inline void vm_extend(vm_regs_s* r) {
+    int8_t value = (int8_t)exec_pop8(r);
+    exec_push8(r, value);
+    value >= 0
+        ? exec_push8(r, 0)
+        : exec_push8(r, (uint8_t)-1);
 }
 
 // jumps
-static void vm_jump(void) { fseek(bin_ptr, exec_pop16(), 0); }
-static void vm_ijump(void) { fseek(bin_ptr, fget16(bin_ptr), 0); }
+static inline void vm_jump(vm_regs_s* r) { r->pc = exec_pop_addr(r); }
+static inline void vm_ijump(vm_regs_s* r) { r->pc = fetch_addr(r); }
+static inline void vm_ijump_v(vm_regs_s* r) { r->pc = fetch_varint(r); }
 
 // functions
 
-static void vm_call(void) {
+static inline void vm_call(vm_regs_s* r) {
     // push PC + parameters
-    exec_push16(ftell(bin_ptr) + bytecode[BC_CALL].params * bytecode[BC_CALL].param_size);
+    exec_push_addr(r, r->pc + bytecode[BC_CALL].params * bytecode[BC_CALL].param_size);
     // push FP difference
-    uint16_t fp_change = fget16(bin_ptr);
-    exec_push16(fp_change);
+    uint16_t fp_change = (uint16_t)fetch_addr(r);
+    exec_push16(r, fp_change);
     // increment FP
-    frame_ptr += fp_change;
+    r->frame_ptr += fp_change;
     // set PC
-    fseek(bin_ptr, fget16(bin_ptr), 0);
+    r->pc = fetch_addr(r);
 }
 
-static void vm_ret(void) {
+static inline void vm_ret(vm_regs_s* r) {
     // decrement FP
-    frame_ptr -= exec_pop16();
+    r->frame_ptr -= exec_pop16(r);
     // pop PC
-    fseek(bin_ptr, exec_pop16(), 0);
+    r->pc = exec_pop_addr(r);
+}
+
+// the return pc is only known once the operands are read
+static inline void vm_call_v(vm_regs_s* r) {
+    uint16_t fp_change = (uint16_t)fetch_varint(r);
+    addr_t target = fetch_varint(r);
+    exec_push_addr(r, r->pc);
+    exec_push16(r, fp_change);
+    r->frame_ptr += fp_change;
+    r->pc = target;
 }
 
 // program counter
-static void vm_push_pc(void) { exec_push16(ftell(bin_ptr)); }
-static void vm_pop_pc(void) { fseek(bin_ptr, exec_pop16(), 0); }
+static inline void vm_push_pc(vm_regs_s* r) { exec_push_addr(r, r->pc); }
+static inline void vm_pop_pc(vm_regs_s* r) { r->pc = exec_pop_addr(r); }
 
 // frame pointer
-static void vm_push_fp(void) { exec_push16(frame_ptr); }
-static void vm_pop_fp(void) { frame_ptr = exec_pop16(); }
+static inline void vm_push_fp(vm_regs_s* r) { exec_push16(r, r->frame_ptr); }
+static inline void vm_pop_fp(vm_regs_s* r) { r->frame_ptr = exec_pop16(r); }
 
 // stack basics
-static void vm_push_zeros(void) { uint16_t zeros = fget16(bin_ptr); while (zeros-- > 0) { exec_push8(0); } }
-
-static void vm_push8(void) { exec_push8(fgetc(bin_ptr)); }
-static void vm_pop8(void) { exec_pop8(); }
-
-static void vm_push16(void) { exec_push16(fget16(bin_ptr)); }
-static void vm_pop16(void) { exec_pop16(); }
-
-// pointers
-static void vm_iget8(void) { exec_push8(exec_get8(fget16(bin_ptr))); }
-static void vm_get8(void) { exec_push8(exec_get8(exec_pop16())); }
-static void vm_set8(void) { exec_set8(exec_pop16(), exec_pop8()); }
-
-static void vm_iget16(void) { exec_push16(exec_get16(fget16(bin_ptr))); }
-static void vm_get16(void) { exec_push16(exec_get16(exec_pop16())); }
-static void vm_set16(void) { exec_set16(exec_pop16(), exec_pop16()); }
-
-static void vm_copy(void) {
-    uint16_t from = frame_ptr + exec_pop16();
-    uint16_t to = frame_ptr + exec_pop16();
-    uint16_t size = exec_pop16();
-    memcpy(&exec_stack[to], &exec_stack[from], size);
-}
-
-// math
-static void vm_neg8(void) { exec_push8(-exec_pop8()); }
-static void vm_add8(void) { exec_push8(exec_pop8() + exec_pop8()); }
-static void vm_sub8(void) { exec_push8(exec_pop8() - exec_pop8()); }
-static void vm_mul8(void) { exec_push8(exec_pop8() * exec_pop8()); }
-static void vm_div8(void) { exec_push8(exec_pop8() / exec_pop8()); }
-
-static void vm_neg16(void) { exec_push16(-exec_pop16()); }
-static void vm_add16(void) { exec_push16(exec_pop16() + exec_pop16()); }
-static void vm_sub16(void) { exec_push16(exec_pop16() - exec_pop16()); }
-static void vm_mul16(void) { exec_push16(exec_pop16() * exec_pop16()); }
-static void vm_div16(void) { exec_push16(exec_pop16() / exec_pop16()); }
-
-static void vm_test(void) {
-    uint16_t count = fget16(bin_ptr);
-    assert(count <= exec_stack_count);
-    for (uint16_t i = exec_stack_count - count; i < exec_stack_count; i++) {
-        int8_t c = (int8_t)fgetc(bin_ptr);
-        if ((int8_t)exec_stack[i] != c) {
-            fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", c, (int8_t)exec_stack[i]);
+static inline void vm_push_zeros(vm_regs_s* r) { uint16_t zeros = fetch16(r); while (zeros-- > 0) { exec_push8(r, 0); } }
+
+static inline void vm_push8(vm_regs_s* r) { exec_push8(r, fetch8(r)); }
+static inline void vm_pop8(vm_regs_s* r) { exec_pop8(r); }
+
+static inline void vm_push16(vm_regs_s* r) { exec_push16(r, fetch16(r)); }
+static inline void vm_pop16(vm_regs_s* r) { exec_pop16(r); }
+
+// compact pushes, small ones take their value from the opcode that was just fetched
+static inline void vm_push_small8(vm_regs_s* r) { exec_push8(r, rom_read8(&r->image[r->pc - 1]) - BC_PUSH_SMALL8); }
+static inline void vm_push_small16(vm_regs_s* r) { exec_push16(r, rom_read8(&r->image[r->pc - 1]) - BC_PUSH_SMALL16); }
+static inline void vm_push16_s(vm_regs_s* r) { exec_push16(r, fetch8(r)); }
+static inline void vm_push_zeros_s(vm_regs_s* r) { uint8_t zeros = fetch8(r); while (zeros-- > 0) { exec_push8(r, 0); } }
+
+// pointers, the value sits above the address
+static inline void vm_iget8(vm_regs_s* r) { exec_push8(r, exec_get8(r, fetch16(r))); }
+static inline void vm_get8(vm_regs_s* r) { exec_push8(r, exec_get8(r, exec_pop16(r))); }
+static inline void vm_set8(vm_regs_s* r) {
+    uint8_t value = exec_pop8(r);
+    uint16_t address = exec_pop16(r);
+    exec_set8(r, address, value);
+}
+
+static inline void vm_iget16(vm_regs_s* r) { exec_push16(r, exec_get16(r, fetch16(r))); }
+static inline void vm_iget8_s(vm_regs_s* r) { exec_push8(r, exec_get8(r, fetch8(r))); }
+static inline void vm_iget16_s(vm_regs_s* r) { exec_push16(r, exec_get16(r, fetch8(r))); }
+static inline void vm_get16(vm_regs_s* r) { exec_push16(r, exec_get16(r, exec_pop16(r))); }
+static inline void vm_set16(vm_regs_s* r) {
+    uint16_t value = exec_pop16(r);
+    uint16_t address = exec_pop16(r);
+    exec_set16(r, address, value);
+}
+
+static inline void vm_copy(vm_regs_s* r) {
+    uint16_t from = r->frame_ptr + exec_pop16(r);
+    uint16_t to = r->frame_ptr + exec_pop16(r);
+    uint16_t size = exec_pop16(r);
+    // the ranges can overlap
+    memmove(&r->stack[to], &r->stack[from], size);
+}
+
+// math, the left operand is on top
+#define VM_BINARY_OP(name, bits, op) \
+    static inline void vm_##name##bits(vm_regs_s* r) { \
+        uint##bits##_t left = exec_pop##bits(r); \
+        uint##bits##_t right = exec_pop##bits(r); \
+        exec_push##bits(r, left op right); \
+    }
+
+static inline void vm_neg8(vm_regs_s* r) { exec_push8(r, -exec_pop8(r)); }
+VM_BINARY_OP(add, 8, +)
+VM_BINARY_OP(sub, 8, -)
+VM_BINARY_OP(mul, 8, *)
+
+static inline void vm_neg16(vm_regs_s* r) { exec_push16(r, -exec_pop16(r)); }
+VM_BINARY_OP(add, 16, +)
+VM_BINARY_OP(sub, 16, -)
+VM_BINARY_OP(mul, 16, *)
+
+#undef VM_BINARY_OP
+
+// dividing by zero faults the vm instead of the host
+static bool vm_divide_by_zero(void) {
+    fprintf(stderr, "Division by zero!\n");
+    return FALSE;
+}
+
+#define VM_DIV_OP(bits) \
+    static inline bool vm_div##bits(vm_regs_s* r) { \
+        uint##bits##_t left = exec_pop##bits(r); \
+        uint##bits##_t right = exec_pop##bits(r); \
+        if (right == 0) { return vm_divide_by_zero(); } \
+        exec_push##bits(r, left / right); \
+        return TRUE; \
+    }
+
+VM_DIV_OP(8)
+VM_DIV_OP(16)
+
+#undef VM_DIV_OP
+
+// superinstructions, the fetched operand stands in for a push, compact ones fetch a byte
+#define VM_SUPER_OPS(fetch, suffix) \
+    static inline void vm_seti8##suffix(vm_regs_s* r) { uint16_t address = fetch(r); exec_set8(r, address, exec_pop8(r)); } \
+    static inline void vm_seti16##suffix(vm_regs_s* r) { uint16_t address = fetch(r); exec_set16(r, address, exec_pop16(r)); } \
+    static inline void vm_iget_add8##suffix(vm_regs_s* r) { uint16_t address = fetch(r); uint8_t right = exec_pop8(r); exec_push8(r, exec_get8(r, address) + right); } \
+    static inline void vm_iget_add16##suffix(vm_regs_s* r) { uint16_t address = fetch(r); uint16_t right = exec_pop16(r); exec_push16(r, exec_get16(r, address) + right); } \
+    static inline void vm_iget_mul8##suffix(vm_regs_s* r) { uint16_t address = fetch(r); uint8_t right = exec_pop8(r); exec_push8(r, exec_get8(r, address) * right); } \
+    static inline void vm_iget_mul16##suffix(vm_regs_s* r) { uint16_t address = fetch(r); uint16_t right = exec_pop16(r); exec_push16(r, exec_get16(r, address) * right); }
+
+VM_SUPER_OPS(fetch16, )
+VM_SUPER_OPS(fetch8, _s)
+
+#undef VM_SUPER_OPS
+
+static inline void vm_addi8(vm_regs_s* r) { uint8_t k = fetch8(r); exec_push8(r, k + exec_pop8(r)); }
+static inline void vm_addi16(vm_regs_s* r) { uint16_t k = fetch16(r); exec_push16(r, k + exec_pop16(r)); }
+static inline void vm_addi16_s(vm_regs_s* r) { uint16_t k = fetch8(r); exec_push16(r, k + exec_pop16(r)); }
+
+// slot ops, every operand is a frame slot and the destination comes first
+static inline void vm_slot_mov8(vm_regs_s* r) { uint16_t to = fetch16(r); exec_set8(r, to, exec_get8(r, fetch16(r))); }
+static inline void vm_slot_mov16(vm_regs_s* r) { uint16_t to = fetch16(r); exec_set16(r, to, exec_get16(r, fetch16(r))); }
+static inline void vm_slot_mov8_s(vm_regs_s* r) { uint16_t to = fetch8(r); exec_set8(r, to, exec_get8(r, fetch8(r))); }
+static inline void vm_slot_mov16_s(vm_regs_s* r) { uint16_t to = fetch8(r); exec_set16(r, to, exec_get16(r, fetch8(r))); }
+
+#define VM_SLOT_OP(name, bits, op, fetch, suffix) \
+    static inline void vm_slot_##name##bits##suffix(vm_regs_s* r) { \
+        uint16_t to = fetch(r); \
+        uint##bits##_t left = exec_get##bits(r, fetch(r)); \
+        uint##bits##_t right = exec_get##bits(r, fetch(r)); \
+        exec_set##bits(r, to, left op right); \
+    }
+
+VM_SLOT_OP(add, 8, +, fetch16, )
+VM_SLOT_OP(sub, 8, -, fetch16, )
+VM_SLOT_OP(mul, 8, *, fetch16, )
+
+VM_SLOT_OP(add, 16, +, fetch16, )
+VM_SLOT_OP(sub, 16, -, fetch16, )
+VM_SLOT_OP(mul, 16, *, fetch16, )
+
+VM_SLOT_OP(add, 8, +, fetch8, _s)
+VM_SLOT_OP(sub, 8, -, fetch8, _s)
+VM_SLOT_OP(mul, 8, *, fetch8, _s)
+
+VM_SLOT_OP(add, 16, +, fetch8, _s)
+VM_SLOT_OP(sub, 16, -, fetch8, _s)
+VM_SLOT_OP(mul, 16, *, fetch8, _s)
+
+#undef VM_SLOT_OP
+
+#define VM_SLOT_DIV_OP(bits, fetch, suffix) \
+    static inline bool vm_slot_div##bits##suffix(vm_regs_s* r) { \
+        uint16_t to = fetch(r); \
+        uint##bits##_t left = exec_get##bits(r, fetch(r)); \
+        uint##bits##_t right = exec_get##bits(r, fetch(r)); \
+        if (right == 0) { return vm_divide_by_zero(); } \
+        exec_set##bits(r, to, left / right); \
+        return TRUE; \
+    }
+
+VM_SLOT_DIV_OP(8, fetch16, )
+VM_SLOT_DIV_OP(16, fetch16, )
+VM_SLOT_DIV_OP(8, fetch8, _s)
+VM_SLOT_DIV_OP(16, fetch8, _s)
+
+#undef VM_SLOT_DIV_OP
+
+// a mismatch faults the vm
+static inline bool vm_test(vm_regs_s* r) {
+    uint16_t count = fetch16(r);
+    bool passed = TRUE;
+    for (uint16_t i = r->count - count; i < r->count; i++) {
+        int8_t c = (int8_t)fetch8(r);
+        if ((int8_t)r->stack[i] != c) {
+            fprintf(stderr, "Test mismatch, expected: %d, got %d!\n", c, (int8_t)r->stack[i]);
+            passed = FALSE;
         }
-        assert((int8_t)exec_stack[i] == c);
     }
+    return passed;
 }
 
-void vm(FILE* bin_ptr_arg) {
-    bin_ptr = bin_ptr_arg;
+  ///////////
+ // guard //
+///////////
 
-    // print vm header
-    #ifdef DEBUG
-        printf("\n");
-        printf("executed\n");
-        printf("--------\n");
-    #endif
+// checked mode runs this ahead of every instruction so no handler reads or writes outside the image,
+// the stack or the frame, verified code skips it
+static bool vm_guard(shabby_vm_t* vm, vm_regs_s* r) {
+    uint32_t length;
+    uint16_t pops, pushes;
 
-    while (TRUE) {
-        bytecode_t type = fgetc(bin_ptr);
-        if ((uint8_t)type == (uint8_t)EOF) { break; }
+    if (r->pc > vm->image_size) { goto out_of_bounds; }
+    uint8_t window[ROM_WINDOW_SIZE];
+    const uint8_t* raw = rom_window(&r->image[r->pc], vm->image_size - r->pc + 1, window);
+
+    // unknown opcodes are left for the handler to report
+    if (raw[0] == BC_LABEL || (raw[0] >= BC_LAYOUT && raw[0] != (uint8_t)BC_EOF)) { return TRUE; }
+    if (!bytecode_length(raw, vm->image_size - r->pc + 1, &length)) { goto out_of_bounds; }
+
+    // compact forms are guarded as the long forms they stand for
+    uint8_t expanded[BC_EXPANDED_SIZE];
+    const uint8_t* at = bytecode_expand(raw, expanded);
+    bytecode_effect(at, &pops, &pushes);
+
+    if (r->count < pops || r->count - pops + pushes > EXEC_STACK_SIZE) { goto out_of_bounds; }
+
+    // frame accesses have to stay under whatever the instruction pops
+    uint32_t limit = r->count - pops;
+    uint32_t address = 0;
+    uint32_t end = 0;
+    switch (at[0]) {
+        case BC_IGET8: case BC_SETI8: case BC_IGET_ADD8: case BC_IGET_MUL8:
+            end = r->frame_ptr + ((at[1] << 8) | at[2]) + 1u;
+            break;
+        case BC_IGET16: case BC_SETI16: case BC_IGET_ADD16: case BC_IGET_MUL16:
+            end = r->frame_ptr + ((at[1] << 8) | at[2]) + 2u;
+            break;
+        case BC_GET8: end = r->frame_ptr + load16(&r->stack[r->count - 2]) + 1u; break;
+        case BC_GET16: end = r->frame_ptr + load16(&r->stack[r->count - 2]) + 2u; break;
+        case BC_SET8: end = r->frame_ptr + load16(&r->stack[r->count - 3]) + 1u; break;
+        case BC_SET16: end = r->frame_ptr + load16(&r->stack[r->count - 4]) + 2u; break;
+        case BC_COPY:
+            address = r->frame_ptr + load16(&r->stack[r->count - 2]);
+            end = r->frame_ptr + load16(&r->stack[r->count - 4]);
+            if (address < end) { address = end; }
+            end = address + load16(&r->stack[r->count - 6]);
+            break;
+        case BC_TEST:
+            end = (at[1] << 8) | at[2];
+            break;
+        case BC_SLOT_MOV8: case BC_SLOT_ADD8: case BC_SLOT_SUB8: case BC_SLOT_MUL8: case BC_SLOT_DIV8:
+        case BC_SLOT_MOV16: case BC_SLOT_ADD16: case BC_SLOT_SUB16: case BC_SLOT_MUL16: case BC_SLOT_DIV16:
+            // the furthest of the slots
+            for (uint8_t i = 0; i < bytecode[at[0]].params; i++) {
+                address = r->frame_ptr + ((at[1 + i * 2] << 8) | at[2 + i * 2]) + 1u + (at[0] - BC_SLOT_MOV8) % 2;
+                if (address > end) { end = address; }
+            }
+            break;
+        default:
+            break;
+    }
+    if (end > limit) { goto out_of_bounds; }
+    return TRUE;
+
+out_of_bounds:
+    fprintf(stderr, "Out of bounds at %04X!\n", (uint32_t)r->pc);
+    return FALSE;
+}
 
-        #ifdef DEBUG
-            printf("%04X  ", (uint16_t)ftell(bin_ptr));
-            printf("%s ", bytecode[type].name);
-        #endif
+  //////////////////////
+ // dispatch helpers //
+//////////////////////
+
+#ifdef VM_TRACE
+    #define TRACE_BEGIN(type) TRACE(TRACE_STEPS, "%04X  %s ", (uint32_t)regs.pc, bytecode[type].name)
+    #define TRACE_END() do { if (TRACING(TRACE_STEPS)) { output_exec_stack(&regs); } } while (0)
+#else
+    #define TRACE_BEGIN(type)
+    #define TRACE_END()
+#endif
+
+// fuel is only spent where control can loop, on backward jumps and on calls
+#define SPEND_FUEL() if (--regs.fuel == 0) { goto yield; }
+#define SPEND_FUEL_BACKWARD(from) if (regs.pc <= (from)) { SPEND_FUEL(); }
+
+  ///////////////////////
+ // switch dispatched //
+///////////////////////
+
+#ifndef VM_THREADED_DISPATCH
+static vm_status_t vm_switch(shabby_vm_t* vm) {
+    vm_regs_s regs = vm->regs;
+    bool checked = vm->checked;
+
+    while (TRUE) {
+        if (checked && !vm_guard(vm, &regs)) { goto fault; }
+        addr_t from = regs.pc;
+        uint8_t type = fetch8(&regs);
+        TRACE_BEGIN(type);
 
         switch (type) {
             // misc
-            case BC_NOOP: break;
-            case BC_EXTEND: vm_extend(); break;
+            case BC_NOOP: vm_noop(&regs); break;
+            case BC_EXTEND: vm_extend(&regs); break;
 
             // jumps
-            case BC_JUMP: vm_jump(); break;
-            case BC_IJUMP: vm_ijump(); break;
+            case BC_JUMP: vm_jump(&regs); SPEND_FUEL_BACKWARD(from); break;
+            case BC_IJUMP: vm_ijump(&regs); SPEND_FUEL_BACKWARD(from); break;
 
             // functions
-            case BC_CALL: vm_call(); break;
-            case BC_RET: vm_ret(); break;
+            case BC_CALL: vm_call(&regs); SPEND_FUEL(); break;
+            case BC_RET: vm_ret(&regs); break;
 
             // program counter
-            case BC_PUSH_PC: vm_push_pc(); break;
-            case BC_POP_PC: vm_pop_pc(); break;
+            case BC_PUSH_PC: vm_push_pc(&regs); break;
+            case BC_POP_PC: vm_pop_pc(&regs); SPEND_FUEL_BACKWARD(from); break;
 
             // frame pointer
-            case BC_PUSH_FP: vm_push_fp(); break;
-            case BC_POP_FP: vm_pop_fp(); break;
+            case BC_PUSH_FP: vm_push_fp(&regs); break;
+            case BC_POP_FP: vm_pop_fp(&regs); break;
 
             // stack basics
-            case BC_PUSH_ZEROS: vm_push_zeros(); break;
+            case BC_PUSH_ZEROS: vm_push_zeros(&regs); break;
 
-            case BC_PUSH8: vm_push8(); break;
-            case BC_POP8: vm_pop8(); break;
+            case BC_PUSH8: vm_push8(&regs); break;
+            case BC_POP8: vm_pop8(&regs); break;
 
-            case BC_PUSH16: vm_push16(); break;
-            case BC_POP16: vm_pop16(); break;
+            case BC_PUSH16: vm_push16(&regs); break;
+            case BC_POP16: vm_pop16(&regs); break;
 
             // pointers
-            case BC_GET8: vm_get8(); break;
-            case BC_IGET8: vm_iget8(); break;
-            case BC_SET8: vm_set8(); break;
+            case BC_GET8: vm_get8(&regs); break;
+            case BC_IGET8: vm_iget8(&regs); break;
+            case BC_SET8: vm_set8(&regs); break;
 
-            case BC_GET16: vm_get16(); break;
-            case BC_IGET16: vm_iget16(); break;
-            case BC_SET16: vm_set16(); break;
+            case BC_GET16: vm_get16(&regs); break;
+            case BC_IGET16: vm_iget16(&regs); break;
+            case BC_SET16: vm_set16(&regs); break;
 
-            case BC_COPY: vm_copy(); break;
+            case BC_COPY: vm_copy(&regs); break;
 
             // math
-            case BC_NEG8: vm_neg8(); break;
-            case BC_ADD8: vm_add8(); break;
-            case BC_SUB8: vm_sub8(); break;
-            case BC_MUL8: vm_mul8(); break;
-            case BC_DIV8: vm_div8(); break;
-
-            case BC_NEG16: vm_neg16(); break;
-            case BC_ADD16: vm_add16(); break;
-            case BC_SUB16: vm_sub16(); break;
-            case BC_MUL16: vm_mul16(); break;
-            case BC_DIV16: vm_div16(); break;
+            case BC_NEG8: vm_neg8(&regs); break;
+            case BC_ADD8: vm_add8(&regs); break;
+            case BC_SUB8: vm_sub8(&regs); break;
+            case BC_MUL8: vm_mul8(&regs); break;
+            case BC_DIV8: if (!vm_div8(&regs)) { goto fault; } break;
+
+            case BC_NEG16: vm_neg16(&regs); break;
+            case BC_ADD16: vm_add16(&regs); break;
+            case BC_SUB16: vm_sub16(&regs); break;
+            case BC_MUL16: vm_mul16(&regs); break;
+            case BC_DIV16: if (!vm_div16(&regs)) { goto fault; } break;
+
+            // superinstructions
+            case BC_SETI8: vm_seti8(&regs); break;
+            case BC_SETI16: vm_seti16(&regs); break;
+
+            case BC_ADDI8: vm_addi8(&regs); break;
+            case BC_ADDI16: vm_addi16(&regs); break;
+
+            case BC_IGET_ADD8: vm_iget_add8(&regs); break;
+            case BC_IGET_ADD16: vm_iget_add16(&regs); break;
+
+            case BC_IGET_MUL8: vm_iget_mul8(&regs); break;
+            case BC_IGET_MUL16: vm_iget_mul16(&regs); break;
+
+            // slot ops
+            case BC_SLOT_MOV8: vm_slot_mov8(&regs); break;
+            case BC_SLOT_MOV16: vm_slot_mov16(&regs); break;
+
+            case BC_SLOT_ADD8: vm_slot_add8(&regs); break;
+            case BC_SLOT_ADD16: vm_slot_add16(&regs); break;
+
+            case BC_SLOT_SUB8: vm_slot_sub8(&regs); break;
+            case BC_SLOT_SUB16: vm_slot_sub16(&regs); break;
+
+            case BC_SLOT_MUL8: vm_slot_mul8(&regs); break;
+            case BC_SLOT_MUL16: vm_slot_mul16(&regs); break;
+
+            case BC_SLOT_DIV8: if (!vm_slot_div8(&regs)) { goto fault; } break;
+            case BC_SLOT_DIV16: if (!vm_slot_div16(&regs)) { goto fault; } break;
 
             // testing
-            case BC_TEST: vm_test(); break;
+            case BC_TEST: if (!vm_test(&regs)) { goto fault; } break;
 
-            // misc
-            case BC_EOF: return;
+            // compact forms
+            case BC_PUSH_ZEROS_S: vm_push_zeros_s(&regs); break;
+            case BC_PUSH16_S: vm_push16_s(&regs); break;
+            case BC_ADDI16_S: vm_addi16_s(&regs); break;
+
+            case BC_IGET8_S: vm_iget8_s(&regs); break;
+            case BC_IGET16_S: vm_iget16_s(&regs); break;
+
+            case BC_SETI8_S: vm_seti8_s(&regs); break;
+            case BC_SETI16_S: vm_seti16_s(&regs); break;
+
+            case BC_IGET_ADD8_S: vm_iget_add8_s(&regs); break;
+            case BC_IGET_ADD16_S: vm_iget_add16_s(&regs); break;
+
+            case BC_IGET_MUL8_S: vm_iget_mul8_s(&regs); break;
+            case BC_IGET_MUL16_S: vm_iget_mul16_s(&regs); break;
+
+            case BC_SLOT_MOV8_S: vm_slot_mov8_s(&regs); break;
+            case BC_SLOT_MOV16_S: vm_slot_mov16_s(&regs); break;
 
-            // does not run in VM
-            case BC_LABEL: assert(FALSE);
+            case BC_SLOT_ADD8_S: vm_slot_add8_s(&regs); break;
+            case BC_SLOT_ADD16_S: vm_slot_add16_s(&regs); break;
+
+            case BC_SLOT_SUB8_S: vm_slot_sub8_s(&regs); break;
+            case BC_SLOT_SUB16_S: vm_slot_sub16_s(&regs); break;
+
+            case BC_SLOT_MUL8_S: vm_slot_mul8_s(&regs); break;
+            case BC_SLOT_MUL16_S: vm_slot_mul16_s(&regs); break;
+
+            case BC_SLOT_DIV8_S: if (!vm_slot_div8_s(&regs)) { goto fault; } break;
+            case BC_SLOT_DIV16_S: if (!vm_slot_div16_s(&regs)) { goto fault; } break;
+
+            case BC_IJUMP_V: vm_ijump_v(&regs); SPEND_FUEL_BACKWARD(from); break;
+            case BC_CALL_V: vm_call_v(&regs); SPEND_FUEL(); break;
+
+            // stay on the sentinel so running again is a no-op
+            case (uint8_t)BC_EOF: regs.pc--; goto finished;
+
+            // labels do not run in VM, small pushes are whole ranges of opcodes
+            case BC_LABEL:
+            default:
+                if (type >= BC_PUSH_SMALL8 && type < BC_PUSH_SMALL16) { vm_push_small8(&regs); break; }
+                if (type >= BC_PUSH_SMALL16 && type < BC_PUSH_SMALL16 + BC_SMALL_COUNT) { vm_push_small16(&regs); break; }
+                fprintf(stderr, "Invalid instruction at %04X!\n", (uint32_t)from);
+                goto fault;
         }
-        #ifdef DEBUG
-            output_exec_stack();
-        #else
-            // make pedantic compilers happy
-            bytecode[type] = bytecode[type];
-        #endif
+        TRACE_END();
     }
+
+finished:
+    vm->regs = regs;
+    return VM_FINISHED;
+
+yield:
+    TRACE_END();
+    vm->regs = regs;
+    return VM_YIELDED;
+
+fault:
+    vm->regs = regs;
+    return VM_FAULTED;
+}
+#endif
+
+  /////////////////////////
+ // threaded dispatched //
+/////////////////////////
+
+#ifdef VM_THREADED_DISPATCH
+// taking the address of a label is a GNU extension
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#pragma GCC diagnostic ignored "-Woverride-init"
+
+#define DISPATCH() goto *dispatch[rom_read8(&regs.image[regs.pc])]
+#define THREADED(bc, fn) op_##bc: regs.pc++; TRACE_BEGIN(bc); fn(&regs); TRACE_END(); DISPATCH();
+#define THREADED_JUMP(bc, fn) op_##bc: from = regs.pc++; TRACE_BEGIN(bc); fn(&regs); GUARD_TARGET(); SPEND_FUEL_BACKWARD(from); TRACE_END(); DISPATCH();
+#define THREADED_CALL(bc, fn) op_##bc: regs.pc++; TRACE_BEGIN(bc); fn(&regs); GUARD_TARGET(); SPEND_FUEL(); TRACE_END(); DISPATCH();
+#define THREADED_FAULTING(bc, fn) op_##bc: regs.pc++; TRACE_BEGIN(bc); if (!fn(&regs)) { goto fault; } TRACE_END(); DISPATCH();
+#define THREADED_RETURN(bc, fn) op_##bc: regs.pc++; TRACE_BEGIN(bc); fn(&regs); GUARD_TARGET(); TRACE_END(); DISPATCH();
+
+// dispatching reads the opcode before the guard can look at it, so checked mode vets jump targets first
+#define GUARD_TARGET() if (checked && regs.pc > vm->image_size) { goto out_of_bounds; }
+
+static vm_status_t vm_threaded(shabby_vm_t* vm) {
+    // opcodes without a handler are invalid, the table is never written so instances can share it
+    static void* const ops[256] = {
+        [0 ... 255] = &&op_invalid,
+
+        // misc
+        [BC_NOOP] = &&op_BC_NOOP,
+        [BC_EXTEND] = &&op_BC_EXTEND,
+
+        // jumps
+        [BC_JUMP] = &&op_BC_JUMP,
+        [BC_IJUMP] = &&op_BC_IJUMP,
+
+        // functions
+        [BC_CALL] = &&op_BC_CALL,
+        [BC_RET] = &&op_BC_RET,
+
+        // program counter
+        [BC_PUSH_PC] = &&op_BC_PUSH_PC,
+        [BC_POP_PC] = &&op_BC_POP_PC,
+
+        // frame pointer
+        [BC_PUSH_FP] = &&op_BC_PUSH_FP,
+        [BC_POP_FP] = &&op_BC_POP_FP,
+
+        // stack basics
+        [BC_PUSH_ZEROS] = &&op_BC_PUSH_ZEROS,
+
+        [BC_PUSH8] = &&op_BC_PUSH8,
+        [BC_POP8] = &&op_BC_POP8,
+
+        [BC_PUSH16] = &&op_BC_PUSH16,
+        [BC_POP16] = &&op_BC_POP16,
+
+        // pointers
+        [BC_GET8] = &&op_BC_GET8,
+        [BC_IGET8] = &&op_BC_IGET8,
+        [BC_SET8] = &&op_BC_SET8,
+
+        [BC_GET16] = &&op_BC_GET16,
+        [BC_IGET16] = &&op_BC_IGET16,
+        [BC_SET16] = &&op_BC_SET16,
+
+        [BC_COPY] = &&op_BC_COPY,
+
+        // math
+        [BC_NEG8] = &&op_BC_NEG8,
+        [BC_ADD8] = &&op_BC_ADD8,
+        [BC_SUB8] = &&op_BC_SUB8,
+        [BC_MUL8] = &&op_BC_MUL8,
+        [BC_DIV8] = &&op_BC_DIV8,
+
+        [BC_NEG16] = &&op_BC_NEG16,
+        [BC_ADD16] = &&op_BC_ADD16,
+        [BC_SUB16] = &&op_BC_SUB16,
+        [BC_MUL16] = &&op_BC_MUL16,
+        [BC_DIV16] = &&op_BC_DIV16,
+
+        // superinstructions
+        [BC_SETI8] = &&op_BC_SETI8,
+        [BC_SETI16] = &&op_BC_SETI16,
+
+        [BC_ADDI8] = &&op_BC_ADDI8,
+        [BC_ADDI16] = &&op_BC_ADDI16,
+
+        [BC_IGET_ADD8] = &&op_BC_IGET_ADD8,
+        [BC_IGET_ADD16] = &&op_BC_IGET_ADD16,
+
+        [BC_IGET_MUL8] = &&op_BC_IGET_MUL8,
+        [BC_IGET_MUL16] = &&op_BC_IGET_MUL16,
+
+        // slot ops
+        [BC_SLOT_MOV8] = &&op_BC_SLOT_MOV8,
+        [BC_SLOT_MOV16] = &&op_BC_SLOT_MOV16,
+
+        [BC_SLOT_ADD8] = &&op_BC_SLOT_ADD8,
+        [BC_SLOT_ADD16] = &&op_BC_SLOT_ADD16,
+
+        [BC_SLOT_SUB8] = &&op_BC_SLOT_SUB8,
+        [BC_SLOT_SUB16] = &&op_BC_SLOT_SUB16,
+
+        [BC_SLOT_MUL8] = &&op_BC_SLOT_MUL8,
+        [BC_SLOT_MUL16] = &&op_BC_SLOT_MUL16,
+
+        [BC_SLOT_DIV8] = &&op_BC_SLOT_DIV8,
+        [BC_SLOT_DIV16] = &&op_BC_SLOT_DIV16,
+
+        // testing
+        [BC_TEST] = &&op_BC_TEST,
+
+        // compact forms
+        [BC_PUSH_SMALL8 ... BC_PUSH_SMALL8 + BC_SMALL_COUNT - 1] = &&op_BC_PUSH_SMALL8,
+        [BC_PUSH_SMALL16 ... BC_PUSH_SMALL16 + BC_SMALL_COUNT - 1] = &&op_BC_PUSH_SMALL16,
+
+        [BC_PUSH_ZEROS_S] = &&op_BC_PUSH_ZEROS_S,
+        [BC_PUSH16_S] = &&op_BC_PUSH16_S,
+        [BC_ADDI16_S] = &&op_BC_ADDI16_S,
+
+        [BC_IGET8_S] = &&op_BC_IGET8_S,
+        [BC_IGET16_S] = &&op_BC_IGET16_S,
+
+        [BC_SETI8_S] = &&op_BC_SETI8_S,
+        [BC_SETI16_S] = &&op_BC_SETI16_S,
+
+        [BC_IGET_ADD8_S] = &&op_BC_IGET_ADD8_S,
+        [BC_IGET_ADD16_S] = &&op_BC_IGET_ADD16_S,
+
+        [BC_IGET_MUL8_S] = &&op_BC_IGET_MUL8_S,
+        [BC_IGET_MUL16_S] = &&op_BC_IGET_MUL16_S,
+
+        [BC_SLOT_MOV8_S] = &&op_BC_SLOT_MOV8_S,
+        [BC_SLOT_MOV16_S] = &&op_BC_SLOT_MOV16_S,
+
+        [BC_SLOT_ADD8_S] = &&op_BC_SLOT_ADD8_S,
+        [BC_SLOT_ADD16_S] = &&op_BC_SLOT_ADD16_S,
+
+        [BC_SLOT_SUB8_S] = &&op_BC_SLOT_SUB8_S,
+        [BC_SLOT_SUB16_S] = &&op_BC_SLOT_SUB16_S,
+
+        [BC_SLOT_MUL8_S] = &&op_BC_SLOT_MUL8_S,
+        [BC_SLOT_MUL16_S] = &&op_BC_SLOT_MUL16_S,
+
+        [BC_SLOT_DIV8_S] = &&op_BC_SLOT_DIV8_S,
+        [BC_SLOT_DIV16_S] = &&op_BC_SLOT_DIV16_S,
+
+        [BC_IJUMP_V] = &&op_BC_IJUMP_V,
+        [BC_CALL_V] = &&op_BC_CALL_V,
+
+        // misc
+        [(uint8_t)BC_EOF] = &&op_BC_EOF,
+    };
+    // checked mode sends every instruction through the guard first
+    static void* const checked_ops[256] = {
+        [0 ... 255] = &&op_guard,
+    };
+    bool checked = vm->checked;
+    void* const* dispatch = checked ? checked_ops : ops;
+    vm_regs_s regs = vm->regs;
+    addr_t from;
+
+    DISPATCH();
+
+    // misc
+    THREADED(BC_NOOP, vm_noop);
+    THREADED(BC_EXTEND, vm_extend);
+
+    // jumps
+    THREADED_JUMP(BC_JUMP, vm_jump);
+    THREADED_JUMP(BC_IJUMP, vm_ijump);
+
+    // functions
+    THREADED_CALL(BC_CALL, vm_call);
+    THREADED_RETURN(BC_RET, vm_ret);
+
+    // program counter
+    THREADED(BC_PUSH_PC, vm_push_pc);
+    THREADED_JUMP(BC_POP_PC, vm_pop_pc);
+
+    // frame pointer
+    THREADED(BC_PUSH_FP, vm_push_fp);
+    THREADED(BC_POP_FP, vm_pop_fp);
+
+    // stack basics
+    THREADED(BC_PUSH_ZEROS, vm_push_zeros);
+
+    THREADED(BC_PUSH8, vm_push8);
+    THREADED(BC_POP8, vm_pop8);
+
+    THREADED(BC_PUSH16, vm_push16);
+    THREADED(BC_POP16, vm_pop16);
+
+    // pointers
+    THREADED(BC_GET8, vm_get8);
+    THREADED(BC_IGET8, vm_iget8);
+    THREADED(BC_SET8, vm_set8);
+
+    THREADED(BC_GET16, vm_get16);
+    THREADED(BC_IGET16, vm_iget16);
+    THREADED(BC_SET16, vm_set16);
+
+    THREADED(BC_COPY, vm_copy);
+
+    // math
+    THREADED(BC_NEG8, vm_neg8);
+    THREADED(BC_ADD8, vm_add8);
+    THREADED(BC_SUB8, vm_sub8);
+    THREADED(BC_MUL8, vm_mul8);
+    THREADED_FAULTING(BC_DIV8, vm_div8);
+
+    THREADED(BC_NEG16, vm_neg16);
+    THREADED(BC_ADD16, vm_add16);
+    THREADED(BC_SUB16, vm_sub16);
+    THREADED(BC_MUL16, vm_mul16);
+    THREADED_FAULTING(BC_DIV16, vm_div16);
+
+    // superinstructions
+    THREADED(BC_SETI8, vm_seti8);
+    THREADED(BC_SETI16, vm_seti16);
+
+    THREADED(BC_ADDI8, vm_addi8);
+    THREADED(BC_ADDI16, vm_addi16);
+
+    THREADED(BC_IGET_ADD8, vm_iget_add8);
+    THREADED(BC_IGET_ADD16, vm_iget_add16);
+
+    THREADED(BC_IGET_MUL8, vm_iget_mul8);
+    THREADED(BC_IGET_MUL16, vm_iget_mul16);
+
+    // slot ops
+    THREADED(BC_SLOT_MOV8, vm_slot_mov8);
+    THREADED(BC_SLOT_MOV16, vm_slot_mov16);
+
+    THREADED(BC_SLOT_ADD8, vm_slot_add8);
+    THREADED(BC_SLOT_ADD16, vm_slot_add16);
+
+    THREADED(BC_SLOT_SUB8, vm_slot_sub8);
+    THREADED(BC_SLOT_SUB16, vm_slot_sub16);
+
+    THREADED(BC_SLOT_MUL8, vm_slot_mul8);
+    THREADED(BC_SLOT_MUL16, vm_slot_mul16);
+
+    THREADED_FAULTING(BC_SLOT_DIV8, vm_slot_div8);
+    THREADED_FAULTING(BC_SLOT_DIV16, vm_slot_div16);
+
+    // testing
+op_BC_TEST:
+    regs.pc++;
+    TRACE_BEGIN(BC_TEST);
+    if (!vm_test(&regs)) { goto fault; }
+    TRACE_END();
+    DISPATCH();
+
+    // compact forms
+    THREADED(BC_PUSH_SMALL8, vm_push_small8);
+    THREADED(BC_PUSH_SMALL16, vm_push_small16);
+
+    THREADED(BC_PUSH_ZEROS_S, vm_push_zeros_s);
+    THREADED(BC_PUSH16_S, vm_push16_s);
+    THREADED(BC_ADDI16_S, vm_addi16_s);
+
+    THREADED(BC_IGET8_S, vm_iget8_s);
+    THREADED(BC_IGET16_S, vm_iget16_s);
+
+    THREADED(BC_SETI8_S, vm_seti8_s);
+    THREADED(BC_SETI16_S, vm_seti16_s);
+
+    THREADED(BC_IGET_ADD8_S, vm_iget_add8_s);
+    THREADED(BC_IGET_ADD16_S, vm_iget_add16_s);
+
+    THREADED(BC_IGET_MUL8_S, vm_iget_mul8_s);
+    THREADED(BC_IGET_MUL16_S, vm_iget_mul16_s);
+
+    THREADED(BC_SLOT_MOV8_S, vm_slot_mov8_s);
+    THREADED(BC_SLOT_MOV16_S, vm_slot_mov16_s);
+
+    THREADED(BC_SLOT_ADD8_S, vm_slot_add8_s);
+    THREADED(BC_SLOT_ADD16_S, vm_slot_add16_s);
+
+    THREADED(BC_SLOT_SUB8_S, vm_slot_sub8_s);
+    THREADED(BC_SLOT_SUB16_S, vm_slot_sub16_s);
+
+    THREADED(BC_SLOT_MUL8_S, vm_slot_mul8_s);
+    THREADED(BC_SLOT_MUL16_S, vm_slot_mul16_s);
+
+    THREADED_FAULTING(BC_SLOT_DIV8_S, vm_slot_div8_s);
+    THREADED_FAULTING(BC_SLOT_DIV16_S, vm_slot_div16_s);
+
+    THREADED_JUMP(BC_IJUMP_V, vm_ijump_v);
+    THREADED_CALL(BC_CALL_V, vm_call_v);
+
+op_guard:
+    if (!vm_guard(vm, &regs)) { goto fault; }
+    goto *ops[rom_read8(&regs.image[regs.pc])];
+
+op_invalid:
+    fprintf(stderr, "Invalid instruction at %04X!\n", (uint32_t)regs.pc);
+    goto fault;
+
+out_of_bounds:
+    fprintf(stderr, "Out of bounds at %04X!\n", (uint32_t)regs.pc);
+    goto fault;
+
+op_BC_EOF:
+    vm->regs = regs;
+    return VM_FINISHED;
+
+yield:
+    TRACE_END();
+    vm->regs = regs;
+    return VM_YIELDED;
+
+fault:
+    vm->regs = regs;
+    return VM_FAULTED;
+}
+
+#undef THREADED
+#undef THREADED_JUMP
+#undef THREADED_CALL
+#undef THREADED_RETURN
+#undef THREADED_FAULTING
+#undef GUARD_TARGET
+#undef DISPATCH
+#pragma GCC diagnostic pop
+#endif
+
+  /////////
+ // api //
+/////////
+
+// copies the bytecode and appends a BC_EOF sentinel after the last instruction
+shabby_vm_t* vm_create(const uint8_t* image, size_t size) {
+    uint8_t* copy = malloc(size + 1);
+    assert(copy != NULL);
+    memcpy(copy, image, size);
+    copy[size] = (uint8_t)BC_EOF;
+
+    shabby_vm_t* vm = vm_create_shared(copy, size);
+    vm->owns_image = TRUE;
+    return vm;
+}
+
+static shabby_vm_t* vm_create_verified(const uint8_t* image, size_t size, bool verified, uint32_t stack_needed) {
+    assert(size < ADDR_MAX);
+    assert(rom_read8(&image[size]) == (uint8_t)BC_EOF);
+    shabby_vm_t* vm = malloc(sizeof(shabby_vm_t));
+    assert(vm != NULL);
+
+    vm->image = image;
+    vm->image_size = (addr_t)size;
+    vm->owns_image = FALSE;
+    vm->verified = verified;
+    vm->stack_needed = stack_needed;
+    vm->always_checked = FALSE;
+    vm->jit = NULL;
+
+    vm_reset(vm);
+    return vm;
+}
+
+// runs straight out of the caller's image, which must already end in a BC_EOF sentinel and outlive the vm
+shabby_vm_t* vm_create_shared(const uint8_t* image, size_t size) {
+    assert(size < ADDR_MAX);
+    uint32_t stack_needed;
+    bool verified = verify(image, (addr_t)size, &stack_needed);
+    return vm_create_verified(image, size, verified, stack_needed);
+}
+
+// runs straight out of a loaded image, NULL if it needs more stack than this build has
+shabby_vm_t* vm_create_image(const image_s* image) {
+    if (image->stack_size > EXEC_STACK_SIZE) {
+        fprintf(stderr, "Image needs %u bytes of stack, only %u available!\n", image->stack_size, EXEC_STACK_SIZE);
+        return NULL;
+    }
+    return vm_create_verified(image->code, image->code_size, image->verified, image->stack_needed);
+}
+
+// guards every instruction even if the code verified
+void vm_check(shabby_vm_t* vm) {
+    vm->always_checked = TRUE;
+    vm->checked = TRUE;
+}
+
+bool vm_checked(const shabby_vm_t* vm) {
+    return vm->checked;
+}
+
+// translates verified code to native code, FALSE if it didn't verify or the host has no jit,
+// the interpreter runs whatever native code can't
+bool vm_jit(shabby_vm_t* vm) {
+    if (vm->jit == NULL && vm->verified) { vm->jit = jit_compile(vm->image, vm->image_size); }
+    return vm->jit != NULL;
+}
+
+// the exec stack as the last run left it, the first byte is the bottom
+const uint8_t* vm_stack(shabby_vm_t* vm, uint32_t* count) {
+    *count = vm->regs.count;
+    return vm->regs.stack;
+}
+
+// back to the first instruction with an empty stack
+void vm_reset(shabby_vm_t* vm) {
+    vm->regs = (vm_regs_s){ 0 };
+    vm->regs.image = vm->image;
+    vm->regs.stack = vm->exec_stack;
+    vm->status = VM_YIELDED;
+    vm->checked = !vm->verified || vm->always_checked;
+}
+
+// copies an input frame onto the stack below the script, whose addresses then start after it
+void vm_load_frame(shabby_vm_t* vm, const uint8_t* frame, uint16_t size) {
+    assert(vm->regs.count == 0);
+    assert(size < EXEC_STACK_SIZE);
+    memcpy(vm->regs.stack, frame, size);
+    vm->regs.count = (exec_count_t)size;
+    vm->regs.frame_ptr = size;
+
+    // verified code only runs unchecked if the frame leaves it enough stack
+    if (size + vm->stack_needed > EXEC_STACK_SIZE) { vm->checked = TRUE; }
+}
+
+// native code shares the exec stack, FALSE if it handed the rest of the run to the interpreter
+static bool vm_native(shabby_vm_t* vm) {
+    vm_regs_s* r = &vm->regs;
+    jit_context_s context = {
+        .top = &r->stack[r->count],
+        .frame = &r->stack[r->frame_ptr],
+        .pc = r->pc,
+        .fuel = r->fuel,
+    };
+    jit_status_t status = jit_run(vm->jit, &context);
+    r->count = (exec_count_t)(context.top - r->stack);
+    r->frame_ptr = (uint16_t)(context.frame - r->stack);
+    r->pc = (addr_t)context.pc;
+    r->fuel = context.fuel;
+
+    switch (status) {
+        case JIT_FINISHED: vm->status = VM_FINISHED; return TRUE;
+        case JIT_YIELDED: vm->status = VM_YIELDED; return TRUE;
+        case JIT_FAULTED: vm->status = VM_FAULTED; return TRUE;
+        default: return FALSE;
+    }
+}
+
+// runs until the end of the image or until fuel backward jumps and calls have been taken,
+// a yielded vm picks up where it left off, a finished one stays finished and a faulted one faulted
+vm_status_t vm_run(shabby_vm_t* vm, uint32_t fuel) {
+    assert(fuel > 0);
+    if (vm->status == VM_FAULTED) { return VM_FAULTED; }
+
+    vm->regs.fuel = fuel;
+
+    // native code only starts from the top, yielded runs carry on in the interpreter
+    if (vm->jit != NULL && vm->regs.pc == 0 && !vm->checked && !TRACING(TRACE_STEPS) && vm_native(vm)) { return vm->status; }
+
+    #ifdef VM_THREADED_DISPATCH
+        vm->status = vm_threaded(vm);
+    #else
+        vm->status = vm_switch(vm);
+    #endif
+    return vm->status;
+}
+
+void vm_destroy(shabby_vm_t* vm) {
+    if (vm->owns_image) { free((uint8_t*)vm->image); }
+    jit_free(vm->jit);
+    free(vm);
+}
+
+  /////////////
+ // loading //
+/////////////
+
+bool vm_use_jit = FALSE;
+
+static bool vm_run_image(const image_s* image) {
+    shabby_vm_t* instance = vm_create_image(image);
+    if (instance == NULL) { return FALSE; }
+    if (vm_use_jit) { vm_jit(instance); }
+
+    // print vm header
+    TRACE(TRACE_STAGES, "\n");
+    TRACE(TRACE_STAGES, "executed\n");
+    TRACE(TRACE_STAGES, "--------\n");
+
+    vm_status_t status;
+    do {
+        status = vm_run(instance, VM_FUEL_MAX);
+    } while (status == VM_YIELDED);
+    vm_destroy(instance);
+    return status == VM_FINISHED;
+}
+
+// read the entire image into memory and run it to the end, FALSE if it was invalid or faulted
+bool vm(FILE* bin_ptr) {
+    fseek(bin_ptr, 0, SEEK_END);
+    long size = ftell(bin_ptr);
+    assert(size >= 0);
+    fseek(bin_ptr, 0, 0);
+
+    uint8_t* bytes = malloc(size);
+    assert(size == 0 || bytes != NULL);
+    size_t read = fread(bytes, 1, size, bin_ptr);
+    assert(read == (size_t)size);
+    (void)read;
+
+    image_s image;
+    bool finished = image_load(&image, bytes, size) && vm_run_image(&image);
+    free(bytes);
+    return finished;
 }
 
   //////////
  // main //
 //////////
 
+#ifndef SHABBY_LIBRARY
 int main(int argc, char *argv[]) {
     assert(argc == 2);
+    trace_level = TRACE_STEPS;
 
     char bin_buffer[256] = { 0 };
     sprintf(bin_buffer, "../bin/compilation/%s.bin", "out");
-    bin_ptr = fopen(bin_buffer, "rb");
 
-    vm(bin_ptr);
+    // standalone runs map the image instead of reading it
+    image_s image;
+    if (!image_map(&image, bin_buffer)) { return 1; }
+    bool finished = vm_run_image(&image);
+    image_unmap(&image);
 
-    fclose(bin_ptr);
-    return 0;
+    return finished ? 0 : 1;
 
     // make pedantic compilers happy
     argv[0] = argv[0];
 }
+#endif
@@ -7,6 +7,46 @@ echo ""
 echo "Testing..."
 set -e
 
+# thumb code is only checked for real under qemu user mode, a host without the arm tools fails here
+# unless SHABBY_NO_QEMU=1 says to go on with the thumb code unchecked
+thumb_checked=1
+if ! hash llvm-mc 2>/dev/null || ! hash ld.lld 2>/dev/null || ! hash qemu-arm 2>/dev/null; then
+	if [ "$SHABBY_NO_QEMU" != "1" ]; then
+		echo "FAILED: thumb code needs llvm-mc, ld.lld and qemu-arm, SHABBY_NO_QEMU=1 runs without checking it"
+		exit 1
+	fi
+	echo "  WARNING: thumb code is NOT checked, llvm-mc, ld.lld or qemu-arm is missing"
+	thumb_checked=0
+fi
+
+# thumb code is linked and run under qemu-arm, thumb-run is only a quicker look where llvm-mc is around
+thumb_test(){
+	hash llvm-mc 2>/dev/null || return 0
+	llvm-mc -triple=thumbv6m-none-eabi -filetype=obj $1.s -o $1_thumb.o
+	./thumb-run $1_thumb.o
+	[ $thumb_checked -eq 1 ] || return 0
+	llvm-mc -triple=thumbv6m-none-eabi -filetype=obj --defsym SHABBY_MAIN=1 $1.s -o $1_main.o
+	ld.lld $1_main.o -o $1_thumb
+	qemu-arm $1_thumb
+}
+
+# hand written bytecode for jumpr, the verifier has to reject it so every run is checked and faults
+reject_test(){
+	echo "  rejects $1"
+	cd bin
+	printf "$2" > compilation/out.gen
+	./jumpr out > /dev/null
+	./shabby-run --jobs 1 --runs 4 compilation/out.bin 2> /dev/null | grep -q "4 faults, 4 checked"
+	cd ..
+}
+
+# fnv-1a of everything after the header, for images edited by hand
+image_checksum(){
+	local hash=2166136261
+	for byte in `tail -c +17 $1 | od -An -v -tu1`; do hash=$(( ((hash ^ byte) * 16777619) & 0xFFFFFFFF )); done
+	printf '\\x%02x\\x%02x\\x%02x\\x%02x' $((hash >> 24)) $((hash >> 16 & 255)) $((hash >> 8 & 255)) $((hash & 255))
+}
+
 run_test(){
 	local src_file=`realpath $1`
 	echo "  $src_file"
@@ -18,6 +58,39 @@ run_test(){
 	./codegen $src_file > /dev/null
 	./jumpr $src_file > /dev/null
 	./vm $src_file > /dev/null
+	./vm_switch $src_file > /dev/null
+	./vm_rom $src_file > /dev/null
+	./emitc $src_file > /dev/null
+	./emitthumb $src_file > /dev/null
+	./shabbyc --run $src_file > /dev/null
+	./shabbyc_wide --run $src_file > /dev/null
+	./shabbyc_release --run $src_file > /dev/null
+	./shabbyc --jit --run $src_file > /dev/null
+	./shabbyc_release --jit --run $src_file > /dev/null
+	./shabbyc --backend=slots --run $src_file > /dev/null
+	./shabbyc_wide --backend=slots --run $src_file > /dev/null
+	./shabbyc --out=compilation --emit=c $src_file > /dev/null
+	gcc -O2 -Wall -Wextra -Werror -DSHABBY_MAIN compilation/`basename $src_file .src`.c -o compilation/`basename $src_file .src`_c
+	./compilation/`basename $src_file .src`_c
+	./shabbyc_wide --out=compilation --emit=c $src_file > /dev/null
+	gcc -O2 -Wall -Wextra -Werror -DSHABBY_MAIN compilation/`basename $src_file .src`.c -o compilation/`basename $src_file .src`_c
+	./compilation/`basename $src_file .src`_c
+	./shabbyc --compact --run $src_file > /dev/null
+	./shabbyc --compact --jit --run $src_file > /dev/null
+	./shabbyc_wide --compact --backend=slots --run $src_file > /dev/null
+	./shabbyc_wide --compact --out=compilation --emit=c $src_file > /dev/null
+	gcc -O2 -Wall -Wextra -Werror -DSHABBY_MAIN compilation/`basename $src_file .src`.c -o compilation/`basename $src_file .src`_c
+	./compilation/`basename $src_file .src`_c
+	./shabbyc --compact --out=compilation --emit=bin $src_file > /dev/null
+	./shabby-run --jobs 4 --runs 256 --fuel 1 --checked compilation/`basename $src_file .src`.bin > /dev/null
+	./shabby-run --jobs 4 --runs 256 --fuel 1 --diff compilation/`basename $src_file .src`.bin > /dev/null
+	./shabbyc --out=compilation --emit=s $src_file > /dev/null
+	thumb_test compilation/`basename $src_file .src`
+	./shabbyc --out=compilation --emit=bin $src_file > /dev/null
+	./shabby-run --jobs 4 --runs 256 --fuel 1 compilation/`basename $src_file .src`.bin > /dev/null
+	./shabby-run --jobs 4 --runs 256 --fuel 1 --checked compilation/`basename $src_file .src`.bin > /dev/null
+	./shabby-run --jobs 4 --runs 256 --diff compilation/`basename $src_file .src`.bin > /dev/null
+	./shabby-run --jobs 4 --runs 256 --fuel 1 --diff compilation/`basename $src_file .src`.bin > /dev/null
 	cd ..
 }
 
@@ -25,5 +98,106 @@ for file in tests/pass/*
 do
   run_test $file
 done
+
+# programs that have to be reported and exit with 1, not crash the compiler
+for file in tests/fail/*
+do
+	echo "  `realpath $file`"
+	(cd bin && ./shabbyc --run ../$file > /dev/null 2>&1 && exit 1; test $? -eq 1)
+	(cd bin && ./shabbyc_release --run ../$file > /dev/null 2>&1 && exit 1; test $? -eq 1)
+done
+
+# emitted stages land in the working directory unless --out says where, one that can't be written to is reported
+echo "  emitted stages land in --out"
+(cd bin/compilation && rm -f folding.bin && ../shabbyc --emit=bin ../../tests/pass/folding.src > /dev/null && test -f folding.bin)
+(cd bin && { ./shabbyc --out=missing --emit=bin ../tests/pass/folding.src 2>&1 > /dev/null | grep -q "Could not write 'missing/folding.bin'!"; test ${PIPESTATUS[0]} -eq 1; })
+
+# dividing by zero at run time is a reported fault in every engine, emitted C returns 2 and the thumb code traps on udf,
+# which qemu-arm reports as SIGILL
+echo "  runtime division by zero faults"
+(cd bin && printf 'byte a = 0;\nbyte b = 4 / a;\n' > compilation/divide.src)
+for engine in "" "--jit" "--backend=slots" "--backend=slots --jit" "--compact --backend=slots --jit"
+do
+	(cd bin && ./shabbyc $engine --run compilation/divide.src 2>&1 > /dev/null | grep -q "Division by zero!"; test ${PIPESTATUS[0]} -eq 1)
+done
+(cd bin && ./shabbyc --out=compilation --emit=bin compilation/divide.src > /dev/null && \
+	{ ./shabby-run --jobs 4 --runs 16 compilation/divide.bin 2> /dev/null | grep -q "16 faults, 0 checked"; test ${PIPESTATUS[0]} -eq 1; })
+for backend in stack slots
+do
+	(cd bin && ./shabbyc --backend=$backend --out=compilation --emit=c compilation/divide.src > /dev/null && \
+		gcc -O2 -Wall -Wextra -Werror -DSHABBY_MAIN compilation/divide.c -o compilation/divide_c && \
+		{ ./compilation/divide_c 2> /dev/null && exit 1; test $? -eq 2; })
+done
+if hash llvm-mc 2>/dev/null; then
+	(cd bin && ./shabbyc --out=compilation --emit=s compilation/divide.src > /dev/null && \
+		llvm-mc -triple=thumbv6m-none-eabi -filetype=obj compilation/divide.s -o compilation/divide_thumb.o && \
+		{ ./thumb-run compilation/divide_thumb.o 2> /dev/null && exit 1; test $? -eq 3; })
+fi
+if [ $thumb_checked -eq 1 ]; then
+	(cd bin && llvm-mc -triple=thumbv6m-none-eabi -filetype=obj --defsym SHABBY_MAIN=1 compilation/divide.s -o compilation/divide_main.o && \
+		ld.lld compilation/divide_main.o -o compilation/divide_thumb && \
+		{ qemu-arm compilation/divide_thumb 2> /dev/null && exit 1; test $? -eq 132; })
+fi
+
+# opcodes are numbered as in bytecode.h, push8 0c, push16 0d, pop8 0e, pop16 0f, set8 10, get8 12
+reject_test "a get past the frame" '\x0d\x00\xc8\x12'
+reject_test "a set past the frame" '\x0d\x00\xc8\x0c\x05\x10'
+reject_test "a stack underflow" '\x0c\x01\x0e\x0f'
+reject_test "an address overwritten after it was pushed" '\x0c\x00\x0d\x00\x00\x0d\x00\x01\x0d\xff\xf0\x11\x0c\x41\x10'
+(cd bin && printf '\x0c\x01\x0e' > compilation/out.gen && ./jumpr out > /dev/null && \
+	./shabby-run --jobs 1 --runs 4 compilation/out.bin | grep -q "0 faults, 0 checked")
+
+# an image cut short inside its last section fails to load even with a checksum that matches
+echo "  rejects a truncated section"
+(cd bin/compilation && head -c -12 out.bin > truncated.bin && \
+	printf "`image_checksum truncated.bin`" | dd of=truncated.bin bs=1 seek=12 conv=notrunc 2> /dev/null && \
+	../shabby-run truncated.bin 2>&1 | grep -q "section out of bounds")
+
+# every test at once, one compile per thread
+echo "  tests/pass/* on 4 jobs"
+(cd bin && ./shabbyc -j 4 --run --out=compilation --emit=all ../tests/pass/* > /dev/null)
+
+# the second pass runs every test straight from the cache
+echo "  tests/pass/* from the cache"
+(cd bin && ./shabbyc -j 4 --run --cache=cache ../tests/pass/* > /dev/null)
+(cd bin && ./shabbyc -j 4 --run --cache=cache ../tests/pass/* > /dev/null)
+
+# a compile from the cache has to be byte for byte the one it stored
+echo "  cached images match cold ones"
+(cd bin && rm -rf cache_cold && \
+	./shabbyc --compact --out=compilation --emit=bin ../tests/pass/folding.src > /dev/null && mv compilation/folding.bin compilation/folding_cold.bin && \
+	./shabbyc --compact --out=compilation --emit=bin --cache=cache_cold ../tests/pass/folding.src > /dev/null && cmp compilation/folding_cold.bin compilation/folding.bin && \
+	./shabbyc --compact --out=compilation --emit=bin --cache=cache_cold ../tests/pass/folding.src > /dev/null && cmp compilation/folding_cold.bin compilation/folding.bin)
+
+# an entry under the key of another source is a miss, never that source's image
+(cd bin && rm -rf cache_forged && \
+	./shabbyc --out=compilation --emit=bin ../tests/pass/byte_declaration.src > /dev/null && mv compilation/byte_declaration.bin compilation/byte_declaration_cold.bin && \
+	./shabbyc --cache=cache_forged ../tests/pass/short_assignment.src > /dev/null && mv cache_forged/*.cache compilation/forged.cache && \
+	./shabbyc --cache=cache_forged ../tests/pass/byte_declaration.src > /dev/null && mv compilation/forged.cache cache_forged/*.cache && \
+	./shabbyc --out=compilation --emit=bin --cache=cache_forged ../tests/pass/byte_declaration.src > /dev/null && cmp compilation/byte_declaration_cold.bin compilation/byte_declaration.bin)
+
+# a rebuilt compiler never picks up the entries of the one before it
+(cd bin && rm -rf cache_rebuilt && cp shabbyc shabbyc_rebuilt && printf '\0' >> shabbyc_rebuilt && \
+	./shabbyc --cache=cache_rebuilt ../tests/pass/folding.src > /dev/null && \
+	./shabbyc -v --cache=cache_rebuilt ../tests/pass/folding.src | grep -q ": cached$" && \
+	! ./shabbyc_rebuilt -v --cache=cache_rebuilt ../tests/pass/folding.src | grep -q ": cached$" && \
+	rm shabbyc_rebuilt)
+
+# compact_edge.src only tests relaxation while inner ends at 127 with every jump short, outer's jump
+# grows first and pushes it to 128, so inner's own jump only grows a pass later and leaves it at 129
+echo "  compact jumps at the short range edge"
+(cd bin && ./shabbyc --compact --out=compilation --emit=bin -vv ../tests/pass/compact_edge.src 2>&1 | grep -q "placed label: .* -> 0081$")
+
+# a generated program past 64 KiB, only the wide build can address it
+echo "  generated large program"
+(cd bin && { echo "short a = 1;"; echo "short b = 0;"; yes "b = b + a;" | head -n 16000; echo '$TEST 1 0 128 62;'; } > compilation/large.src)
+(cd bin && ! ./shabbyc --run compilation/large.src 2> /dev/null)
+(cd bin && ./shabbyc_wide --run compilation/large.src > /dev/null)
+(cd bin && ./shabbyc_wide --compact --run compilation/large.src > /dev/null)
+(cd bin && ./shabbyc_wide --backend=slots --jit --run compilation/large.src > /dev/null)
 echo ""
-echo "Passed!"
\ No newline at end of file
+if [ $thumb_checked -eq 0 ]; then
+	echo "Passed, but the thumb code was NOT checked!"
+else
+	echo "Passed!"
+fi
\ No newline at end of file